@@ -15,6 +15,9 @@ option(BUILD_NETWORK_MODULE "Build network module" ON)
 # functionality options
 option(ENABLE_ASAN "Enable Asan" ON)
 option(ENABLE_REDIS "Enable Redis support" ON)
+option(ENABLE_QUEUE_STATS "Compile lockfree_queue instrumentation in by default" OFF)
+set(RING_ACTIVE_LOG_LEVEL "TRACE" CACHE STRING "Lowest log level compiled into RING_* logging macros")
+set_property(CACHE RING_ACTIVE_LOG_LEVEL PROPERTY STRINGS TRACE DEBUG INFO WARN ERROR CRITICAL OFF)
 
 # third-party library options
 option(USE_ASIO_STANDALONE "Use standalone ASIO" ON)
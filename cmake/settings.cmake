@@ -46,3 +46,13 @@ set(CMAKE_RELWITHDEBINFO_POSTFIX "_rd")
 # Set project-specific macro definitions
 add_definitions(-DRING_PROJECT_NAME="${PROJECT_NAME}")
 add_definitions(-DRING_PROJECT_VERSION="${PROJECT_VERSION}")
+
+if(ENABLE_QUEUE_STATS)
+    add_definitions(-DRING_QUEUE_STATS)
+endif()
+
+# strip logging statements below the configured level at compile time; a target
+# with the RING_OWN_LOG_LEVEL property defines RING_ACTIVE_LOG_LEVEL itself
+add_compile_definitions(
+    $<$<NOT:$<BOOL:$<TARGET_PROPERTY:RING_OWN_LOG_LEVEL>>>:RING_ACTIVE_LOG_LEVEL=RING_LOG_LEVEL_${RING_ACTIVE_LOG_LEVEL}>
+)
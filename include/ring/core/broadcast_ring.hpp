@@ -0,0 +1,319 @@
+#ifndef RING_CORE_BROADCAST_RING_HPP_
+#define RING_CORE_BROADCAST_RING_HPP_
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <initializer_list>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <span>
+#include <type_traits>
+#include <vector>
+
+#include "ring/core/cache_line.hpp"
+#include "ring/core/exception.hpp"
+#include "ring/core/export.hpp"
+#include "ring/core/lockfree_queue.hpp"
+#include "ring/core/wait_strategy.hpp"
+
+namespace ring::core
+{
+
+namespace detail
+{
+
+// Disruptor-style ring: every consumer sees every event through its own
+// cursor. Producers are gated by the consumers at the end of each dependency
+// chain, a consumer with dependencies never passes the slowest of them.
+// The consumer topology is not synchronised: build it before publishing.
+template <typename T, bool MultiProducer, typename WaitStrategy>
+class basic_broadcast_ring final
+{
+    static_assert(std::is_default_constructible_v<T> && std::is_copy_assignable_v<T>,
+        "broadcast ring slots are preallocated and overwritten in place");
+public:
+    class consumer final
+    {
+    public:
+        explicit consumer(basic_broadcast_ring& ring, size_t start) :
+            ring_(ring),
+            cursor_(start) {}
+    private:
+        consumer(const consumer&) = delete;
+        consumer& operator=(const consumer&) = delete;
+    public:
+        size_t sequence() const
+        {
+            return cursor_->load(std::memory_order_relaxed);
+        }
+
+        size_t available() const
+        {
+            size_t pos = cursor_->load(std::memory_order_relaxed);
+            return limit(pos) - pos;
+        }
+
+        // everything published so far that this consumer may read
+        slot_range<const T> peek(size_t max_count = std::numeric_limits<size_t>::max()) const
+        {
+            size_t pos = cursor_->load(std::memory_order_relaxed);
+            size_t count = std::min(limit(pos) - pos, max_count);
+            size_t slot = pos & ring_.mask_;
+            size_t first = std::min(count, ring_.capacity_ - slot);
+            return { pos, std::span<const T>(&ring_.slots_[slot], first),
+                std::span<const T>(&ring_.slots_[0], count - first) };
+        }
+
+        void consume(size_t count)
+        {
+            if (count == 0)
+            {
+                return;
+            }
+            cursor_->store(cursor_->load(std::memory_order_relaxed) + count, std::memory_order_release);
+            ring_.wait_.notify(wait_channel::not_full);
+            if (has_dependents_)
+            {
+                ring_.wait_.notify(wait_channel::not_empty);
+            }
+        }
+
+        bool try_read(T& result)
+        {
+            auto range = peek(1);
+            if (range.empty())
+            {
+                return false;
+            }
+            result = range[0];
+            consume(1);
+            return true;
+        }
+
+        // calls handler(event, sequence) for each readable event
+        template <typename Handler>
+        size_t try_process(Handler&& handler, size_t max_count = std::numeric_limits<size_t>::max())
+        {
+            auto range = peek(max_count);
+            for (size_t i = 0; i < range.size(); ++i)
+            {
+                handler(range[i], range.position() + i);
+            }
+            consume(range.size());
+            return range.size();
+        }
+
+        template <typename Handler>
+        size_t process(Handler&& handler, size_t max_count = std::numeric_limits<size_t>::max())
+        {
+            size_t processed = 0;
+            ring_.wait_.wait(wait_channel::not_empty, [&]()
+                {
+                    return (processed = try_process(handler, max_count)) != 0;
+                });
+            return processed;
+        }
+    private:
+        size_t limit(size_t pos) const
+        {
+            if (dependencies_.empty())
+            {
+                return ring_.published_limit(pos);
+            }
+            size_t result = std::numeric_limits<size_t>::max();
+            for (const consumer* dependency : dependencies_)
+            {
+                result = std::min(result, dependency->cursor_->load(std::memory_order_acquire));
+            }
+            return result;
+        }
+    private:
+        friend class basic_broadcast_ring;
+        basic_broadcast_ring& ring_;
+        cache_aligned<std::atomic<size_t>> cursor_;
+        std::vector<const consumer*> dependencies_;
+        bool has_dependents_ = false;
+    };
+public:
+    explicit basic_broadcast_ring(size_t capacity) :
+        capacity_(std::bit_ceil(std::max<size_t>(capacity, 2))),
+        mask_(capacity_ - 1),
+        slots_(std::make_unique<T[]>(capacity_))
+    {
+        if constexpr (MultiProducer)
+        {
+            published_ = std::make_unique<std::atomic<size_t>[]>(capacity_);
+            for (size_t i = 0; i < capacity_; ++i)
+            {
+                published_[i].store(0, std::memory_order_relaxed);
+            }
+        }
+    }
+    ~basic_broadcast_ring() = default;
+private:
+    basic_broadcast_ring(const basic_broadcast_ring&) = delete;
+    basic_broadcast_ring& operator=(const basic_broadcast_ring&) = delete;
+public:
+    // the new consumer only reads after every consumer in depends_on
+    consumer& add_consumer(std::initializer_list<consumer*> depends_on = {})
+    {
+        size_t start = claim_->load(std::memory_order_acquire);
+        for (consumer* dependency : depends_on)
+        {
+            if (&dependency->ring_ != this)
+            {
+                throw ring::core::exception("consumer dependency belongs to another ring");
+            }
+            start = std::min(start, dependency->sequence());
+        }
+        auto& added = *consumers_.emplace_back(std::make_unique<consumer>(*this, start));
+        for (consumer* dependency : depends_on)
+        {
+            added.dependencies_.push_back(dependency);
+            dependency->has_dependents_ = true;
+        }
+        gating_.clear();
+        for (const auto& c : consumers_)
+        {
+            if (!c->has_dependents_)
+            {
+                gating_.push_back(c.get());
+            }
+        }
+        return added;
+    }
+
+    bool try_publish(const T& value)
+    {
+        return try_publish_batch(&value, &value + 1) == 1;
+    }
+
+    template <typename InputIt>
+    size_t try_publish_batch(InputIt first, InputIt last)
+    {
+        size_t requested = std::distance(first, last);
+        if (requested == 0)
+        {
+            return 0;
+        }
+        size_t pos = claim_->load(std::memory_order_relaxed);
+        size_t count = 0;
+        for (;;)
+        {
+            count = std::min(requested, free_slots(pos));
+            if (count == 0)
+            {
+                return 0;
+            }
+            if constexpr (!MultiProducer)
+            {
+                claim_->store(pos + count, std::memory_order_relaxed);
+                break;
+            }
+            else if (claim_->compare_exchange_weak(pos, pos + count,
+                std::memory_order_acq_rel, std::memory_order_relaxed))
+            {
+                break;
+            }
+        }
+        for (size_t i = 0; i < count; ++i, ++first)
+        {
+            slots_[(pos + i) & mask_] = *first;
+            if constexpr (MultiProducer)
+            {
+                published_[(pos + i) & mask_].store(pos + i + 1, std::memory_order_release);
+            }
+        }
+        if constexpr (!MultiProducer)
+        {
+            cursor_->store(pos + count, std::memory_order_release);
+        }
+        wait_.notify(wait_channel::not_empty);
+        return count;
+    }
+
+    void publish(const T& value)
+    {
+        wait_.wait(wait_channel::not_full, [&]() { return try_publish(value); });
+    }
+
+    template <typename InputIt>
+    void publish_batch(InputIt first, InputIt last)
+    {
+        auto it = first;
+        while (it != last)
+        {
+            size_t published = 0;
+            wait_.wait(wait_channel::not_full, [&]() { return (published = try_publish_batch(it, last)) != 0; });
+            std::advance(it, published);
+        }
+    }
+
+    size_t capacity() const
+    {
+        return capacity_;
+    }
+
+    size_t consumer_count() const
+    {
+        return consumers_.size();
+    }
+private:
+    size_t free_slots(size_t pos)
+    {
+        size_t gate = gate_cache_->load(std::memory_order_relaxed);
+        if (pos - gate < capacity_)
+        {
+            return capacity_ - (pos - gate);
+        }
+        gate = pos;
+        for (const consumer* c : gating_)
+        {
+            gate = std::min(gate, c->cursor_->load(std::memory_order_acquire));
+        }
+        gate_cache_->store(gate, std::memory_order_relaxed);
+        return capacity_ - (pos - gate);
+    }
+
+    size_t published_limit(size_t pos) const
+    {
+        if constexpr (MultiProducer)
+        {
+            size_t end = pos;
+            while (end - pos < capacity_ && published_[end & mask_].load(std::memory_order_acquire) == end + 1)
+            {
+                ++end;
+            }
+            return end;
+        }
+        else
+        {
+            return cursor_->load(std::memory_order_acquire);
+        }
+    }
+private:
+    const size_t capacity_;
+    const size_t mask_;
+    std::unique_ptr<T[]> slots_;
+    std::unique_ptr<std::atomic<size_t>[]> published_;
+    cache_aligned<std::atomic<size_t>> claim_{ 0 };
+    cache_aligned<std::atomic<size_t>> cursor_{ 0 };
+    cache_aligned<std::atomic<size_t>> gate_cache_{ 0 };
+    std::vector<std::unique_ptr<consumer>> consumers_;
+    std::vector<const consumer*> gating_;
+    [[no_unique_address]] WaitStrategy wait_;
+};
+
+} // namespace detail
+
+template <typename T, typename WaitStrategy = spin_yield_wait>
+using spmc_broadcast_ring = detail::basic_broadcast_ring<T, false, WaitStrategy>;
+
+template <typename T, typename WaitStrategy = spin_yield_wait>
+using mpmc_broadcast_ring = detail::basic_broadcast_ring<T, true, WaitStrategy>;
+
+} // namespace ring::core
+
+#endif // RING_CORE_BROADCAST_RING_HPP_
@@ -1,10 +1,16 @@
 #ifndef RING_CORE_CACHE_LINE_HPP_
 #define RING_CORE_CACHE_LINE_HPP_
 
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
 #include <cstdint>
+#include <memory>
 #include <new>
+#include <utility>
 
 #include "ring/core/export.hpp"
+#include "ring/core/memory_policy.hpp"
 
 namespace ring::core
 {
@@ -17,9 +23,18 @@ constexpr std::align_val_t cache_line_alignment{ cache_line_size };
 
 struct aligned_deleter
 {
+    // non-zero when the buffer is a page mapping made under a memory_policy
+    size_t mapped = 0;
+    std::align_val_t alignment = cache_line_alignment;
+
     void operator()(void* ptr) const
     {
-        ::operator delete(ptr, cache_line_alignment);
+        if (mapped)
+        {
+            release_pages(ptr, mapped);
+            return;
+        }
+        ::operator delete(ptr, alignment);
     }
 };
 
@@ -33,6 +48,14 @@ private:
 template<>
 class padding<0> {};
 
+// dense per-thread id, used to pick one of a fixed set of cache-line shards
+inline size_t thread_index() noexcept
+{
+    static std::atomic<size_t> next{ 0 };
+    static thread_local size_t index = next.fetch_add(1, std::memory_order_relaxed);
+    return index;
+}
+
 } // namespace detail
 
 template<typename T, size_t Alignment = detail::cache_line_size>
@@ -55,13 +78,28 @@ private:
     [[no_unique_address]] detail::padding<Alignment - sizeof(T)> pad_;
 };
 
-std::unique_ptr<char[], detail::aligned_deleter> make_unique_buffer_aligned(size_t size)
+using buffer_aligned = std::unique_ptr<char[], detail::aligned_deleter>;
+
+// aligned to at least a cache line, or to alignment when that is larger
+inline buffer_aligned make_unique_buffer_aligned(size_t size, const memory_policy& policy,
+    size_t alignment = detail::cache_line_size)
 {
-    void* mem = ::operator new(size, detail::cache_line_alignment);
-    return std::unique_ptr<char[], detail::aligned_deleter>(static_cast<char*>(mem));
+    alignment = std::max(alignment, detail::cache_line_size);
+    if (policy.applies(size))
+    {
+        auto pages = detail::allocate_pages(size, policy, alignment);
+        return buffer_aligned(static_cast<char*>(pages.data),
+            detail::aligned_deleter{ pages.mapped, std::align_val_t{ alignment } });
+    }
+    void* mem = ::operator new(size, std::align_val_t{ alignment });
+    return buffer_aligned(static_cast<char*>(mem), detail::aligned_deleter{ 0, std::align_val_t{ alignment } });
 }
 
-using buffer_aligned = std::unique_ptr<char[], detail::aligned_deleter>;
+// follows default_memory_policy(), which is plain operator new unless configured
+inline buffer_aligned make_unique_buffer_aligned(size_t size, size_t alignment = detail::cache_line_size)
+{
+    return make_unique_buffer_aligned(size, default_memory_policy(), alignment);
+}
 
 } // namespace ring::core
 
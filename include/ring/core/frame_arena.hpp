@@ -0,0 +1,217 @@
+#ifndef RING_CORE_FRAME_ARENA_HPP_
+#define RING_CORE_FRAME_ARENA_HPP_
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <memory_resource>
+#include <new>
+#include <span>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "ring/core/cache_line.hpp"
+#include "ring/core/export.hpp"
+
+namespace ring::core
+{
+
+// Bump-pointer arena for work that dies at the end of a tick. Chunks come
+// from make_unique_buffer_aligned and are kept across reset(), so a warmed-up
+// arena stops touching the heap. Nothing is destroyed: only trivially
+// destructible objects may be created in it.
+class RING_API frame_arena final
+{
+public:
+    static constexpr size_t default_chunk_size = 64 * 1024;
+
+    // a position to roll back to; later allocations are discarded by rewind()
+    struct marker
+    {
+        size_t chunk = 0;
+        size_t offset = 0;
+        size_t used = 0;
+    };
+
+    // rewinds to the position it was created at when leaving a nested scope
+    class scope
+    {
+    public:
+        explicit scope(frame_arena& arena) :
+            arena_(arena),
+            marker_(arena.mark()) {}
+        ~scope()
+        {
+            arena_.rewind(marker_);
+        }
+    private:
+        scope(const scope&) = delete;
+        scope& operator=(const scope&) = delete;
+    private:
+        frame_arena& arena_;
+        const marker marker_;
+    };
+private:
+    struct chunk
+    {
+        buffer_aligned data;
+        size_t size;
+    };
+public:
+    explicit frame_arena(size_t chunk_size = default_chunk_size) :
+        chunk_size_(std::max<size_t>(chunk_size, detail::cache_line_size)) {}
+    ~frame_arena() = default;
+private:
+    frame_arena(const frame_arena&) = delete;
+    frame_arena& operator=(const frame_arena&) = delete;
+public:
+    void* allocate(size_t size, size_t alignment = alignof(std::max_align_t))
+    {
+        if (current_ < chunks_.size())
+        {
+            if (void* ptr = bump(chunks_[current_], size, alignment))
+            {
+                return ptr;
+            }
+            used_ += chunks_[current_].size - offset_;
+            ++current_;
+        }
+        // chunks past current_ are unused: rotate the first one that fits into place
+        auto next = chunks_.begin() + current_;
+        auto fit = std::find_if(next, chunks_.end(), [&](const chunk& entry) { return entry.size >= size + alignment; });
+        if (fit == chunks_.end())
+        {
+            size_t bytes = std::max(chunk_size_, size + alignment);
+            chunks_.push_back(chunk{ make_unique_buffer_aligned(bytes), bytes });
+            next = chunks_.begin() + current_;
+            fit = std::prev(chunks_.end());
+        }
+        std::rotate(next, fit, std::next(fit));
+        offset_ = 0;
+        return bump(chunks_[current_], size, alignment);
+    }
+
+    template <typename T, typename... Args>
+    T* create(Args&&... args)
+    {
+        static_assert(std::is_trivially_destructible_v<T>, "frame arena never runs destructors");
+        return new (allocate(sizeof(T), alignof(T))) T(std::forward<Args>(args)...);
+    }
+
+    template <typename T>
+    std::span<T> allocate_array(size_t count)
+    {
+        static_assert(std::is_trivially_destructible_v<T>, "frame arena never runs destructors");
+        T* first = static_cast<T*>(allocate(sizeof(T) * count, alignof(T)));
+        std::uninitialized_value_construct_n(first, count);
+        return { first, count };
+    }
+
+    marker mark() const
+    {
+        return { current_, offset_, used_ };
+    }
+
+    void rewind(const marker& position)
+    {
+        current_ = position.chunk;
+        offset_ = position.offset;
+        used_ = position.used;
+    }
+
+    // end of tick: O(1), keeps every chunk and closes the tick's peak
+    void reset()
+    {
+        last_peak_ = peak_;
+        peak_ = 0;
+        rewind({});
+    }
+
+    // bytes consumed since reset, alignment padding and abandoned chunk tails included
+    size_t used() const
+    {
+        return used_;
+    }
+
+    size_t peak() const
+    {
+        return peak_;
+    }
+
+    size_t last_tick_peak() const
+    {
+        return last_peak_;
+    }
+
+    size_t high_water() const
+    {
+        return high_water_;
+    }
+
+    size_t capacity() const
+    {
+        size_t total = 0;
+        for (const auto& entry : chunks_)
+        {
+            total += entry.size;
+        }
+        return total;
+    }
+
+    // arena of the calling thread, for job workers and other per-thread tick work
+    static frame_arena& local()
+    {
+        static thread_local frame_arena arena;
+        return arena;
+    }
+private:
+    void* bump(chunk& target, size_t size, size_t alignment)
+    {
+        auto base = reinterpret_cast<uintptr_t>(target.data.get());
+        size_t aligned = ((base + offset_ + alignment - 1) & ~(static_cast<uintptr_t>(alignment) - 1)) - base;
+        if (aligned + size > target.size)
+        {
+            return nullptr;
+        }
+        used_ += aligned + size - offset_;
+        offset_ = aligned + size;
+        peak_ = std::max(peak_, used_);
+        high_water_ = std::max(high_water_, peak_);
+        return target.data.get() + aligned;
+    }
+private:
+    const size_t chunk_size_;
+    std::vector<chunk> chunks_;
+    size_t current_ = 0;
+    size_t offset_ = 0;
+    size_t used_ = 0;
+    size_t peak_ = 0;
+    size_t last_peak_ = 0;
+    size_t high_water_ = 0;
+};
+
+// pmr view of a frame_arena; deallocate is a no-op and memory returns on reset()
+class RING_API frame_memory_resource final : public std::pmr::memory_resource
+{
+public:
+    explicit frame_memory_resource(frame_arena& arena = frame_arena::local()) :
+        arena_(arena) {}
+private:
+    void* do_allocate(size_t bytes, size_t alignment) override
+    {
+        return arena_.allocate(bytes, alignment);
+    }
+    void do_deallocate(void*, size_t, size_t) override {}
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override
+    {
+        return this == &other;
+    }
+private:
+    frame_arena& arena_;
+};
+
+} // namespace ring::core
+
+#endif // RING_CORE_FRAME_ARENA_HPP_
@@ -0,0 +1,178 @@
+#ifndef RING_CORE_JOB_SCHEDULER_HPP_
+#define RING_CORE_JOB_SCHEDULER_HPP_
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#include "ring/core/cache_line.hpp"
+#include "ring/core/export.hpp"
+
+namespace ring::core
+{
+
+class job_counter final
+{
+public:
+    job_counter() = default;
+    ~job_counter() = default;
+private:
+    job_counter(const job_counter&) = delete;
+    job_counter& operator=(const job_counter&) = delete;
+public:
+    bool done() const noexcept
+    {
+        return pending_.load(std::memory_order_acquire) == 0;
+    }
+    size_t pending() const noexcept
+    {
+        return pending_.load(std::memory_order_relaxed);
+    }
+private:
+    friend class job_scheduler;
+    std::atomic<size_t> pending_{ 0 };
+};
+
+namespace detail
+{
+
+struct alignas(cache_line_size) job
+{
+    static constexpr size_t storage_size = 2 * cache_line_size - sizeof(void*) * 2;
+
+    void (*invoke)(job&) = nullptr;
+    job_counter* counter = nullptr;
+    alignas(std::max_align_t) std::byte storage[storage_size];
+};
+
+} // namespace detail
+
+struct job_scheduler_config
+{
+    size_t workers = 0;
+    size_t deque_capacity = 1024;
+    size_t injection_capacity = 65536;
+};
+
+class RING_API job_scheduler final
+{
+private:
+    job_scheduler();
+    ~job_scheduler();
+private:
+    job_scheduler(const job_scheduler&) = delete;
+    job_scheduler& operator=(const job_scheduler&) = delete;
+public:
+    static job_scheduler& instance()
+    {
+        static job_scheduler instance;
+        return instance;
+    }
+public:
+    void initialize(const job_scheduler_config& config = {});
+    void shutdown();
+    void register_initializer(const job_scheduler_config& config = {}, int priority = 0);
+    size_t worker_count() const;
+    size_t concurrency() const;
+public:
+    template <typename F>
+    void spawn(job_counter& counter, F&& func)
+    {
+        detail::job* job = make_job(&counter, std::forward<F>(func));
+        counter.pending_.fetch_add(1, std::memory_order_relaxed);
+        submit(job);
+    }
+
+    template <typename F>
+    void spawn(F&& func)
+    {
+        submit(make_job(nullptr, std::forward<F>(func)));
+    }
+
+    // runs other jobs on the calling thread until the counter drains
+    void wait(job_counter& counter);
+
+    // func is called either as func(first, last) on sub-ranges or as func(i) per index
+    template <typename F>
+    void parallel_for(size_t begin, size_t end, F&& func, size_t grain = 0)
+    {
+        if (begin >= end)
+        {
+            return;
+        }
+        if (grain == 0)
+        {
+            grain = std::max<size_t>(1, (end - begin) / (concurrency() * 8));
+        }
+        job_counter counter;
+        split_range(counter, begin, end, grain, func);
+        wait(counter);
+    }
+private:
+    template <typename F>
+    void split_range(job_counter& counter, size_t begin, size_t end, size_t grain, F& func)
+    {
+        while (end - begin > grain)
+        {
+            size_t mid = begin + (end - begin) / 2;
+            spawn(counter, [this, &counter, mid, end, grain, &func]()
+                {
+                    split_range(counter, mid, end, grain, func);
+                });
+            end = mid;
+        }
+        if constexpr (std::is_invocable_v<F&, size_t, size_t>)
+        {
+            func(begin, end);
+        }
+        else
+        {
+            for (size_t i = begin; i < end; ++i)
+            {
+                func(i);
+            }
+        }
+    }
+
+    template <typename F>
+    detail::job* make_job(job_counter* counter, F&& func)
+    {
+        using func_type = std::decay_t<F>;
+        detail::job* job = allocate_job();
+        job->counter = counter;
+        if constexpr (sizeof(func_type) <= detail::job::storage_size && alignof(func_type) <= alignof(std::max_align_t))
+        {
+            new (job->storage) func_type(std::forward<F>(func));
+            job->invoke = [](detail::job& self)
+            {
+                auto* f = std::launder(reinterpret_cast<func_type*>(self.storage));
+                (*f)();
+                f->~func_type();
+            };
+        }
+        else
+        {
+            new (job->storage) func_type*(new func_type(std::forward<F>(func)));
+            job->invoke = [](detail::job& self)
+            {
+                std::unique_ptr<func_type> f(*std::launder(reinterpret_cast<func_type**>(self.storage)));
+                (*f)();
+            };
+        }
+        return job;
+    }
+
+    detail::job* allocate_job();
+    void submit(detail::job* job);
+private:
+    class impl;
+    std::unique_ptr<impl> impl_;
+};
+
+} // namespace ring::core
+
+#endif // RING_CORE_JOB_SCHEDULER_HPP_
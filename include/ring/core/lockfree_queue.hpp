@@ -2,16 +2,101 @@
 #define RING_LOCKFREE_QUEUE_HPP_
 
 #include <algorithm>
+#include <array>
 #include <atomic>
+#include <bit>
+#include <cassert>
+#include <chrono>
+#include <concepts>
+#include <cstddef>
+#include <cstring>
 #include <iterator>
+#include <limits>
+#include <memory>
+#include <span>
 #include <thread>
+#include <type_traits>
 
 #include "ring/core/cache_line.hpp"
 #include "ring/core/export.hpp"
+#include "ring/core/queue_stats.hpp"
+#include "ring/core/wait_strategy.hpp"
 
 namespace ring::core
 {
 
+// a run of ring slots, split in two segments when it crosses the wraparound
+template <typename T>
+class slot_range final
+{
+public:
+    slot_range() = default;
+    slot_range(size_t position, std::span<T> first, std::span<T> second) :
+        position_(position), first_(first), second_(second) {}
+public:
+    T& operator[](size_t i) const
+    {
+        return i < first_.size() ? first_[i] : second_[i - first_.size()];
+    }
+    size_t position() const
+    {
+        return position_;
+    }
+    size_t size() const
+    {
+        return first_.size() + second_.size();
+    }
+    bool empty() const
+    {
+        return size() == 0;
+    }
+    std::span<T> first_segment() const
+    {
+        return first_;
+    }
+    std::span<T> second_segment() const
+    {
+        return second_;
+    }
+    slot_range first(size_t count) const
+    {
+        count = std::min(count, size());
+        size_t head = std::min(count, first_.size());
+        return { position_, first_.first(head), second_.first(count - head) };
+    }
+private:
+    size_t position_ = 0;
+    std::span<T> first_;
+    std::span<T> second_;
+};
+
+// Slot/sequence layouts for the mpsc and mpmc queues. Only swizzled_layout
+// changes the capacity: it rounds the requested capacity up to a whole number
+// of cache lines of cells. capacity() on the queue reports the effective value.
+struct split_layout
+{
+};
+
+struct interleaved_layout
+{
+    static constexpr bool padded = false;
+    static constexpr bool swizzled = false;
+};
+
+// one cell per cache line; the capacity is kept, the memory per slot grows
+struct padded_layout
+{
+    static constexpr bool padded = true;
+    static constexpr bool swizzled = false;
+};
+
+// capacity rounds up to a multiple of the cells that fit one cache line
+struct swizzled_layout
+{
+    static constexpr bool padded = false;
+    static constexpr bool swizzled = true;
+};
+
 namespace detail
 {
 
@@ -30,10 +115,15 @@ public:
     {
         return *reinterpret_cast<T*>(&data[i * sizeof(T)]);
     }
+    size_t index(size_t pos) const
+    {
+        return pos % capacity;
+    }
 public:
     cache_aligned<std::atomic<size_t>> head{ 0 };
     cache_aligned<std::atomic<size_t>> tail{ 0 };
 public:
+    static constexpr bool contiguous = true;
     const size_t capacity;
     buffer_aligned data;
 };
@@ -57,70 +147,310 @@ public:
     {
         return *reinterpret_cast<T*>(&data[i * sizeof(T)]);
     }
+    std::atomic<size_t>& sequence(size_t i)
+    {
+        return sequences[i];
+    }
+    size_t index(size_t pos) const
+    {
+        return pos % capacity;
+    }
 public:
     cache_aligned<std::atomic<size_t>> head{ 0 };
     cache_aligned<std::atomic<size_t>> tail{ 0 };
 public:
+    static constexpr bool contiguous = true;
     const size_t capacity;
     buffer_aligned data;
     std::unique_ptr<std::atomic<size_t>[]> sequences;
 };
 
+template <typename T, size_t Capacity, bool WithSequences>
+class static_memory_block;
+
+template <typename T, size_t Capacity>
+class static_memory_block<T, Capacity, false>
+{
+    static_assert(Capacity > 0 && std::has_single_bit(Capacity), "Capacity must be a power of two");
+public:
+    T& operator[](size_t i)
+    {
+        return *reinterpret_cast<T*>(&data[i * sizeof(T)]);
+    }
+    static constexpr size_t index(size_t pos)
+    {
+        return pos & mask;
+    }
+public:
+    cache_aligned<std::atomic<size_t>> head{ 0 };
+    cache_aligned<std::atomic<size_t>> tail{ 0 };
+public:
+    static constexpr bool contiguous = true;
+    static constexpr size_t capacity = Capacity;
+    static constexpr size_t mask = Capacity - 1;
+    alignas(std::max(cache_line_size, alignof(T))) std::byte data[Capacity * sizeof(T)];
+};
+
+template <typename T, size_t Capacity>
+class static_memory_block<T, Capacity, true>
+{
+    static_assert(Capacity > 0 && std::has_single_bit(Capacity), "Capacity must be a power of two");
+public:
+    static_memory_block()
+    {
+        for (size_t i = 0; i < Capacity; ++i)
+        {
+            sequences[i].store(i, std::memory_order_relaxed);
+        }
+    }
+public:
+    T& operator[](size_t i)
+    {
+        return *reinterpret_cast<T*>(&data[i * sizeof(T)]);
+    }
+    std::atomic<size_t>& sequence(size_t i)
+    {
+        return sequences[i];
+    }
+    static constexpr size_t index(size_t pos)
+    {
+        return pos & mask;
+    }
+public:
+    cache_aligned<std::atomic<size_t>> head{ 0 };
+    cache_aligned<std::atomic<size_t>> tail{ 0 };
+public:
+    static constexpr bool contiguous = true;
+    static constexpr size_t capacity = Capacity;
+    static constexpr size_t mask = Capacity - 1;
+    alignas(std::max(cache_line_size, alignof(T))) std::byte data[Capacity * sizeof(T)];
+    alignas(cache_line_size) std::array<std::atomic<size_t>, Capacity> sequences;
+};
+
+// each slot's sequence shares a cell with its payload, so a claim touches one cache line
+template <typename T, typename Layout>
+class cell_memory_block
+{
+private:
+    struct alignas(Layout::padded ? cache_line_size : std::max(alignof(std::atomic<size_t>), alignof(T))) cell
+    {
+        std::atomic<size_t> sequence;
+        alignas(T) std::byte data[sizeof(T)];
+    };
+    static constexpr size_t cells_per_line = Layout::swizzled ? std::max<size_t>(1, cache_line_size / sizeof(cell)) : 1;
+public:
+    // swizzling transposes whole lines, so capacity is rounded up to fill the last one
+    explicit cell_memory_block(size_t capacity) :
+        capacity((capacity + cells_per_line - 1) / cells_per_line * cells_per_line),
+        lines_(this->capacity / cells_per_line),
+        data(make_unique_buffer_aligned(this->capacity * sizeof(cell)))
+    {
+        for (size_t i = 0; i < this->capacity; ++i)
+        {
+            new (&cells()[i]) cell{};
+        }
+        for (size_t i = 0; i < this->capacity; ++i)
+        {
+            sequence(index(i)).store(i, std::memory_order_relaxed);
+        }
+    }
+public:
+    T& operator[](size_t i)
+    {
+        return *reinterpret_cast<T*>(cells()[i].data);
+    }
+    std::atomic<size_t>& sequence(size_t i)
+    {
+        return cells()[i].sequence;
+    }
+    size_t index(size_t pos) const
+    {
+        size_t i = pos % capacity;
+        if constexpr (cells_per_line > 1)
+        {
+            // transpose so consecutive positions land on consecutive cache lines
+            return (i % lines_) * cells_per_line + i / lines_;
+        }
+        return i;
+    }
+private:
+    cell* cells()
+    {
+        return reinterpret_cast<cell*>(data.get());
+    }
+public:
+    cache_aligned<std::atomic<size_t>> head{ 0 };
+    cache_aligned<std::atomic<size_t>> tail{ 0 };
+public:
+    static constexpr bool contiguous = false;
+    const size_t capacity;
+private:
+    const size_t lines_;
+public:
+    buffer_aligned data;
+};
+
+template <typename T, typename Layout>
+struct sequenced_block
+{
+    using type = cell_memory_block<T, Layout>;
+};
+
 template <typename T>
-class spsc_queue final
+struct sequenced_block<T, split_layout>
+{
+    using type = memory_block<T, true>;
+};
+
+template <typename T, typename It>
+concept bulk_copyable = std::is_trivially_copyable_v<T> && std::contiguous_iterator<It> &&
+    std::same_as<std::iter_value_t<It>, T>;
+
+// copies count elements into the ring starting at pos, split at most once at the wraparound
+template <typename Block, typename T>
+void copy_to_block(Block& block, size_t pos, const T* src, size_t count)
+{
+    size_t slot = block.index(pos);
+    size_t first = std::min(count, block.capacity - slot);
+    std::memcpy(&block[slot], src, first * sizeof(T));
+    if (count > first)
+    {
+        std::memcpy(&block[0], src + first, (count - first) * sizeof(T));
+    }
+}
+
+template <typename T, typename Block>
+slot_range<T> make_slot_range(Block& block, size_t pos, size_t count)
+{
+    static_assert(Block::contiguous, "slot ranges need contiguous slot storage");
+    size_t slot = block.index(pos);
+    size_t first = std::min(count, block.capacity - slot);
+    return { pos, std::span<T>(&block[slot], first), std::span<T>(&block[0], count - first) };
+}
+
+template <typename Block, typename T>
+void copy_from_block(Block& block, size_t pos, T* dst, size_t count)
+{
+    size_t slot = block.index(pos);
+    size_t first = std::min(count, block.capacity - slot);
+    std::memcpy(dst, &block[slot], first * sizeof(T));
+    if (count > first)
+    {
+        std::memcpy(dst + first, &block[0], (count - first) * sizeof(T));
+    }
+}
+
+// Backends. The try_ calls and reserve() take the front end's stats, so a
+// compare-exchange on the shared tail or head is counted where it happens;
+// by default, and in the spsc backend which has none, the hooks are no-ops.
+template <typename T, typename Block>
+class basic_spsc_queue final
 {
 private:
-    using block_type = memory_block<T, false>;
+    using block_type = Block;
 public:
-    explicit spsc_queue(size_t capacity) :
-        block_(capacity) {}
+    template <typename... Args>
+        requires std::is_constructible_v<block_type, Args...>
+    explicit basic_spsc_queue(Args&&... args) :
+        block_(std::forward<Args>(args)...) {}
 
-    ~spsc_queue()
+    ~basic_spsc_queue()
     {
-        size_t head = block_.head->load(std::memory_order_relaxed);
-        size_t tail = block_.tail->load(std::memory_order_relaxed);
-        while (head < tail)
+        if constexpr (!std::is_trivially_destructible_v<T>)
         {
-            size_t slot = head % block_.capacity;
-            block_[slot].~T();
-            ++head;
+            size_t head = block_.head->load(std::memory_order_relaxed);
+            size_t tail = block_.tail->load(std::memory_order_relaxed);
+            while (head < tail)
+            {
+                block_[block_.index(head)].~T();
+                ++head;
+            }
         }
     }
 public:
-    bool try_push(T&& value)
+    template <typename Stats = no_queue_stats>
+    bool try_push(T&& value, Stats&& = {})
     {
-        T temp(std::move(value));
-        return try_push_batch(&temp, &temp + 1) == 1;
+        auto range = reserve(1);
+        if (range.empty())
+        {
+            return false;
+        }
+        new (&range[0]) T(std::move(value));
+        commit(range);
+        return true;
     }
 
-    bool try_pop(T& result)
+    template <typename Stats = no_queue_stats>
+    bool try_pop(T& result, Stats&& = {})
     {
         return try_pop_batch(&result, 1) == 1;
     }
 
-    template <typename InputIt>
-    size_t try_push_batch(InputIt first, InputIt last)
+    template <typename Stats = no_queue_stats>
+    slot_range<T> reserve(size_t count, Stats&& = {})
     {
         size_t tail = block_.tail->load(std::memory_order_relaxed);
         size_t head = block_.head->load(std::memory_order_acquire);
-        size_t capacity = block_.capacity;
-        size_t available = head + capacity - tail;
+        return make_slot_range<T>(block_, tail, std::min(count, head + block_.capacity - tail));
+    }
+
+    void commit(const slot_range<T>& range)
+    {
+        block_.tail->store(range.position() + range.size(), std::memory_order_release);
+    }
+
+    slot_range<T> peek(size_t max_count = std::numeric_limits<size_t>::max())
+    {
+        size_t head = block_.head->load(std::memory_order_relaxed);
+        size_t tail = block_.tail->load(std::memory_order_acquire);
+        return make_slot_range<T>(block_, head, std::min(tail - head, max_count));
+    }
+
+    // count must not exceed what the last peek() returned
+    void consume(size_t count)
+    {
+        size_t head = block_.head->load(std::memory_order_relaxed);
+        assert(count <= block_.tail->load(std::memory_order_acquire) - head && "consume past the peeked range");
+        if constexpr (!std::is_trivially_destructible_v<T>)
+        {
+            for (size_t i = 0; i < count; ++i)
+            {
+                block_[block_.index(head + i)].~T();
+            }
+        }
+        block_.head->store(head + count, std::memory_order_release);
+    }
+
+    template <typename InputIt, typename Stats = no_queue_stats>
+    size_t try_push_batch(InputIt first, InputIt last, Stats&& = {})
+    {
+        size_t tail = block_.tail->load(std::memory_order_relaxed);
+        size_t head = block_.head->load(std::memory_order_acquire);
+        size_t available = head + block_.capacity - tail;
         if (available == 0)
         {
             return 0;
         }
         size_t count = 0;
-        for (auto it = first; count < available && it != last; ++it, ++count)
+        if constexpr (block_type::contiguous && bulk_copyable<T, InputIt>)
         {
-            size_t slot = (tail + count) % capacity;
-            new (&block_[slot]) T(std::move(*it));
+            count = std::min(available, static_cast<size_t>(std::distance(first, last)));
+            copy_to_block(block_, tail, std::to_address(first), count);
+        }
+        else
+        {
+            for (auto it = first; count < available && it != last; ++it, ++count)
+            {
+                new (&block_[block_.index(tail + count)]) T(std::move(*it));
+            }
         }
         block_.tail->store(tail + count, std::memory_order_release);
         return count;
     }
 
-    template <typename OutputIt>
-    size_t try_pop_batch(OutputIt first, size_t max_count)
+    template <typename OutputIt, typename Stats = no_queue_stats>
+    size_t try_pop_batch(OutputIt first, size_t max_count, Stats&& = {})
     {
         size_t head = block_.head->load(std::memory_order_relaxed);
         size_t tail = block_.tail->load(std::memory_order_acquire);
@@ -130,12 +460,18 @@ public:
             return 0;
         }
         size_t count = std::min(available, max_count);
-        size_t capacity = block_.capacity;
-        for (size_t i = 0; i < count; ++i)
+        if constexpr (block_type::contiguous && bulk_copyable<T, OutputIt>)
         {
-            size_t slot = (head + i) % capacity;
-            *first++ = std::move(block_[slot]);
-            block_[slot].~T();
+            copy_from_block(block_, head, std::to_address(first), count);
+        }
+        else
+        {
+            for (size_t i = 0; i < count; ++i)
+            {
+                size_t slot = block_.index(head + i);
+                *first++ = std::move(block_[slot]);
+                block_[slot].~T();
+            }
         }
         block_.head->store(head + count, std::memory_order_release);
         return count;
@@ -161,84 +497,136 @@ private:
     block_type block_;
 };
 
-template <typename T>
-class mpsc_queue final
+template <typename T, typename Block>
+class basic_mpsc_queue final
 {
 private:
-    using block_type = memory_block<T, true>;
+    using block_type = Block;
 public:
-    explicit mpsc_queue(size_t capacity) :
-        block_(capacity) {}
+    template <typename... Args>
+        requires std::is_constructible_v<block_type, Args...>
+    explicit basic_mpsc_queue(Args&&... args) :
+        block_(std::forward<Args>(args)...) {}
 
-    ~mpsc_queue()
+    ~basic_mpsc_queue()
     {
-        size_t head = block_.head->load(std::memory_order_relaxed);
-        size_t tail = block_.tail->load(std::memory_order_relaxed);
-        while (head < tail)
+        if constexpr (!std::is_trivially_destructible_v<T>)
         {
-            size_t slot = head % block_.capacity;
-            block_[slot].~T();
-            ++head;
+            size_t head = block_.head->load(std::memory_order_relaxed);
+            size_t tail = block_.tail->load(std::memory_order_relaxed);
+            while (head < tail)
+            {
+                block_[block_.index(head)].~T();
+                ++head;
+            }
         }
     }
 public:
-    bool try_push(T&& value)
+    template <typename Stats = no_queue_stats>
+    bool try_push(T&& value, Stats&& stats = {})
     {
-        T temp(std::move(value));
-        return try_push_batch(&temp, &temp + 1) == 1;
+        size_t pos = 0;
+        if (claim(1, pos, stats) == 0)
+        {
+            return false;
+        }
+        new (&block_[block_.index(pos)]) T(std::move(value));
+        publish(pos, 1);
+        return true;
     }
 
-    bool try_pop(T& result)
+    template <typename Stats = no_queue_stats>
+    bool try_pop(T& result, Stats&& = {})
     {
         return try_pop_batch(&result, 1) == 1;
     }
 
-    template <typename InputIt>
-    size_t try_push_batch(InputIt first, InputIt last)
+    // the whole reserved range must be committed, or the consumer stalls on it
+    template <typename Stats = no_queue_stats>
+    slot_range<T> reserve(size_t count, Stats&& stats = {})
     {
-        size_t pos = block_.tail->load(std::memory_order_relaxed);
-        size_t head = block_.head->load(std::memory_order_acquire);
+        size_t pos = 0;
+        size_t claimed = claim(count, pos, stats);
+        return claimed ? make_slot_range<T>(block_, pos, claimed) : slot_range<T>{};
+    }
+
+    void commit(const slot_range<T>& range)
+    {
+        publish(range.position(), range.size());
+    }
+
+    slot_range<T> peek(size_t max_count = std::numeric_limits<size_t>::max())
+    {
+        size_t head = block_.head->load(std::memory_order_relaxed);
+        size_t tail = block_.tail->load(std::memory_order_acquire);
+        size_t limit = std::min(tail - head, max_count);
+        size_t count = 0;
+        for ( ; count < limit; ++count)
+        {
+            size_t slot = block_.index(head + count);
+            if (block_.sequence(slot).load(std::memory_order_acquire) != head + count + 1)
+            {
+                break;
+            }
+        }
+        return make_slot_range<T>(block_, head, count);
+    }
+
+    // count must not exceed what the last peek() returned
+    void consume(size_t count)
+    {
+        size_t head = block_.head->load(std::memory_order_relaxed);
         size_t capacity = block_.capacity;
-        size_t available = head + capacity - pos;
-        if (available == 0)
+        for (size_t i = 0; i < count; ++i)
         {
-            return 0;
+            size_t slot = block_.index(head + i);
+            assert(block_.sequence(slot).load(std::memory_order_acquire) == head + i + 1 &&
+                "consume past the peeked range");
+            if constexpr (!std::is_trivially_destructible_v<T>)
+            {
+                block_[slot].~T();
+            }
+            block_.sequence(slot).store(head + i + capacity, std::memory_order_release);
         }
+        block_.head->store(head + count, std::memory_order_release);
+    }
+
+    template <typename InputIt, typename Stats = no_queue_stats>
+    size_t try_push_batch(InputIt first, InputIt last, Stats&& stats = {})
+    {
         size_t requested = std::distance(first, last);
         if (requested == 0)
         {
             return 0;
         }
-        size_t max_count = std::min(requested, available);
-        size_t count = 0;
-        for ( ; count < max_count; ++count)
-        {
-            size_t slot = (pos + count) % capacity;
-            if (block_.sequences[slot].load(std::memory_order_acquire) != pos + count)
-            {
-                break;
-            }
-        }
+        size_t pos = 0;
+        size_t count = claim(requested, pos, stats);
         if (count == 0)
         {
             return 0;
         }
-        if (!block_.tail->compare_exchange_weak(pos, pos + count,
-            std::memory_order_release, std::memory_order_relaxed))
+        if constexpr (block_type::contiguous && bulk_copyable<T, InputIt>)
         {
-            return 0;
+            copy_to_block(block_, pos, std::to_address(first), count);
+            for (size_t i = 0; i < count; ++i)
+            {
+                block_.sequence(block_.index(pos + i)).store(pos + i + 1, std::memory_order_release);
+            }
         }
-        for (size_t i = 0; i < count; ++i, ++first)
+        else
         {
-            size_t slot = (pos + i) % capacity;
-            new (&block_[slot]) T(std::move(*first));
-            block_.sequences[slot].store(pos + i + 1, std::memory_order_release);
+            for (size_t i = 0; i < count; ++i, ++first)
+            {
+                size_t slot = block_.index(pos + i);
+                new (&block_[slot]) T(std::move(*first));
+                block_.sequence(slot).store(pos + i + 1, std::memory_order_release);
+            }
         }
         return count;
     }
 
-    template <typename OutputIt>
-    size_t try_pop_batch(OutputIt first, size_t max_count)
+    template <typename OutputIt, typename Stats = no_queue_stats>
+    size_t try_pop_batch(OutputIt first, size_t max_count, Stats&& = {})
     {
         size_t head = block_.head->load(std::memory_order_relaxed);
         size_t tail = block_.tail->load(std::memory_order_acquire);
@@ -251,8 +639,8 @@ public:
         size_t count = 0;
         for (; count < std::min(available, max_count); ++count)
         {
-            size_t slot = (head + count) % capacity;
-            if (block_.sequences[slot].load(std::memory_order_acquire) != head + count + 1)
+            size_t slot = block_.index(head + count);
+            if (block_.sequence(slot).load(std::memory_order_acquire) != head + count + 1)
             {
                 break;
             }
@@ -261,12 +649,23 @@ public:
         {
             return 0;
         }
-        for (size_t i = 0; i < count; ++i)
+        if constexpr (block_type::contiguous && bulk_copyable<T, OutputIt>)
         {
-            size_t slot = (head + i) % capacity;
-            *first++ = std::move(block_[slot]);
-            block_[slot].~T();
-            block_.sequences[slot].store(head + i + capacity, std::memory_order_release);
+            copy_from_block(block_, head, std::to_address(first), count);
+            for (size_t i = 0; i < count; ++i)
+            {
+                block_.sequence(block_.index(head + i)).store(head + i + capacity, std::memory_order_release);
+            }
+        }
+        else
+        {
+            for (size_t i = 0; i < count; ++i)
+            {
+                size_t slot = block_.index(head + i);
+                *first++ = std::move(block_[slot]);
+                block_[slot].~T();
+                block_.sequence(slot).store(head + i + capacity, std::memory_order_release);
+            }
         }
         block_.head->store(head + count, std::memory_order_release);
         return count;
@@ -288,32 +687,79 @@ public:
     {
         return size() == 0;
     }
+private:
+    // Claims up to count free slots at the tail. A failed CAS means another
+    // producer moved the tail (or a spurious failure), not that the queue is
+    // full, so it rescans from the new tail; 0 only when no slot is free.
+    template <typename Stats>
+    size_t claim(size_t count, size_t& pos, Stats& stats)
+    {
+        pos = block_.tail->load(std::memory_order_relaxed);
+        while (true)
+        {
+            size_t head = block_.head->load(std::memory_order_acquire);
+            size_t max_count = std::min(count, head + block_.capacity - pos);
+            size_t claimed = 0;
+            for ( ; claimed < max_count; ++claimed)
+            {
+                size_t slot = block_.index(pos + claimed);
+                if (block_.sequence(slot).load(std::memory_order_acquire) != pos + claimed)
+                {
+                    break;
+                }
+            }
+            if (claimed == 0)
+            {
+                return 0;
+            }
+            bool won = block_.tail->compare_exchange_weak(pos, pos + claimed,
+                std::memory_order_release, std::memory_order_relaxed);
+            stats.record_push_cas(!won);
+            if (won)
+            {
+                return claimed;
+            }
+        }
+    }
+
+    void publish(size_t pos, size_t count)
+    {
+        for (size_t i = 0; i < count; ++i)
+        {
+            block_.sequence(block_.index(pos + i)).store(pos + i + 1, std::memory_order_release);
+        }
+    }
 private:
     block_type block_;
 };
 
-template <typename T>
-class mpmc_queue final
+template <typename T, typename Block>
+class basic_mpmc_queue final
 {
 private:
-    using block_type = memory_block<T, true>;
+    using block_type = Block;
 public:
-    explicit mpmc_queue(size_t capacity) :
-        block_(capacity) {}
+    template <typename... Args>
+        requires std::is_constructible_v<block_type, Args...>
+    explicit basic_mpmc_queue(Args&&... args) :
+        block_(std::forward<Args>(args)...) {}
 
-    ~mpmc_queue()
+    ~basic_mpmc_queue()
     {
-        size_t head = block_.head->load(std::memory_order_relaxed);
-        size_t tail = block_.tail->load(std::memory_order_relaxed);
-        while (head < tail)
+        if constexpr (!std::is_trivially_destructible_v<T>)
         {
-            size_t slot = head % block_.capacity;
-            block_[slot].~T();
-            ++head;
+            size_t head = block_.head->load(std::memory_order_relaxed);
+            size_t tail = block_.tail->load(std::memory_order_relaxed);
+            while (head < tail)
+            {
+                block_[block_.index(head)].~T();
+                ++head;
+            }
         }
     }
 public:
-    bool try_push(T&& value)
+    template <typename Stats = no_queue_stats>
+    bool try_push(T&& value, Stats&& stats = {})
     {
         size_t pos = block_.tail->load(std::memory_order_relaxed);
         size_t capacity = block_.capacity;
@@ -321,23 +767,26 @@ public:
         {
             return false;
         }
-        size_t slot = pos % capacity;
-        size_t seq = block_.sequences[slot].load(std::memory_order_acquire);
+        size_t slot = block_.index(pos);
+        size_t seq = block_.sequence(slot).load(std::memory_order_acquire);
         if (seq != pos)
         {
             return false;
         }
-        if (!block_.tail->compare_exchange_weak(pos, pos + 1, 
-            std::memory_order_acq_rel, std::memory_order_relaxed))
+        bool won = block_.tail->compare_exchange_weak(pos, pos + 1,
+            std::memory_order_acq_rel, std::memory_order_relaxed);
+        stats.record_push_cas(!won);
+        if (!won)
         {
             return false;
         }
         new (&block_[slot]) T(std::move(value));
-        block_.sequences[slot].store(pos + 1, std::memory_order_release);
+        block_.sequence(slot).store(pos + 1, std::memory_order_release);
         return true;
     }
 
-    bool try_pop(T& result)
+    template <typename Stats = no_queue_stats>
+    bool try_pop(T& result, Stats&& stats = {})
     {
         size_t pos = block_.head->load(std::memory_order_relaxed);
         if (pos == block_.tail->load(std::memory_order_acquire))
@@ -345,51 +794,147 @@ public:
             return false;
         }
         size_t capacity = block_.capacity;
-        size_t slot = pos % capacity;
-        size_t seq = block_.sequences[slot].load(std::memory_order_acquire);
+        size_t slot = block_.index(pos);
+        size_t seq = block_.sequence(slot).load(std::memory_order_acquire);
         if (seq != pos + 1)
         {
             return false;
         }
-        if (!block_.head->compare_exchange_weak(pos, pos + 1,
-            std::memory_order_acq_rel, std::memory_order_relaxed))
+        bool won = block_.head->compare_exchange_weak(pos, pos + 1,
+            std::memory_order_acq_rel, std::memory_order_relaxed);
+        stats.record_pop_cas(!won);
+        if (!won)
         {
             return false;
         }
         result = std::move(block_[slot]);
         block_[slot].~T();
-        block_.sequences[slot].store(pos + capacity, std::memory_order_release);
+        block_.sequence(slot).store(pos + capacity, std::memory_order_release);
         return true;
     }
 
-    template <typename InputIt>
-    size_t try_push_batch(InputIt first, InputIt last)
+    template <typename InputIt, typename Stats = no_queue_stats>
+    size_t try_push_batch(InputIt first, InputIt last, Stats&& stats = {})
     {
-        size_t pushed = 0;
-        for (auto it = first; it != last; ++it)
+        size_t requested = std::distance(first, last);
+        if (requested == 0)
         {
-            if (!try_push(std::move(*it)))
+            return 0;
+        }
+        // a lost CAS means other producers moved the tail, not that the queue
+        // is full, so rescan from the new tail; 0 only when no slot is free
+        size_t pos = block_.tail->load(std::memory_order_relaxed);
+        size_t count = 0;
+        while (true)
+        {
+            count = 0;
+            for ( ; count < std::min(requested, block_.capacity); ++count)
+            {
+                size_t slot = block_.index(pos + count);
+                if (block_.sequence(slot).load(std::memory_order_acquire) != pos + count)
+                {
+                    break;
+                }
+            }
+            if (count == 0)
+            {
+                // a sequence ahead of pos means the slot was claimed since tail was read
+                size_t seq = block_.sequence(block_.index(pos)).load(std::memory_order_acquire);
+                if (static_cast<std::ptrdiff_t>(seq - pos) <= 0)
+                {
+                    return 0;
+                }
+                pos = block_.tail->load(std::memory_order_relaxed);
+                continue;
+            }
+            bool won = block_.tail->compare_exchange_weak(pos, pos + count,
+                std::memory_order_acq_rel, std::memory_order_relaxed);
+            stats.record_push_cas(!won);
+            if (won)
             {
                 break;
             }
-            pushed++;
         }
-        return pushed;
+        if constexpr (block_type::contiguous && bulk_copyable<T, InputIt>)
+        {
+            copy_to_block(block_, pos, std::to_address(first), count);
+            for (size_t i = 0; i < count; ++i)
+            {
+                block_.sequence(block_.index(pos + i)).store(pos + i + 1, std::memory_order_release);
+            }
+        }
+        else
+        {
+            for (size_t i = 0; i < count; ++i, ++first)
+            {
+                size_t slot = block_.index(pos + i);
+                new (&block_[slot]) T(std::move(*first));
+                block_.sequence(slot).store(pos + i + 1, std::memory_order_release);
+            }
+        }
+        return count;
     }
 
-    template <typename OutputIt>
-    size_t try_pop_batch(OutputIt first, size_t max_count)
+    template <typename OutputIt, typename Stats = no_queue_stats>
+    size_t try_pop_batch(OutputIt first, size_t max_count, Stats&& stats = {})
     {
-        size_t popped = 0;
-        for (size_t i = 0; i < max_count; ++i)
+        if (max_count == 0)
+        {
+            return 0;
+        }
+        // as in try_push_batch, a lost CAS rescans from the new head
+        size_t pos = block_.head->load(std::memory_order_relaxed);
+        size_t capacity = block_.capacity;
+        size_t count = 0;
+        while (true)
         {
-            if (!try_pop(*first++))
+            count = 0;
+            for ( ; count < std::min(max_count, capacity); ++count)
+            {
+                size_t slot = block_.index(pos + count);
+                if (block_.sequence(slot).load(std::memory_order_acquire) != pos + count + 1)
+                {
+                    break;
+                }
+            }
+            if (count == 0)
+            {
+                // a sequence past pos + 1 means the slot was consumed since head was read
+                size_t seq = block_.sequence(block_.index(pos)).load(std::memory_order_acquire);
+                if (static_cast<std::ptrdiff_t>(seq - (pos + 1)) <= 0)
+                {
+                    return 0;
+                }
+                pos = block_.head->load(std::memory_order_relaxed);
+                continue;
+            }
+            bool won = block_.head->compare_exchange_weak(pos, pos + count,
+                std::memory_order_acq_rel, std::memory_order_relaxed);
+            stats.record_pop_cas(!won);
+            if (won)
             {
                 break;
             }
-            popped++;
         }
-        return popped;
+        if constexpr (block_type::contiguous && bulk_copyable<T, OutputIt>)
+        {
+            copy_from_block(block_, pos, std::to_address(first), count);
+            for (size_t i = 0; i < count; ++i)
+            {
+                block_.sequence(block_.index(pos + i)).store(pos + i + capacity, std::memory_order_release);
+            }
+        }
+        else
+        {
+            for (size_t i = 0; i < count; ++i)
+            {
+                size_t slot = block_.index(pos + i);
+                *first++ = std::move(block_[slot]);
+                block_[slot].~T();
+                block_.sequence(slot).store(pos + i + capacity, std::memory_order_release);
+            }
+        }
+        return count;
     }
 
     size_t size() const
@@ -412,14 +957,50 @@ private:
     block_type block_;
 };
 
+template <typename T>
+using spsc_queue = basic_spsc_queue<T, memory_block<T, false>>;
+
+template <typename T>
+using mpsc_queue = basic_mpsc_queue<T, memory_block<T, true>>;
+
+template <typename T>
+using mpmc_queue = basic_mpmc_queue<T, memory_block<T, true>>;
+
+template <typename Layout>
+struct slot_layout
+{
+    template <typename T>
+    using mpsc_queue = basic_mpsc_queue<T, typename sequenced_block<T, Layout>::type>;
+
+    template <typename T>
+    using mpmc_queue = basic_mpmc_queue<T, typename sequenced_block<T, Layout>::type>;
+};
+
+template <size_t Capacity>
+struct static_capacity
+{
+    template <typename T>
+    using spsc_queue = basic_spsc_queue<T, static_memory_block<T, Capacity, false>>;
+
+    template <typename T>
+    using mpsc_queue = basic_mpsc_queue<T, static_memory_block<T, Capacity, true>>;
+
+    template <typename T>
+    using mpmc_queue = basic_mpmc_queue<T, static_memory_block<T, Capacity, true>>;
+};
+
 } // namespace detail
 
-template <typename T, template <typename> class Queue>
+template <typename T, template <typename> class Queue, typename WaitStrategy = spin_yield_wait,
+    typename Stats = default_queue_stats>
 class RING_API lockfree_queue final
 {
 public:
-    explicit lockfree_queue(size_t capacity) :
-        impl_(capacity) {}
+    lockfree_queue() requires std::is_default_constructible_v<Queue<T>> = default;
+    template <typename... Args>
+        requires (sizeof...(Args) > 0 && std::is_constructible_v<Queue<T>, Args...>)
+    explicit lockfree_queue(Args&&... args) :
+        impl_(std::forward<Args>(args)...) {}
     ~lockfree_queue() = default;
 private:
     lockfree_queue(const lockfree_queue&) = delete;
@@ -427,7 +1008,14 @@ private:
 public:
     bool try_push(T&& value)
     {
-        return impl_.try_push(std::move(value));
+        if (!impl_.try_push(std::move(value), stats_))
+        {
+            record_push(0);
+            return false;
+        }
+        record_push(1);
+        wait_.notify(wait_channel::not_empty);
+        return true;
     }
 
     bool try_push(const T& value)
@@ -437,27 +1025,85 @@ public:
 
     bool try_pop(T& result)
     {
-        return impl_.try_pop(result);
+        if (!impl_.try_pop(result, stats_))
+        {
+            record_pop(0);
+            return false;
+        }
+        record_pop(1);
+        wait_.notify(wait_channel::not_full);
+        return true;
+    }
+
+    slot_range<T> reserve(size_t count)
+    {
+        auto range = impl_.reserve(count, stats_);
+        if (range.empty() && count)
+        {
+            record_push(0);
+        }
+        return range;
+    }
+
+    void commit(const slot_range<T>& range)
+    {
+        impl_.commit(range);
+        if (!range.empty())
+        {
+            record_push(range.size());
+            wait_.notify(wait_channel::not_empty);
+        }
+    }
+
+    slot_range<T> peek(size_t max_count = std::numeric_limits<size_t>::max())
+    {
+        auto range = impl_.peek(max_count);
+        if (range.empty() && max_count)
+        {
+            record_pop(0);
+        }
+        return range;
+    }
+
+    void consume(size_t count)
+    {
+        impl_.consume(count);
+        if (count)
+        {
+            record_pop(count);
+            wait_.notify(wait_channel::not_full);
+        }
     }
 
     template <typename InputIt>
     size_t try_push_batch(InputIt first, InputIt last)
     {
-        return impl_.try_push_batch(first, last);
+        size_t pushed = impl_.try_push_batch(first, last, stats_);
+        record_push(pushed);
+        if (pushed)
+        {
+            wait_.notify(wait_channel::not_empty);
+        }
+        return pushed;
     }
 
     template <typename OutputIt>
     size_t try_pop_batch(OutputIt first, size_t max_count)
     {
-        return impl_.try_pop_batch(first, max_count);
+        size_t popped = impl_.try_pop_batch(first, max_count, stats_);
+        record_pop(popped);
+        if (popped)
+        {
+            wait_.notify(wait_channel::not_full);
+        }
+        return popped;
     }
 
     void push(T&& value)
     {
-        while (!try_push(std::move(value)))
-        {
-            std::this_thread::yield();
-        }
+        uint64_t attempts = 0;
+        wait_.wait(wait_channel::not_full, [&]() { return ++attempts, try_push(std::move(value)); });
+        stats_.record_push_waits(attempts - 1);
     }
 
     void push(const T& value)
@@ -467,10 +1113,9 @@ public:
 
     void pop(T& result)
     {
-        while (!try_pop(result))
-        {
-            std::this_thread::yield();
-        }
+        uint64_t attempts = 0;
+        wait_.wait(wait_channel::not_empty, [&]() { return ++attempts, try_pop(result); });
+        stats_.record_pop_waits(attempts - 1);
     }
 
     template <typename InputIt>
@@ -479,15 +1124,11 @@ public:
         auto it = first;
         while (it != last)
         {
-            size_t pushed = try_push_batch(it, last);
-            if (pushed)
-            {
-                std::advance(it, pushed);
-            }
-            else
-            {
-                std::this_thread::yield();
-            }
+            size_t pushed = 0;
+            uint64_t attempts = 0;
+            wait_.wait(wait_channel::not_full, [&]() { return ++attempts, (pushed = try_push_batch(it, last)) != 0; });
+            stats_.record_push_waits(attempts - 1);
+            std::advance(it, pushed);
         }
     }
 
@@ -497,18 +1138,61 @@ public:
         size_t total_popped = 0;
         while (total_popped < max_count)
         {
-            size_t popped = try_pop_batch(std::next(first, total_popped), max_count - total_popped);
-            if (popped)
-            {
-                total_popped += popped;
-            }
-            else
-            {
-                std::this_thread::yield();
-            }
+            size_t popped = 0;
+            uint64_t attempts = 0;
+            wait_.wait(wait_channel::not_empty, [&]()
+                {
+                    ++attempts;
+                    return (popped = try_pop_batch(std::next(first, total_popped), max_count - total_popped)) != 0;
+                });
+            stats_.record_pop_waits(attempts - 1);
+            total_popped += popped;
         }
     }
 
+    template <typename Clock, typename Duration>
+    bool push_until(T&& value, const std::chrono::time_point<Clock, Duration>& deadline)
+    {
+        uint64_t attempts = 0;
+        bool pushed = wait_.wait_until(wait_channel::not_full,
+            [&]() { return ++attempts, try_push(std::move(value)); }, deadline);
+        stats_.record_push_waits(attempts - 1);
+        return pushed;
+    }
+
+    template <typename Clock, typename Duration>
+    bool push_until(const T& value, const std::chrono::time_point<Clock, Duration>& deadline)
+    {
+        return push_until(T(value), deadline);
+    }
+
+    template <typename Rep, typename Period>
+    bool push_for(T&& value, const std::chrono::duration<Rep, Period>& timeout)
+    {
+        return push_until(std::move(value), std::chrono::steady_clock::now() + timeout);
+    }
+
+    template <typename Rep, typename Period>
+    bool push_for(const T& value, const std::chrono::duration<Rep, Period>& timeout)
+    {
+        return push_until(T(value), std::chrono::steady_clock::now() + timeout);
+    }
+
+    template <typename Clock, typename Duration>
+    bool pop_until(T& result, const std::chrono::time_point<Clock, Duration>& deadline)
+    {
+        uint64_t attempts = 0;
+        bool popped = wait_.wait_until(wait_channel::not_empty, [&]() { return ++attempts, try_pop(result); }, deadline);
+        stats_.record_pop_waits(attempts - 1);
+        return popped;
+    }
+
+    template <typename Rep, typename Period>
+    bool pop_for(T& result, const std::chrono::duration<Rep, Period>& timeout)
+    {
+        return pop_until(result, std::chrono::steady_clock::now() + timeout);
+    }
+
     size_t size() const
     {
         return impl_.size();
@@ -523,18 +1207,77 @@ public:
     {
         return impl_.empty();
     }
+
+    bool backpressure() const
+    {
+        return impl_.backpressure();
+    }
+
+    const Stats& stats() const
+    {
+        return stats_;
+    }
+
+    Stats& stats()
+    {
+        return stats_;
+    }
+private:
+    // count == 0 records a rejected attempt, telling full/empty apart from a busy slot
+    void record_push(size_t count)
+    {
+        if constexpr (Stats::enabled)
+        {
+            if (count)
+            {
+                stats_.record_push(count, impl_.size());
+            }
+            else
+            {
+                stats_.record_push_failure(impl_.size() >= impl_.capacity());
+            }
+        }
+    }
+
+    void record_pop(size_t count)
+    {
+        if constexpr (Stats::enabled)
+        {
+            if (count)
+            {
+                stats_.record_pop(count);
+            }
+            else
+            {
+                stats_.record_pop_failure(impl_.empty());
+            }
+        }
+    }
 private:
     Queue<T> impl_;
+    [[no_unique_address]] WaitStrategy wait_;
+    [[no_unique_address]] Stats stats_;
 };
 
-template <typename T>
-using spsc_queue = lockfree_queue<T, detail::spsc_queue>;
+template <typename T, typename WaitStrategy = spin_yield_wait, typename Stats = default_queue_stats>
+using spsc_queue = lockfree_queue<T, detail::spsc_queue, WaitStrategy, Stats>;
 
-template <typename T>
-using mpsc_queue = lockfree_queue<T, detail::mpsc_queue>;
+template <typename T, typename WaitStrategy = spin_yield_wait, typename Layout = split_layout,
+    typename Stats = default_queue_stats>
+using mpsc_queue = lockfree_queue<T, detail::slot_layout<Layout>::template mpsc_queue, WaitStrategy, Stats>;
 
-template <typename T>
-using mpmc_queue = lockfree_queue<T, detail::mpmc_queue>;
+template <typename T, typename WaitStrategy = spin_yield_wait, typename Layout = split_layout,
+    typename Stats = default_queue_stats>
+using mpmc_queue = lockfree_queue<T, detail::slot_layout<Layout>::template mpmc_queue, WaitStrategy, Stats>;
+
+template <typename T, size_t Capacity, typename WaitStrategy = spin_yield_wait, typename Stats = default_queue_stats>
+using static_spsc_queue = lockfree_queue<T, detail::static_capacity<Capacity>::template spsc_queue, WaitStrategy, Stats>;
+
+template <typename T, size_t Capacity, typename WaitStrategy = spin_yield_wait, typename Stats = default_queue_stats>
+using static_mpsc_queue = lockfree_queue<T, detail::static_capacity<Capacity>::template mpsc_queue, WaitStrategy, Stats>;
+
+template <typename T, size_t Capacity, typename WaitStrategy = spin_yield_wait, typename Stats = default_queue_stats>
+using static_mpmc_queue = lockfree_queue<T, detail::static_capacity<Capacity>::template mpmc_queue, WaitStrategy, Stats>;
 
 } // namespace ring::core
 
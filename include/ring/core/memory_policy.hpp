@@ -0,0 +1,73 @@
+#ifndef RING_CORE_MEMORY_POLICY_HPP_
+#define RING_CORE_MEMORY_POLICY_HPP_
+
+#include <cstddef>
+
+#include "ring/core/export.hpp"
+
+namespace ring::core
+{
+
+enum class page_mode
+{
+    // plain operator new
+    standard,
+    // mmap aligned to 2 MB plus MADV_HUGEPAGE
+    transparent_huge,
+    // MAP_HUGETLB from the reserved 2 MB pool, falling back to transparent_huge
+    explicit_huge
+};
+
+// How large backing buffers (queue rings, pool chunks, arena chunks) are
+// obtained. Every step degrades gracefully: a failed hugetlb mapping falls
+// back to THP, a failed mbind leaves the kernel's default placement.
+struct memory_policy
+{
+    static constexpr int any_node = -1;
+    // node of the CPU the allocating thread runs on
+    static constexpr int local_node = -2;
+
+    page_mode pages = page_mode::standard;
+    // preferred NUMA node; any_node leaves placement to first touch
+    int numa_node = any_node;
+    // touch every page up front so faults happen at startup, not mid-tick;
+    // with any_node this is first-touch placement on the calling thread
+    bool prefault = false;
+    // smaller buffers always use operator new
+    size_t min_size = 2 * 1024 * 1024;
+
+    bool applies(size_t size) const
+    {
+        return size >= min_size && (pages != page_mode::standard || numa_node != any_node || prefault);
+    }
+};
+
+// used by make_unique_buffer_aligned(size); set it once at startup. Reads
+// go through a per-thread copy that is refreshed only after a set.
+RING_API void set_default_memory_policy(const memory_policy& policy);
+RING_API memory_policy default_memory_policy();
+
+// NUMA node of the calling thread's current CPU, 0 when unknown
+RING_API int current_numa_node();
+
+namespace detail
+{
+
+struct page_allocation
+{
+    void* data = nullptr;
+    // bytes mapped; 0 means data came from aligned operator new
+    size_t mapped = 0;
+    // what was actually obtained after fallbacks
+    page_mode pages = page_mode::standard;
+};
+
+// alignment beyond the page size is honoured by over-mapping
+RING_API page_allocation allocate_pages(size_t size, const memory_policy& policy, size_t alignment);
+RING_API void release_pages(void* data, size_t mapped);
+
+} // namespace detail
+
+} // namespace ring::core
+
+#endif // RING_CORE_MEMORY_POLICY_HPP_
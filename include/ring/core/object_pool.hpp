@@ -1,12 +1,21 @@
 #ifndef RING_CORE_OBJECT_POOL_HPP_
 #define RING_CORE_OBJECT_POOL_HPP_
 
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstdint>
+#include <functional>
 #include <memory>
 #include <mutex>
-#include <stack>
+#include <utility>
 #include <vector>
 
+#include "ring/core/cache_line.hpp"
+#include "ring/core/exception.hpp"
 #include "ring/core/export.hpp"
+#include "ring/core/wait_strategy.hpp"
 
 namespace ring::core
 {
@@ -17,39 +26,51 @@ class object_pool_impl
 protected:
     static constexpr size_t default_chunk_capacity = 1024;
 private:
+    // a dead slot holds the free-list link in place of the object
+    union storage_type
+    {
+        storage_type* next;
+        alignas(alignof(T)) std::byte data[sizeof(T)];
+    };
+
+    // backed by make_unique_buffer_aligned so large chunks follow the default memory_policy
     class pool_chunk
     {
-    private:
-        struct storage_type
-        {
-            alignas(alignof(T)) std::byte data[sizeof(T)];
-        };
     public:
-        pool_chunk(size_t capacity)
-        {
-            storage_.resize(capacity);
-        }
+        explicit pool_chunk(size_t capacity) :
+            buffer_(make_unique_buffer_aligned(capacity * sizeof(storage_type), alignof(storage_type))),
+            storage_(reinterpret_cast<storage_type*>(buffer_.get())),
+            capacity_(capacity) {}
         ~pool_chunk() = default;
+    private:
+        pool_chunk(const pool_chunk&) = delete;
+        pool_chunk& operator=(const pool_chunk&) = delete;
     public:
-        void* acquire()
+        storage_type* acquire()
         {
             return &storage_[offset_++];
         }
         bool is_full() const
         {
-            return offset_ >= storage_.size();
+            return offset_ >= capacity_;
+        }
+        const storage_type* begin() const
+        {
+            return storage_;
         }
         size_t offset() const
         {
             return offset_;
         }
     private:
-        std::vector<storage_type> storage_;
+        buffer_aligned buffer_;
+        storage_type* storage_;
+        const size_t capacity_;
         size_t offset_ = 0;
     };
 protected:
     explicit object_pool_impl(size_t chunk_capacity) :
-        chunk_capacity_(chunk_capacity) {}
+        chunk_capacity_(chunk_capacity ? chunk_capacity : default_chunk_capacity) {}
     ~object_pool_impl() = default;
 protected:
     object_pool_impl(const object_pool_impl&) = delete;
@@ -60,22 +81,30 @@ protected:
     template<typename... Args>
     T* acquire(Args&&... args)
     {
-        T *obj = nullptr;
-        if (free_list_.empty())
+        storage_type* slot = free_list_;
+        if (slot)
+        {
+            free_list_ = slot->next;
+            --free_count_;
+        }
+        else
         {
             if (chunks_.empty() || chunks_.back()->is_full())
             {
                 chunks_.emplace_back(std::make_unique<pool_chunk>(chunk_capacity_));
             }
-            obj = reinterpret_cast<T*>(chunks_.back()->acquire());
+            slot = chunks_.back()->acquire();
+            ++carved_;
         }
-        else
+        try
+        {
+            return new (slot->data) T(std::forward<Args>(args)...);
+        }
+        catch (...)
         {
-            obj = free_list_.top();
-            free_list_.pop();
+            push_free(slot);
+            throw;
         }
-        new (obj) T(std::forward<Args>(args)...);
-        return obj;
     }
     void release(T* obj)
     {
@@ -84,7 +113,7 @@ protected:
             return;
         }
         obj->~T();
-        free_list_.push(obj);
+        push_free(reinterpret_cast<storage_type*>(obj));
     }
     bool empty() const
     {
@@ -92,21 +121,131 @@ protected:
     }
     size_t size() const
     {
-        if (chunks_.empty())
+        return carved_ - free_count_;
+    }
+    size_t capacity() const
+    {
+        return chunks_.size() * chunk_capacity_;
+    }
+
+    // Carves chunks until count objects fit, threading every new slot onto the
+    // free list. That write touches each page, so later acquires neither
+    // allocate nor fault.
+    void reserve(size_t count)
+    {
+        if (capacity() >= count)
+        {
+            return;
+        }
+        // acquire() only carves from the last chunk, so finish the current one first
+        if (!chunks_.empty())
+        {
+            carve_all(*chunks_.back());
+        }
+        while (capacity() < count)
+        {
+            chunks_.emplace_back(std::make_unique<pool_chunk>(chunk_capacity_));
+            carve_all(*chunks_.back());
+        }
+    }
+
+    // frees every chunk with no live object beyond the first max_idle_chunks;
+    // walks the whole free list, so call it after a load spike, not per tick
+    size_t trim(size_t max_idle_chunks)
+    {
+        if (chunks_.empty() || free_count_ == 0)
         {
             return 0;
         }
-        return (chunks_.size() - 1) * chunk_capacity_ + chunks_.back()->offset() - free_list_.size();
+        std::vector<size_t> order(chunks_.size());
+        for (size_t i = 0; i < order.size(); ++i)
+        {
+            order[i] = i;
+        }
+        // chunks are separate allocations, so order them with std::less rather than a raw <
+        std::less<const storage_type*> before;
+        std::sort(order.begin(), order.end(),
+            [&](size_t lhs, size_t rhs) { return before(chunks_[lhs]->begin(), chunks_[rhs]->begin()); });
+        auto owner = [&](const storage_type* slot)
+            {
+                auto it = std::upper_bound(order.begin(), order.end(), slot,
+                    [&](const storage_type* value, size_t index) { return before(value, chunks_[index]->begin()); });
+                return *std::prev(it);
+            };
+
+        std::vector<size_t> free_slots(chunks_.size());
+        for (auto* slot = free_list_; slot; slot = slot->next)
+        {
+            ++free_slots[owner(slot)];
+        }
+        std::vector<bool> dropped(chunks_.size());
+        size_t idle = 0;
+        size_t released = 0;
+        for (size_t i = 0; i < chunks_.size(); ++i)
+        {
+            if (free_slots[i] == chunks_[i]->offset() && idle++ >= max_idle_chunks)
+            {
+                dropped[i] = true;
+                carved_ -= chunks_[i]->offset();
+                free_count_ -= free_slots[i];
+                ++released;
+            }
+        }
+        if (released == 0)
+        {
+            return 0;
+        }
+
+        storage_type** link = &free_list_;
+        while (*link)
+        {
+            if (dropped[owner(*link)])
+            {
+                *link = (*link)->next;
+            }
+            else
+            {
+                link = &(*link)->next;
+            }
+        }
+        size_t kept = 0;
+        for (size_t i = 0; i < chunks_.size(); ++i)
+        {
+            if (!dropped[i])
+            {
+                chunks_[kept++] = std::move(chunks_[i]);
+            }
+        }
+        chunks_.resize(kept);
+        return released;
     }
-    size_t capacity() const
+    size_t shrink_to_fit()
     {
-        return chunks_.size() * chunk_capacity_;
+        return trim(0);
+    }
+private:
+    void push_free(storage_type* slot)
+    {
+        slot->next = free_list_;
+        free_list_ = slot;
+        ++free_count_;
+    }
+
+    void carve_all(pool_chunk& chunk)
+    {
+        while (!chunk.is_full())
+        {
+            push_free(chunk.acquire());
+            ++carved_;
+        }
     }
 private:
     const size_t chunk_capacity_ = 0u;
 private:
     std::vector<std::unique_ptr<pool_chunk>> chunks_;
-    std::stack<T*> free_list_;
+    storage_type* free_list_ = nullptr;
+    size_t free_count_ = 0;
+    size_t carved_ = 0;
 };
 
 template<typename T>
@@ -114,6 +253,8 @@ class RING_API object_pool final : protected object_pool_impl<T>
 {
 private:
     using impl_ = object_pool_impl<T>;
+public:
+    using value_type = T;
 public:
     object_pool(size_t chunk_capacity = impl_::default_chunk_capacity) :
         impl_(chunk_capacity) {}
@@ -140,46 +281,473 @@ public:
     {
         return impl_::capacity();
     }
+    // allocates and touches room for count objects up front
+    void reserve(size_t count)
+    {
+        impl_::reserve(count);
+    }
+    // returns fully free chunks to the system, keeping up to max_idle_chunks warm
+    size_t trim(size_t max_idle_chunks)
+    {
+        return impl_::trim(max_idle_chunks);
+    }
+    size_t shrink_to_fit()
+    {
+        return impl_::shrink_to_fit();
+    }
 };
 
+namespace detail
+{
+
+// fixed-size stack of free slots, moved whole between thread caches and the depot
+struct pool_magazine
+{
+    static constexpr uint32_t capacity = 64;
+
+    uint32_t index = 0;
+    uint32_t count = 0;
+    std::atomic<uint32_t> next{ 0 };
+    void* slots[capacity];
+};
+
+// magazines live in geometrically growing blocks so an index stays valid for
+// the pool's lifetime and the depot can use 32-bit index + 32-bit tag heads
+class pool_magazine_table
+{
+private:
+    static constexpr uint32_t first_block = 64;
+    static constexpr size_t max_blocks = 27;
+public:
+    pool_magazine_table() = default;
+    ~pool_magazine_table()
+    {
+        for (auto& block : blocks_)
+        {
+            delete[] block.load(std::memory_order_relaxed);
+        }
+    }
+private:
+    pool_magazine_table(const pool_magazine_table&) = delete;
+    pool_magazine_table& operator=(const pool_magazine_table&) = delete;
+public:
+    pool_magazine* at(uint32_t index) const
+    {
+        auto [block, offset] = locate(index);
+        return &blocks_[block].load(std::memory_order_acquire)[offset];
+    }
+
+    // callers serialize growth
+    pool_magazine* create()
+    {
+        uint32_t index = size_;
+        auto [block, offset] = locate(index);
+        if (block >= max_blocks)
+        {
+            throw ring::core::exception("object pool magazine table exhausted");
+        }
+        if (offset == 0)
+        {
+            blocks_[block].store(new pool_magazine[block == 0 ? first_block : first_block << (block - 1)],
+                std::memory_order_release);
+        }
+        auto* magazine = at(index);
+        magazine->index = index;
+        ++size_;
+        return magazine;
+    }
+private:
+    static std::pair<size_t, uint32_t> locate(uint32_t index)
+    {
+        if (index < first_block)
+        {
+            return { 0, index };
+        }
+        size_t block = std::bit_width(index) - std::bit_width(first_block) + 1;
+        return { block, index - (first_block << (block - 1)) };
+    }
+private:
+    std::array<std::atomic<pool_magazine*>, max_blocks> blocks_{};
+    uint32_t size_ = 0;
+};
+
+// Lets an exiting thread hand its cached magazines back to the pools it used.
+// The pool clears pool on destruction, so a thread outliving it skips the hook.
+struct pool_exit_hook
+{
+    std::mutex mutex;
+    void* pool = nullptr;
+    void (*flush)(void* pool, size_t thread) = nullptr;
+};
+
+class pool_thread_exit final
+{
+public:
+    pool_thread_exit() :
+        thread_(thread_index()) {}
+    ~pool_thread_exit()
+    {
+        for (auto& hook : hooks_)
+        {
+            std::lock_guard lock(hook->mutex);
+            if (hook->pool)
+            {
+                hook->flush(hook->pool, thread_);
+            }
+        }
+    }
+private:
+    pool_thread_exit(const pool_thread_exit&) = delete;
+    pool_thread_exit& operator=(const pool_thread_exit&) = delete;
+public:
+    void add(const std::shared_ptr<pool_exit_hook>& hook)
+    {
+        if (std::find(hooks_.begin(), hooks_.end(), hook) != hooks_.end())
+        {
+            return;
+        }
+        // hooks of destroyed pools are dropped here rather than piling up
+        std::erase_if(hooks_, [](const auto& entry)
+            {
+                std::lock_guard lock(entry->mutex);
+                return entry->pool == nullptr;
+            });
+        hooks_.push_back(hook);
+    }
+private:
+    const size_t thread_;
+    std::vector<std::shared_ptr<pool_exit_hook>> hooks_;
+};
+
+inline pool_thread_exit& pool_thread_hooks()
+{
+    static thread_local pool_thread_exit hooks;
+    return hooks;
+}
+
+// Treiber stack of magazines; the tag in the upper half of head defeats ABA
+class pool_magazine_stack
+{
+public:
+    void push(pool_magazine* magazine)
+    {
+        uint64_t head = head_->load(std::memory_order_relaxed);
+        uint64_t next = 0;
+        do
+        {
+            magazine->next.store(static_cast<uint32_t>(head), std::memory_order_relaxed);
+            next = ((head >> 32) + 1) << 32 | (magazine->index + 1);
+        } while (!head_->compare_exchange_weak(head, next, std::memory_order_release, std::memory_order_relaxed));
+    }
+
+    pool_magazine* pop(const pool_magazine_table& table)
+    {
+        uint64_t head = head_->load(std::memory_order_acquire);
+        while (static_cast<uint32_t>(head) != 0)
+        {
+            auto* magazine = table.at(static_cast<uint32_t>(head) - 1);
+            uint64_t next = ((head >> 32) + 1) << 32 | magazine->next.load(std::memory_order_relaxed);
+            if (head_->compare_exchange_weak(head, next, std::memory_order_acquire, std::memory_order_acquire))
+            {
+                return magazine;
+            }
+        }
+        return nullptr;
+    }
+private:
+    cache_aligned<std::atomic<uint64_t>> head_{ 0 };
+};
+
+} // namespace detail
+
+// Scalable pool: each thread keeps a loaded and a previous magazine of free
+// slots and trades whole magazines with a lock-free depot, so objects released
+// on one thread flow back to others in batches. Only carving fresh chunks takes
+// a lock. A thread's magazines go back to the depot when it exits. size() sums
+// per-thread counters and is approximate under contention.
 template<typename T>
-class RING_API object_pool_mt final : protected object_pool_impl<T>
+class RING_API object_pool_mt final
 {
 private:
-    using impl_ = object_pool_impl<T>;
+    static constexpr size_t default_chunk_capacity = 1024;
+    static constexpr size_t cache_count = 128;
+
+    struct storage_type
+    {
+        alignas(alignof(T)) std::byte data[sizeof(T)];
+    };
+
+    // threads whose index collides share a cache through its spin lock
+    struct alignas(detail::cache_line_size) thread_cache
+    {
+        std::atomic<bool> locked{ false };
+        detail::pool_magazine* loaded = nullptr;
+        detail::pool_magazine* previous = nullptr;
+        std::atomic<int64_t> outstanding{ 0 };
+        // thread_index() + 1 of the last thread that registered its exit hook here
+        size_t user = 0;
+    };
+
+    class cache_lock
+    {
+    public:
+        explicit cache_lock(thread_cache& cache) :
+            cache_(cache)
+        {
+            while (cache_.locked.exchange(true, std::memory_order_acquire))
+            {
+                while (cache_.locked.load(std::memory_order_relaxed))
+                {
+                    detail::cpu_relax();
+                }
+            }
+        }
+        ~cache_lock()
+        {
+            cache_.locked.store(false, std::memory_order_release);
+        }
+    private:
+        cache_lock(const cache_lock&) = delete;
+        cache_lock& operator=(const cache_lock&) = delete;
+    private:
+        thread_cache& cache_;
+    };
 public:
-    object_pool_mt(size_t chunk_capacity = impl_::default_chunk_capacity) :
-        impl_(chunk_capacity) {}
-    ~object_pool_mt() = default;
+    using value_type = T;
+public:
+    object_pool_mt(size_t chunk_capacity = default_chunk_capacity) :
+        chunk_capacity_(chunk_capacity ? chunk_capacity : default_chunk_capacity),
+        caches_(std::make_unique<thread_cache[]>(cache_count)),
+        exit_hook_(std::make_shared<detail::pool_exit_hook>())
+    {
+        exit_hook_->pool = this;
+        exit_hook_->flush = [](void* pool, size_t thread) { static_cast<object_pool_mt*>(pool)->flush(thread); };
+    }
+    ~object_pool_mt()
+    {
+        std::lock_guard lock(exit_hook_->mutex);
+        exit_hook_->pool = nullptr;
+    }
+private:
+    object_pool_mt(const object_pool_mt&) = delete;
+    object_pool_mt& operator=(const object_pool_mt&) = delete;
 public:
     template<typename... Args>
     T* acquire(Args&&... args)
     {
-        std::lock_guard lock(_mutex);
-        return impl_::acquire(std::forward<Args>(args)...);   
+        auto& cache = local_cache();
+        void* slot = nullptr;
+        {
+            cache_lock lock(cache);
+            slot = allocate(cache);
+            cache.outstanding.store(cache.outstanding.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        }
+        try
+        {
+            return new (slot) T(std::forward<Args>(args)...);
+        }
+        catch (...)
+        {
+            deallocate(slot);
+            throw;
+        }
     }
     void release(T *obj)
     {
-        std::lock_guard lock(_mutex);
-        return impl_::release(obj);
+        if (!obj)
+        {
+            return;
+        }
+        obj->~T();
+        deallocate(obj);
     }
     bool empty() const
     {
-        std::lock_guard lock(_mutex);
-        return impl_::empty();
+        return size() == 0;
     }
     size_t size() const
     {
-        std::lock_guard lock(_mutex);
-        return impl_::size();
+        int64_t total = 0;
+        for (size_t i = 0; i < cache_count; ++i)
+        {
+            total += caches_[i].outstanding.load(std::memory_order_relaxed);
+        }
+        return total > 0 ? static_cast<size_t>(total) : 0;
     }
     size_t capacity() const
     {
-        std::lock_guard lock(_mutex);
-        return impl_::capacity();
+        return capacity_->load(std::memory_order_relaxed);
+    }
+
+    // Carves chunks until count objects fit and hands the new slots to the
+    // depot in full magazines, touching each page on the way, so a growing
+    // pool doesn't allocate or fault mid-tick.
+    void reserve(size_t count)
+    {
+        std::lock_guard lock(mutex_);
+        if (capacity_->load(std::memory_order_relaxed) >= count)
+        {
+            return;
+        }
+        detail::pool_magazine* magazine = nullptr;
+        while (true)
+        {
+            if (chunks_.empty() || chunk_offset_ == chunk_capacity_)
+            {
+                if (capacity_->load(std::memory_order_relaxed) >= count)
+                {
+                    break;
+                }
+                add_chunk();
+            }
+            if (!magazine)
+            {
+                magazine = empty_.pop(magazines_);
+                magazine = magazine ? magazine : magazines_.create();
+            }
+            void* slot = chunks_.back().get() + chunk_offset_++ * sizeof(storage_type);
+            *static_cast<volatile std::byte*>(slot) = std::byte{ 0 };
+            magazine->slots[magazine->count++] = slot;
+            if (magazine->count == detail::pool_magazine::capacity)
+            {
+                full_.push(magazine);
+                magazine = nullptr;
+            }
+        }
+        if (magazine)
+        {
+            (magazine->count ? full_ : empty_).push(magazine);
+        }
+    }
+private:
+    thread_cache& local_cache()
+    {
+        return caches_[detail::thread_index() % cache_count];
     }
+
+    void deallocate(void* slot)
+    {
+        auto& cache = local_cache();
+        cache_lock lock(cache);
+        prepare(cache);
+        if (cache.loaded->count == detail::pool_magazine::capacity)
+        {
+            if (cache.previous->count == 0)
+            {
+                std::swap(cache.loaded, cache.previous);
+            }
+            else
+            {
+                full_.push(cache.previous);
+                cache.previous = cache.loaded;
+                cache.loaded = empty_magazine();
+            }
+        }
+        cache.loaded->slots[cache.loaded->count++] = slot;
+        cache.outstanding.store(cache.outstanding.load(std::memory_order_relaxed) - 1, std::memory_order_relaxed);
+    }
+
+    void* allocate(thread_cache& cache)
+    {
+        prepare(cache);
+        if (cache.loaded->count == 0)
+        {
+            if (cache.previous->count != 0)
+            {
+                std::swap(cache.loaded, cache.previous);
+            }
+            else if (auto* full = full_.pop(magazines_))
+            {
+                empty_.push(cache.loaded);
+                cache.loaded = full;
+            }
+            else
+            {
+                refill(*cache.loaded);
+            }
+        }
+        return cache.loaded->slots[--cache.loaded->count];
+    }
+
+    void prepare(thread_cache& cache)
+    {
+        if (cache.user != detail::thread_index() + 1) [[unlikely]]
+        {
+            cache.user = detail::thread_index() + 1;
+            detail::pool_thread_hooks().add(exit_hook_);
+        }
+        if (!cache.loaded)
+        {
+            cache.loaded = empty_magazine();
+            cache.previous = empty_magazine();
+        }
+    }
+
+    // runs when thread exits; threads sharing its cache simply reload
+    void flush(size_t thread)
+    {
+        auto& cache = caches_[thread % cache_count];
+        cache_lock lock(cache);
+        for (auto* magazine : { cache.loaded, cache.previous })
+        {
+            if (magazine)
+            {
+                (magazine->count ? full_ : empty_).push(magazine);
+            }
+        }
+        cache.loaded = nullptr;
+        cache.previous = nullptr;
+        cache.user = 0;
+    }
+
+    detail::pool_magazine* empty_magazine()
+    {
+        if (auto* magazine = empty_.pop(magazines_))
+        {
+            return magazine;
+        }
+        std::lock_guard lock(mutex_);
+        return magazines_.create();
+    }
+
+    // slow path: carve fresh slots out of the current chunk, opening a new chunk
+    // only when nothing was carved so small chunks of big objects stay small
+    void refill(detail::pool_magazine& magazine)
+    {
+        std::lock_guard lock(mutex_);
+        while (magazine.count < detail::pool_magazine::capacity)
+        {
+            if (chunks_.empty() || chunk_offset_ == chunk_capacity_)
+            {
+                if (magazine.count != 0)
+                {
+                    break;
+                }
+                add_chunk();
+            }
+            magazine.slots[magazine.count++] = chunks_.back().get() + chunk_offset_++ * sizeof(storage_type);
+        }
+    }
+
+    // called with mutex_ held
+    void add_chunk()
+    {
+        chunks_.emplace_back(make_unique_buffer_aligned(chunk_capacity_ * sizeof(storage_type), alignof(storage_type)));
+        chunk_offset_ = 0;
+        capacity_->fetch_add(chunk_capacity_, std::memory_order_relaxed);
+    }
+private:
+    const size_t chunk_capacity_;
+    std::unique_ptr<thread_cache[]> caches_;
+    detail::pool_magazine_stack full_;
+    detail::pool_magazine_stack empty_;
+    cache_aligned<std::atomic<size_t>> capacity_{ 0 };
+    std::shared_ptr<detail::pool_exit_hook> exit_hook_;
 private:
-    std::mutex _mutex;
+    std::mutex mutex_;
+    detail::pool_magazine_table magazines_;
+    std::vector<buffer_aligned> chunks_;
+    size_t chunk_offset_ = 0;
 };
 
 } // namespace ring::core
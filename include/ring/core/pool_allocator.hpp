@@ -0,0 +1,224 @@
+#ifndef RING_CORE_POOL_ALLOCATOR_HPP_
+#define RING_CORE_POOL_ALLOCATOR_HPP_
+
+#include <cstddef>
+#include <memory>
+#include <memory_resource>
+#include <mutex>
+#include <new>
+#include <utility>
+
+#include "ring/core/export.hpp"
+#include "ring/core/object_pool.hpp"
+
+namespace ring::core
+{
+
+// returns the object to the pool it came from instead of deleting it
+template <typename Pool>
+class pool_deleter
+{
+public:
+    pool_deleter() noexcept = default;
+    explicit pool_deleter(Pool& pool) noexcept :
+        pool_(&pool) {}
+public:
+    void operator()(typename Pool::value_type* obj) const
+    {
+        pool_->release(obj);
+    }
+    Pool* pool() const noexcept
+    {
+        return pool_;
+    }
+private:
+    Pool* pool_ = nullptr;
+};
+
+template <typename T, typename Pool = object_pool_mt<T>>
+using pool_unique_ptr = std::unique_ptr<T, pool_deleter<Pool>>;
+
+template <typename Pool, typename... Args>
+pool_unique_ptr<typename Pool::value_type, Pool> make_pool_unique(Pool& pool, Args&&... args)
+{
+    return pool_unique_ptr<typename Pool::value_type, Pool>(pool.acquire(std::forward<Args>(args)...),
+        pool_deleter<Pool>(pool));
+}
+
+namespace detail
+{
+
+// uninitialised storage for one object of a type known only after rebinding
+template <size_t Size, size_t Alignment>
+struct raw_block
+{
+    raw_block() {}
+
+    alignas(Alignment) std::byte data[Size];
+};
+
+// Shared by every copy and rebind of one pool_allocator. The first type
+// allocated one at a time fixes the slot layout; with allocate_shared that is
+// the control block holding the object. Control blocks keep a copy of the
+// allocator, so the pool lives until the last shared_ptr is gone.
+class pool_allocator_state
+{
+public:
+    explicit pool_allocator_state(size_t chunk_capacity) :
+        chunk_capacity_(chunk_capacity) {}
+    ~pool_allocator_state()
+    {
+        if (pool_)
+        {
+            destroy_(pool_);
+        }
+    }
+private:
+    pool_allocator_state(const pool_allocator_state&) = delete;
+    pool_allocator_state& operator=(const pool_allocator_state&) = delete;
+public:
+    template <typename U>
+    bool pooled()
+    {
+        std::call_once(once_, [this]()
+            {
+                using pool_type = object_pool_mt<raw_block<sizeof(U), alignof(U)>>;
+                pool_ = new pool_type(chunk_capacity_);
+                acquire_ = [](void* pool) -> void* { return static_cast<pool_type*>(pool)->acquire()->data; };
+                release_ = [](void* pool, void* slot)
+                    {
+                        static_cast<pool_type*>(pool)->release(static_cast<raw_block<sizeof(U), alignof(U)>*>(slot));
+                    };
+                destroy_ = [](void* pool) { delete static_cast<pool_type*>(pool); };
+                slot_size_ = sizeof(U);
+                slot_alignment_ = alignof(U);
+            });
+        return sizeof(U) <= slot_size_ && alignof(U) <= slot_alignment_;
+    }
+
+    void* acquire()
+    {
+        return acquire_(pool_);
+    }
+
+    void release(void* slot)
+    {
+        release_(pool_, slot);
+    }
+private:
+    const size_t chunk_capacity_;
+    std::once_flag once_;
+    void* pool_ = nullptr;
+    void* (*acquire_)(void*) = nullptr;
+    void (*release_)(void*, void*) = nullptr;
+    void (*destroy_)(void*) = nullptr;
+    size_t slot_size_ = 0;
+    size_t slot_alignment_ = 0;
+};
+
+} // namespace detail
+
+// Allocator for std::allocate_shared: the control block and the object share
+// one slot of an object_pool_mt. Arrays and rebound types that do not fit the
+// slot fall through to aligned operator new.
+template <typename T>
+class pool_allocator
+{
+public:
+    using value_type = T;
+
+    template <typename U>
+    friend class pool_allocator;
+public:
+    explicit pool_allocator(size_t chunk_capacity = 1024) :
+        state_(std::make_shared<detail::pool_allocator_state>(chunk_capacity)) {}
+    template <typename U>
+    pool_allocator(const pool_allocator<U>& other) noexcept :
+        state_(other.state_) {}
+public:
+    T* allocate(size_t count)
+    {
+        if (count == 1 && state_->template pooled<T>())
+        {
+            return static_cast<T*>(state_->acquire());
+        }
+        return static_cast<T*>(::operator new(count * sizeof(T), std::align_val_t{ alignof(T) }));
+    }
+
+    void deallocate(T* ptr, size_t count)
+    {
+        if (count == 1 && state_->template pooled<T>())
+        {
+            state_->release(ptr);
+            return;
+        }
+        ::operator delete(ptr, std::align_val_t{ alignof(T) });
+    }
+
+    template <typename U>
+    bool operator==(const pool_allocator<U>& other) const noexcept
+    {
+        return state_ == other.state_;
+    }
+private:
+    std::shared_ptr<detail::pool_allocator_state> state_;
+};
+
+template <typename T, typename... Args>
+std::shared_ptr<T> make_pool_shared(const pool_allocator<T>& allocator, Args&&... args)
+{
+    return std::allocate_shared<T>(allocator, std::forward<Args>(args)...);
+}
+
+// pmr resource over an object_pool_mt of fixed-size blocks, for node-based
+// pmr containers (list, map, unordered_map) whose nodes fit BlockSize.
+// Anything larger or more aligned goes to the upstream resource.
+template <size_t BlockSize, size_t Alignment = alignof(std::max_align_t)>
+class RING_API pool_memory_resource final : public std::pmr::memory_resource
+{
+private:
+    using block_type = detail::raw_block<BlockSize, Alignment>;
+public:
+    explicit pool_memory_resource(size_t chunk_capacity = 1024,
+        std::pmr::memory_resource* upstream = std::pmr::new_delete_resource()) :
+        pool_(chunk_capacity),
+        upstream_(upstream) {}
+public:
+    size_t size() const
+    {
+        return pool_.size();
+    }
+    size_t capacity() const
+    {
+        return pool_.capacity();
+    }
+private:
+    void* do_allocate(size_t bytes, size_t alignment) override
+    {
+        if (bytes > BlockSize || alignment > Alignment)
+        {
+            return upstream_->allocate(bytes, alignment);
+        }
+        return pool_.acquire()->data;
+    }
+    void do_deallocate(void* ptr, size_t bytes, size_t alignment) override
+    {
+        if (bytes > BlockSize || alignment > Alignment)
+        {
+            upstream_->deallocate(ptr, bytes, alignment);
+            return;
+        }
+        pool_.release(static_cast<block_type*>(ptr));
+    }
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override
+    {
+        return this == &other;
+    }
+private:
+    object_pool_mt<block_type> pool_;
+    std::pmr::memory_resource* upstream_;
+};
+
+} // namespace ring::core
+
+#endif // RING_CORE_POOL_ALLOCATOR_HPP_
@@ -0,0 +1,261 @@
+#ifndef RING_CORE_QUEUE_STATS_HPP_
+#define RING_CORE_QUEUE_STATS_HPP_
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstdint>
+#include <string>
+
+#include "ring/core/cache_line.hpp"
+#include "ring/core/export.hpp"
+
+namespace ring::core
+{
+
+struct queue_stats_snapshot
+{
+    static constexpr size_t histogram_buckets = 16;
+
+    uint64_t pushes = 0;
+    uint64_t pops = 0;
+    // Rejections while the queue looked neither full nor empty when checked
+    // right after, mostly a slot another thread is still filling or draining.
+    // Inferred after the fact; contention itself is counted at the CAS below.
+    uint64_t push_busy_rejections = 0;
+    uint64_t pop_busy_rejections = 0;
+    // compare-exchanges on the shared tail (push) or head (pop), and how many
+    // lost to another thread or failed spuriously and had to be retried
+    uint64_t push_cas = 0;
+    uint64_t push_cas_failures = 0;
+    uint64_t pop_cas = 0;
+    uint64_t pop_cas_failures = 0;
+    uint64_t full_rejections = 0;
+    uint64_t empty_rejections = 0;
+    // spin, yield or park iterations inside blocking push/pop
+    uint64_t push_waits = 0;
+    uint64_t pop_waits = 0;
+    size_t high_water = 0;
+    // bucket i counts samples with an occupancy in [2^(i-1), 2^i), the last one is open ended
+    std::array<uint64_t, histogram_buckets> occupancy{};
+};
+
+// one line, meant for periodic dumps through the logging module
+inline std::string to_string(const queue_stats_snapshot& stats)
+{
+    std::string result;
+    result += "pushes=" + std::to_string(stats.pushes);
+    result += " pops=" + std::to_string(stats.pops);
+    result += " full=" + std::to_string(stats.full_rejections);
+    result += " empty=" + std::to_string(stats.empty_rejections);
+    result += " push_busy=" + std::to_string(stats.push_busy_rejections);
+    result += " pop_busy=" + std::to_string(stats.pop_busy_rejections);
+    result += " push_cas=" + std::to_string(stats.push_cas);
+    result += " push_cas_failed=" + std::to_string(stats.push_cas_failures);
+    result += " pop_cas=" + std::to_string(stats.pop_cas);
+    result += " pop_cas_failed=" + std::to_string(stats.pop_cas_failures);
+    result += " push_waits=" + std::to_string(stats.push_waits);
+    result += " pop_waits=" + std::to_string(stats.pop_waits);
+    result += " high_water=" + std::to_string(stats.high_water);
+    result += " occupancy=[";
+    for (size_t i = 0; i < stats.occupancy.size(); ++i)
+    {
+        result += (i ? "," : "") + std::to_string(stats.occupancy[i]);
+    }
+    result += "]";
+    return result;
+}
+
+// compiled out: every hook is an empty inline function
+class no_queue_stats final
+{
+public:
+    static constexpr bool enabled = false;
+public:
+    void record_push(size_t, size_t) noexcept {}
+    void record_pop(size_t) noexcept {}
+    void record_push_failure(bool) noexcept {}
+    void record_pop_failure(bool) noexcept {}
+    void record_push_cas(bool) noexcept {}
+    void record_pop_cas(bool) noexcept {}
+    void record_push_waits(uint64_t) noexcept {}
+    void record_pop_waits(uint64_t) noexcept {}
+    queue_stats_snapshot snapshot() const noexcept
+    {
+        return {};
+    }
+    void reset() noexcept {}
+};
+
+// counters are sharded per thread so that instrumented queues do not add a
+// shared cache line to the hot path; snapshot() folds the shards together
+class queue_stats final
+{
+public:
+    static constexpr bool enabled = true;
+    static constexpr size_t shard_count = 16;
+    static constexpr uint64_t sample_interval = 64;
+private:
+    struct alignas(detail::cache_line_size) shard
+    {
+        std::atomic<uint64_t> pushes{ 0 };
+        std::atomic<uint64_t> pops{ 0 };
+        std::atomic<uint64_t> push_busy_rejections{ 0 };
+        std::atomic<uint64_t> pop_busy_rejections{ 0 };
+        std::atomic<uint64_t> push_cas{ 0 };
+        std::atomic<uint64_t> push_cas_failures{ 0 };
+        std::atomic<uint64_t> pop_cas{ 0 };
+        std::atomic<uint64_t> pop_cas_failures{ 0 };
+        std::atomic<uint64_t> full_rejections{ 0 };
+        std::atomic<uint64_t> empty_rejections{ 0 };
+        std::atomic<uint64_t> push_waits{ 0 };
+        std::atomic<uint64_t> pop_waits{ 0 };
+        std::array<std::atomic<uint64_t>, queue_stats_snapshot::histogram_buckets> occupancy{};
+        // highest occupancy seen by the threads on this shard
+        std::atomic<size_t> high_water{ 0 };
+    };
+public:
+    queue_stats() = default;
+    ~queue_stats() = default;
+private:
+    queue_stats(const queue_stats&) = delete;
+    queue_stats& operator=(const queue_stats&) = delete;
+public:
+    // count is the number of elements pushed, size the occupancy right after
+    void record_push(size_t count, size_t size) noexcept
+    {
+        auto& s = local();
+        uint64_t before = s.pushes.fetch_add(count, std::memory_order_relaxed);
+        size_t high = s.high_water.load(std::memory_order_relaxed);
+        while (size > high && !s.high_water.compare_exchange_weak(high, size, std::memory_order_relaxed))
+        {
+        }
+        if ((before + count) / sample_interval != before / sample_interval)
+        {
+            size_t bucket = std::min<size_t>(std::bit_width(size), queue_stats_snapshot::histogram_buckets - 1);
+            s.occupancy[bucket].fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    void record_pop(size_t count) noexcept
+    {
+        local().pops.fetch_add(count, std::memory_order_relaxed);
+    }
+
+    void record_push_failure(bool full) noexcept
+    {
+        auto& s = local();
+        (full ? s.full_rejections : s.push_busy_rejections).fetch_add(1, std::memory_order_relaxed);
+    }
+
+    void record_pop_failure(bool empty) noexcept
+    {
+        auto& s = local();
+        (empty ? s.empty_rejections : s.pop_busy_rejections).fetch_add(1, std::memory_order_relaxed);
+    }
+
+    // called by the backends after each compare-exchange on their shared cursor
+    void record_push_cas(bool failed) noexcept
+    {
+        auto& s = local();
+        s.push_cas.fetch_add(1, std::memory_order_relaxed);
+        if (failed)
+        {
+            s.push_cas_failures.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    void record_pop_cas(bool failed) noexcept
+    {
+        auto& s = local();
+        s.pop_cas.fetch_add(1, std::memory_order_relaxed);
+        if (failed)
+        {
+            s.pop_cas_failures.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    void record_push_waits(uint64_t waits) noexcept
+    {
+        if (waits)
+        {
+            local().push_waits.fetch_add(waits, std::memory_order_relaxed);
+        }
+    }
+
+    void record_pop_waits(uint64_t waits) noexcept
+    {
+        if (waits)
+        {
+            local().pop_waits.fetch_add(waits, std::memory_order_relaxed);
+        }
+    }
+
+    queue_stats_snapshot snapshot() const noexcept
+    {
+        queue_stats_snapshot result;
+        for (const auto& s : shards_)
+        {
+            result.pushes += s.pushes.load(std::memory_order_relaxed);
+            result.pops += s.pops.load(std::memory_order_relaxed);
+            result.push_busy_rejections += s.push_busy_rejections.load(std::memory_order_relaxed);
+            result.pop_busy_rejections += s.pop_busy_rejections.load(std::memory_order_relaxed);
+            result.push_cas += s.push_cas.load(std::memory_order_relaxed);
+            result.push_cas_failures += s.push_cas_failures.load(std::memory_order_relaxed);
+            result.pop_cas += s.pop_cas.load(std::memory_order_relaxed);
+            result.pop_cas_failures += s.pop_cas_failures.load(std::memory_order_relaxed);
+            result.full_rejections += s.full_rejections.load(std::memory_order_relaxed);
+            result.empty_rejections += s.empty_rejections.load(std::memory_order_relaxed);
+            result.push_waits += s.push_waits.load(std::memory_order_relaxed);
+            result.pop_waits += s.pop_waits.load(std::memory_order_relaxed);
+            for (size_t i = 0; i < result.occupancy.size(); ++i)
+            {
+                result.occupancy[i] += s.occupancy[i].load(std::memory_order_relaxed);
+            }
+            result.high_water = std::max(result.high_water, s.high_water.load(std::memory_order_relaxed));
+        }
+        return result;
+    }
+
+    void reset() noexcept
+    {
+        for (auto& s : shards_)
+        {
+            s.pushes.store(0, std::memory_order_relaxed);
+            s.pops.store(0, std::memory_order_relaxed);
+            s.push_busy_rejections.store(0, std::memory_order_relaxed);
+            s.pop_busy_rejections.store(0, std::memory_order_relaxed);
+            s.push_cas.store(0, std::memory_order_relaxed);
+            s.push_cas_failures.store(0, std::memory_order_relaxed);
+            s.pop_cas.store(0, std::memory_order_relaxed);
+            s.pop_cas_failures.store(0, std::memory_order_relaxed);
+            s.full_rejections.store(0, std::memory_order_relaxed);
+            s.empty_rejections.store(0, std::memory_order_relaxed);
+            s.push_waits.store(0, std::memory_order_relaxed);
+            s.pop_waits.store(0, std::memory_order_relaxed);
+            for (auto& bucket : s.occupancy)
+            {
+                bucket.store(0, std::memory_order_relaxed);
+            }
+            s.high_water.store(0, std::memory_order_relaxed);
+        }
+    }
+private:
+    shard& local() noexcept
+    {
+        return shards_[detail::thread_index() % shard_count];
+    }
+private:
+    std::array<shard, shard_count> shards_;
+};
+
+#ifdef RING_QUEUE_STATS
+using default_queue_stats = queue_stats;
+#else
+using default_queue_stats = no_queue_stats;
+#endif
+
+} // namespace ring::core
+
+#endif // RING_CORE_QUEUE_STATS_HPP_
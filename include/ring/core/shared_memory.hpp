@@ -0,0 +1,65 @@
+#ifndef RING_CORE_SHARED_MEMORY_HPP_
+#define RING_CORE_SHARED_MEMORY_HPP_
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+#include "ring/core/export.hpp"
+
+namespace ring::core
+{
+
+enum class shm_mode
+{
+    create,
+    attach
+};
+
+// A named POSIX shared-memory mapping. The creating side owns the name and
+// unlinks it on destruction; attaching waits for the creator to size it.
+class RING_API shared_memory_region final
+{
+public:
+    shared_memory_region(std::string_view name, shm_mode mode, size_t size = 0,
+        std::chrono::milliseconds timeout = std::chrono::seconds(1));
+    ~shared_memory_region();
+private:
+    shared_memory_region(const shared_memory_region&) = delete;
+    shared_memory_region& operator=(const shared_memory_region&) = delete;
+public:
+    std::byte* data() const
+    {
+        return data_;
+    }
+    size_t size() const
+    {
+        return size_;
+    }
+    const std::string& name() const
+    {
+        return name_;
+    }
+    bool owner() const
+    {
+        return owner_;
+    }
+public:
+    // removes a name left behind by a crashed creator
+    static bool remove(std::string_view name);
+    // CLOCK_MONOTONIC nanoseconds, comparable across processes on one host
+    static int64_t monotonic_now();
+    static int32_t process_id();
+    static bool process_alive(int32_t pid);
+private:
+    std::string name_;
+    std::byte* data_ = nullptr;
+    size_t size_ = 0;
+    bool owner_ = false;
+};
+
+} // namespace ring::core
+
+#endif // RING_CORE_SHARED_MEMORY_HPP_
@@ -0,0 +1,492 @@
+#ifndef RING_CORE_SHARED_QUEUE_HPP_
+#define RING_CORE_SHARED_QUEUE_HPP_
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <string_view>
+#include <thread>
+#include <type_traits>
+
+#include "ring/core/cache_line.hpp"
+#include "ring/core/exception.hpp"
+#include "ring/core/export.hpp"
+#include "ring/core/lockfree_queue.hpp"
+#include "ring/core/shared_memory.hpp"
+#include "ring/core/wait_strategy.hpp"
+
+namespace ring::core
+{
+
+enum class shm_role
+{
+    producer,
+    consumer
+};
+
+namespace detail
+{
+
+static_assert(std::atomic<size_t>::is_always_lock_free && std::atomic<int64_t>::is_always_lock_free,
+    "shared queues need address-free lock-free atomics");
+
+// one attached process: its pid, last heartbeat and, for mpsc producers, the
+// slots it has claimed but not published yet (claim_begin == claim_end when none)
+struct alignas(cache_line_size) shared_queue_peer
+{
+    std::atomic<int32_t> pid{ 0 };
+    std::atomic<int64_t> heartbeat{ 0 };
+    std::atomic<size_t> claim_begin{ 0 };
+    std::atomic<size_t> claim_end{ 0 };
+};
+
+// sits at offset 0 of the mapping; slots and sequences follow on their own cache lines
+struct shared_queue_header
+{
+    static constexpr uint64_t magic_value = 0x52494e4753514831; // "RINGSQH1"
+    static constexpr uint32_t current_version = 2;
+    static constexpr uint32_t state_ready = 1;
+    static constexpr size_t max_producers = 16;
+
+    shared_queue_header(uint64_t capacity, uint64_t slot_size, uint64_t slot_alignment, bool multi_producer,
+        uint64_t layout_tag) :
+        capacity(capacity),
+        slot_size(slot_size),
+        slot_alignment(slot_alignment),
+        multi_producer(multi_producer ? 1 : 0),
+        layout_tag(layout_tag) {}
+
+    std::atomic<uint32_t> state{ 0 };
+    const uint32_t version = current_version;
+    const uint64_t magic = magic_value;
+    const uint64_t header_size = sizeof(shared_queue_header);
+    const uint64_t capacity;
+    const uint64_t slot_size;
+    const uint64_t slot_alignment;
+    const uint64_t multi_producer;
+    const uint64_t layout_tag;
+    shared_queue_peer consumer;
+    shared_queue_peer producers[max_producers];
+    cache_aligned<std::atomic<size_t>> head{ 0 };
+    cache_aligned<std::atomic<size_t>> tail{ 0 };
+    cache_aligned<event_count> not_empty{ true };
+    cache_aligned<event_count> not_full{ true };
+};
+
+inline constexpr size_t align_up(size_t value, size_t alignment)
+{
+    return (value + alignment - 1) / alignment * alignment;
+}
+
+// memory_block whose cursors, slots and sequences live in a shared mapping
+template <typename T, bool WithSequences>
+class shared_memory_block
+{
+public:
+    static constexpr size_t data_offset = align_up(sizeof(shared_queue_header), std::max(cache_line_size, alignof(T)));
+
+    static constexpr size_t sequences_offset(size_t capacity)
+    {
+        return align_up(data_offset + capacity * sizeof(T), cache_line_size);
+    }
+
+    static constexpr size_t mapping_size(size_t capacity)
+    {
+        return sequences_offset(capacity) + (WithSequences ? capacity * sizeof(std::atomic<size_t>) : 0);
+    }
+public:
+    explicit shared_memory_block(std::byte* base) :
+        capacity(reinterpret_cast<shared_queue_header*>(base)->capacity),
+        head(reinterpret_cast<shared_queue_header*>(base)->head),
+        tail(reinterpret_cast<shared_queue_header*>(base)->tail),
+        data_(base + data_offset),
+        sequences_(reinterpret_cast<std::atomic<size_t>*>(base + sequences_offset(capacity))) {}
+public:
+    T& operator[](size_t i)
+    {
+        return *reinterpret_cast<T*>(&data_[i * sizeof(T)]);
+    }
+    std::atomic<size_t>& sequence(size_t i)
+    {
+        return sequences_[i];
+    }
+    size_t index(size_t pos) const
+    {
+        return pos % capacity;
+    }
+public:
+    static constexpr bool contiguous = true;
+    const size_t capacity;
+    cache_aligned<std::atomic<size_t>>& head;
+    cache_aligned<std::atomic<size_t>>& tail;
+private:
+    std::byte* data_;
+    std::atomic<size_t>* sequences_;
+};
+
+} // namespace detail
+
+// SPSC/MPSC queue between processes on one host. Either side may create the
+// mapping; the other attaches, and both sides check magic, version, slot
+// layout and the caller's layout_tag before use. Each process takes its own
+// entry in the header (one consumer, up to max_producers producers) and
+// publishes a heartbeat there so the other side can detect a crash.
+template <typename T, bool MultiProducer>
+class RING_API basic_shared_queue final
+{
+    static_assert(std::is_trivially_copyable_v<T>, "shared queue messages must be trivially copyable");
+private:
+    using block_type = detail::shared_memory_block<T, MultiProducer>;
+    using queue_type = std::conditional_t<MultiProducer,
+        detail::basic_mpsc_queue<T, block_type>, detail::basic_spsc_queue<T, block_type>>;
+    static constexpr uint32_t spin_limit = 64;
+public:
+    basic_shared_queue(std::string_view name, shm_mode mode, shm_role role, size_t capacity = 0,
+        uint64_t layout_tag = 0, std::chrono::milliseconds timeout = std::chrono::seconds(1)) :
+        region_(name, mode, mode == shm_mode::create ? block_type::mapping_size(capacity) : 0, timeout),
+        header_(handshake(region_, mode, capacity, layout_tag, timeout)),
+        role_(role),
+        peer_(attach_peer(*header_, role)),
+        queue_(region_.data())
+    {
+        heartbeat();
+    }
+    ~basic_shared_queue()
+    {
+        peer_->pid.store(0, std::memory_order_release);
+    }
+private:
+    basic_shared_queue(const basic_shared_queue&) = delete;
+    basic_shared_queue& operator=(const basic_shared_queue&) = delete;
+public:
+    bool try_push(const T& value)
+    {
+        auto range = reserve(1);
+        if (range.empty())
+        {
+            return false;
+        }
+        range[0] = value;
+        commit(range);
+        return true;
+    }
+
+    bool try_pop(T& result)
+    {
+        if (!queue_.try_pop(result))
+        {
+            return false;
+        }
+        header_->not_full->notify_all();
+        return true;
+    }
+
+    // Claims up to count slots to fill in place. The whole range must be
+    // committed; if this process dies first, the consumer has to skip it
+    // with recover_abandoned().
+    slot_range<T> reserve(size_t count)
+    {
+        auto range = queue_.reserve(count);
+        if constexpr (MultiProducer)
+        {
+            if (!range.empty())
+            {
+                peer_->claim_begin.store(range.position(), std::memory_order_relaxed);
+                peer_->claim_end.store(range.position() + range.size(), std::memory_order_relaxed);
+            }
+        }
+        return range;
+    }
+
+    void commit(const slot_range<T>& range)
+    {
+        queue_.commit(range);
+        if constexpr (MultiProducer)
+        {
+            peer_->claim_begin.store(range.position() + range.size(), std::memory_order_relaxed);
+        }
+        header_->not_empty->notify_one();
+    }
+
+    template <typename InputIt>
+    size_t try_push_batch(InputIt first, InputIt last)
+    {
+        auto range = reserve(std::distance(first, last));
+        if (range.empty())
+        {
+            return 0;
+        }
+        for (size_t i = 0; i < range.size(); ++i, ++first)
+        {
+            range[i] = *first;
+        }
+        commit(range);
+        return range.size();
+    }
+
+    template <typename OutputIt>
+    size_t try_pop_batch(OutputIt first, size_t max_count)
+    {
+        size_t popped = queue_.try_pop_batch(first, max_count);
+        if (popped)
+        {
+            header_->not_full->notify_all();
+        }
+        return popped;
+    }
+
+    template <typename Rep, typename Period>
+    bool push_for(const T& value, const std::chrono::duration<Rep, Period>& timeout)
+    {
+        return wait_until(*header_->not_full, [&]() { return try_push(value); },
+            std::chrono::steady_clock::now() + timeout);
+    }
+
+    template <typename Rep, typename Period>
+    bool pop_for(T& result, const std::chrono::duration<Rep, Period>& timeout)
+    {
+        return wait_until(*header_->not_empty, [&]() { return try_pop(result); },
+            std::chrono::steady_clock::now() + timeout);
+    }
+
+    // publishes this side's liveness; call it from the owning loop's tick
+    void heartbeat()
+    {
+        peer_->heartbeat.store(shared_memory_region::monotonic_now(), std::memory_order_relaxed);
+    }
+
+    // For a producer, whether the consumer is alive; for the consumer, whether
+    // any producer is. A peer is gone once its process is or it missed
+    // heartbeats for longer than timeout.
+    bool peer_alive(std::chrono::nanoseconds timeout) const
+    {
+        if (role_ == shm_role::producer)
+        {
+            return alive(header_->consumer, timeout);
+        }
+        return std::any_of(std::begin(header_->producers), std::end(header_->producers),
+            [&](const auto& peer) { return alive(peer, timeout); });
+    }
+
+    // Consumer side of an mpsc queue. A producer that dies between claiming
+    // slots and publishing them stalls the consumer at the first of them.
+    // When the head slot belongs to a dead producer's claim, the rest of that
+    // claim is skipped and the number of skipped slots returned. A head slot
+    // that stays unpublished for longer than stall_timeout with no recorded
+    // owner means a producer died inside the claim itself; that cannot be
+    // repaired safely and throws.
+    size_t recover_abandoned(std::chrono::nanoseconds stall_timeout)
+        requires MultiProducer
+    {
+        block_type block(region_.data());
+        size_t head = block.head->load(std::memory_order_relaxed);
+        size_t tail = block.tail->load(std::memory_order_acquire);
+        if (head == tail || block.sequence(block.index(head)).load(std::memory_order_acquire) == head + 1)
+        {
+            stalled_since_ = 0;
+            return 0;
+        }
+        for (auto& peer : header_->producers)
+        {
+            size_t begin = peer.claim_begin.load(std::memory_order_relaxed);
+            size_t end = peer.claim_end.load(std::memory_order_relaxed);
+            int32_t pid = peer.pid.load(std::memory_order_acquire);
+            if (begin <= head && head < end)
+            {
+                if (pid != 0 && shared_memory_region::process_alive(pid))
+                {
+                    stalled_since_ = 0;
+                    return 0;
+                }
+                for (size_t pos = head; pos < end; ++pos)
+                {
+                    block.sequence(block.index(pos)).store(pos + block.capacity, std::memory_order_release);
+                }
+                block.head->store(end, std::memory_order_release);
+                peer.claim_begin.store(end, std::memory_order_relaxed);
+                peer.pid.store(0, std::memory_order_release);
+                stalled_since_ = 0;
+                header_->not_full->notify_all();
+                return end - head;
+            }
+        }
+        int64_t now = shared_memory_region::monotonic_now();
+        if (stalled_head_ != head || stalled_since_ == 0)
+        {
+            stalled_head_ = head;
+            stalled_since_ = now;
+        }
+        else if (now - stalled_since_ > stall_timeout.count())
+        {
+            throw ring::core::exception("shared queue slot was abandoned by a producer that died while claiming it");
+        }
+        return 0;
+    }
+
+    size_t size() const
+    {
+        return queue_.size();
+    }
+
+    size_t capacity() const
+    {
+        return queue_.capacity();
+    }
+
+    bool empty() const
+    {
+        return queue_.empty();
+    }
+
+    const shared_memory_region& region() const
+    {
+        return region_;
+    }
+private:
+    static detail::shared_queue_header* handshake(shared_memory_region& region, shm_mode mode, size_t capacity,
+        uint64_t layout_tag, std::chrono::milliseconds timeout)
+    {
+        if (mode == shm_mode::create)
+        {
+            if (capacity == 0)
+            {
+                throw ring::core::exception("shared queue capacity must not be zero");
+            }
+            auto* header = new (region.data()) detail::shared_queue_header(
+                capacity, sizeof(T), alignof(T), MultiProducer, layout_tag);
+            if constexpr (MultiProducer)
+            {
+                auto* sequences = reinterpret_cast<std::atomic<size_t>*>(
+                    region.data() + block_type::sequences_offset(capacity));
+                for (size_t i = 0; i < capacity; ++i)
+                {
+                    new (&sequences[i]) std::atomic<size_t>(i);
+                }
+            }
+            header->state.store(detail::shared_queue_header::state_ready, std::memory_order_release);
+            return header;
+        }
+
+        if (region.size() < sizeof(detail::shared_queue_header))
+        {
+            throw ring::core::exception("shared queue mapping is too small");
+        }
+        auto* header = std::launder(reinterpret_cast<detail::shared_queue_header*>(region.data()));
+        auto deadline = std::chrono::steady_clock::now() + timeout;
+        while (header->state.load(std::memory_order_acquire) != detail::shared_queue_header::state_ready)
+        {
+            if (std::chrono::steady_clock::now() >= deadline)
+            {
+                throw ring::core::exception("shared queue was never initialized by its creator");
+            }
+            std::this_thread::yield();
+        }
+        if (header->magic != detail::shared_queue_header::magic_value ||
+            header->version != detail::shared_queue_header::current_version ||
+            header->header_size != sizeof(detail::shared_queue_header))
+        {
+            throw ring::core::exception("shared queue version mismatch");
+        }
+        if (header->slot_size != sizeof(T) || header->slot_alignment != alignof(T) ||
+            header->multi_producer != (MultiProducer ? 1u : 0u) || header->layout_tag != layout_tag ||
+            (capacity != 0 && header->capacity != capacity) ||
+            region.size() < block_type::mapping_size(header->capacity))
+        {
+            throw ring::core::exception("shared queue layout mismatch");
+        }
+        return header;
+    }
+
+    // Each process takes a free entry, or one left by a dead process without
+    // an open claim; entries with an open claim wait for recover_abandoned().
+    // The consumer side is single-threaded, so a second live consumer throws.
+    static detail::shared_queue_peer* attach_peer(detail::shared_queue_header& header, shm_role role)
+    {
+        int32_t self = shared_memory_region::process_id();
+        if (role == shm_role::consumer)
+        {
+            if (!take_entry(header.consumer, self))
+            {
+                throw ring::core::exception("shared queue already has a consumer");
+            }
+            return &header.consumer;
+        }
+        size_t limit = MultiProducer ? detail::shared_queue_header::max_producers : 1;
+        for (size_t i = 0; i < limit; ++i)
+        {
+            if (take_entry(header.producers[i], self))
+            {
+                return &header.producers[i];
+            }
+        }
+        throw ring::core::exception("shared queue has no free producer entry");
+    }
+
+    static bool take_entry(detail::shared_queue_peer& peer, int32_t self)
+    {
+        int32_t pid = peer.pid.load(std::memory_order_acquire);
+        bool reusable = pid == 0 || (!shared_memory_region::process_alive(pid) &&
+            peer.claim_begin.load(std::memory_order_relaxed) == peer.claim_end.load(std::memory_order_relaxed));
+        return reusable && peer.pid.compare_exchange_strong(pid, self, std::memory_order_acq_rel);
+    }
+
+    static bool alive(const detail::shared_queue_peer& peer, std::chrono::nanoseconds timeout)
+    {
+        int32_t pid = peer.pid.load(std::memory_order_relaxed);
+        if (pid == 0)
+        {
+            return false;
+        }
+        int64_t last = peer.heartbeat.load(std::memory_order_relaxed);
+        return shared_memory_region::monotonic_now() - last <= timeout.count() &&
+            shared_memory_region::process_alive(pid);
+    }
+
+    template <typename Predicate>
+    bool wait_until(detail::event_count& event, Predicate&& ready, std::chrono::steady_clock::time_point deadline)
+    {
+        for (uint32_t spins = 0; !ready(); ++spins)
+        {
+            auto now = std::chrono::steady_clock::now();
+            if (now >= deadline)
+            {
+                return false;
+            }
+            if (spins < spin_limit)
+            {
+                detail::cpu_relax();
+                continue;
+            }
+            uint32_t epoch = event.prepare_wait();
+            if (ready())
+            {
+                event.cancel_wait();
+                return true;
+            }
+            event.commit_wait_for(epoch, deadline - now);
+        }
+        return true;
+    }
+private:
+    shared_memory_region region_;
+    detail::shared_queue_header* header_;
+    const shm_role role_;
+    detail::shared_queue_peer* peer_;
+    queue_type queue_;
+    // recover_abandoned() state: the head that stopped moving and since when
+    size_t stalled_head_ = 0;
+    int64_t stalled_since_ = 0;
+};
+
+template <typename T>
+using shared_spsc_queue = basic_shared_queue<T, false>;
+
+template <typename T>
+using shared_mpsc_queue = basic_shared_queue<T, true>;
+
+} // namespace ring::core
+
+#endif // RING_CORE_SHARED_QUEUE_HPP_
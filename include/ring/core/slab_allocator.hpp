@@ -0,0 +1,93 @@
+#ifndef RING_CORE_SLAB_ALLOCATOR_HPP_
+#define RING_CORE_SLAB_ALLOCATOR_HPP_
+
+#include <bit>
+#include <cstddef>
+#include <memory>
+#include <memory_resource>
+#include <span>
+#include <vector>
+
+#include "ring/core/export.hpp"
+
+namespace ring::core
+{
+
+struct slab_class_stats
+{
+    size_t block_size = 0;
+    // blocks handed out right now and the highest sampled value
+    size_t live = 0;
+    size_t peak = 0;
+    // blocks carved from the system, live or cached
+    size_t reserved = 0;
+    size_t requested_bytes = 0;
+    // share of reserved bytes not holding requested data: size-class rounding plus idle blocks
+    double fragmentation = 0.0;
+};
+
+struct slab_stats
+{
+    std::vector<slab_class_stats> classes;
+    // requests above max_block_size go straight to operator new
+    size_t large_live = 0;
+    size_t large_bytes = 0;
+};
+
+// Power-of-two size classes from 16 bytes to 64 KB for variable-length
+// packets and messages. Each class is an object_pool_mt of raw blocks, so
+// allocation runs through per-thread magazines and only the chunk carving
+// path locks. deallocate() must receive the span allocate() returned.
+class RING_API slab_allocator final
+{
+public:
+    static constexpr size_t min_block_size = 16;
+    static constexpr size_t max_block_size = 64 * 1024;
+    static constexpr size_t class_count = std::bit_width(max_block_size) - std::bit_width(min_block_size) + 1;
+    static constexpr size_t max_alignment = 64;
+public:
+    slab_allocator();
+    ~slab_allocator();
+private:
+    slab_allocator(const slab_allocator&) = delete;
+    slab_allocator& operator=(const slab_allocator&) = delete;
+public:
+    std::span<std::byte> allocate(size_t size);
+    void deallocate(std::span<std::byte> buffer);
+
+    slab_stats stats() const;
+public:
+    static constexpr size_t class_index(size_t size)
+    {
+        return size <= min_block_size ? 0 : std::bit_width(size - 1) - std::bit_width(min_block_size) + 1;
+    }
+    static constexpr size_t block_size(size_t size)
+    {
+        return size > max_block_size ? size : min_block_size << class_index(size);
+    }
+private:
+    class impl;
+    std::unique_ptr<impl> impl_;
+};
+
+// lets pmr containers draw from a slab_allocator; alignment above
+// slab_allocator::max_alignment goes to the upstream resource
+class RING_API slab_memory_resource final : public std::pmr::memory_resource
+{
+public:
+    explicit slab_memory_resource(slab_allocator& allocator,
+        std::pmr::memory_resource* upstream = std::pmr::new_delete_resource()) :
+        allocator_(allocator),
+        upstream_(upstream) {}
+private:
+    void* do_allocate(size_t bytes, size_t alignment) override;
+    void do_deallocate(void* ptr, size_t bytes, size_t alignment) override;
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override;
+private:
+    slab_allocator& allocator_;
+    std::pmr::memory_resource* upstream_;
+};
+
+} // namespace ring::core
+
+#endif // RING_CORE_SLAB_ALLOCATOR_HPP_
@@ -0,0 +1,377 @@
+#ifndef RING_CORE_SLOT_MAP_HPP_
+#define RING_CORE_SLOT_MAP_HPP_
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <mutex>
+#include <shared_mutex>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "ring/core/exception.hpp"
+#include "ring/core/export.hpp"
+
+namespace ring::core
+{
+
+// index + generation packed into one word. A 64-bit handle splits 32/32; a
+// 32-bit handle keeps 20 index bits (about 1M live slots) and a 12-bit
+// generation, so a slot_map retires a 32-bit slot after 4095 reuses. The
+// all-zero value is the null handle and never resolves.
+template <typename Word>
+class RING_API basic_slot_handle final
+{
+    static_assert(std::is_same_v<Word, uint32_t> || std::is_same_v<Word, uint64_t>,
+        "slot handles are 32 or 64 bits wide");
+public:
+    using value_type = Word;
+
+    static constexpr uint32_t index_bits = sizeof(Word) == 8 ? 32 : 20;
+    static constexpr uint32_t generation_bits = sizeof(Word) * 8 - index_bits;
+    static constexpr Word index_mask = (Word{ 1 } << index_bits) - 1;
+    static constexpr Word generation_mask = static_cast<Word>(~Word{ 0 } >> index_bits);
+    static constexpr size_t max_slots = static_cast<size_t>(index_mask) + 1;
+public:
+    constexpr basic_slot_handle() noexcept = default;
+    constexpr basic_slot_handle(Word index, Word generation) noexcept :
+        value_((generation & generation_mask) << index_bits | (index & index_mask)) {}
+public:
+    static constexpr basic_slot_handle from_value(Word value) noexcept
+    {
+        basic_slot_handle handle;
+        handle.value_ = value;
+        return handle;
+    }
+    constexpr Word value() const noexcept
+    {
+        return value_;
+    }
+    constexpr uint32_t index() const noexcept
+    {
+        return static_cast<uint32_t>(value_ & index_mask);
+    }
+    constexpr uint32_t generation() const noexcept
+    {
+        return static_cast<uint32_t>(value_ >> index_bits);
+    }
+    constexpr explicit operator bool() const noexcept
+    {
+        return value_ != 0;
+    }
+    constexpr bool operator==(const basic_slot_handle&) const noexcept = default;
+private:
+    Word value_ = 0;
+};
+
+using slot_handle = basic_slot_handle<uint64_t>;
+using slot_handle32 = basic_slot_handle<uint32_t>;
+
+// Dense generational container. Values sit contiguously so iteration is a
+// linear scan; erase swaps the last value into the hole. Handles stay valid
+// across other inserts and erases, and a handle to an erased value fails its
+// generation check instead of aliasing whatever reuses the slot. A slot whose
+// generation would wrap is retired rather than reused, so a stale handle never
+// resolves again; retired slots still count towards the handle index limit.
+template <typename T, typename Handle = slot_handle>
+class RING_API slot_map final
+{
+private:
+    static constexpr uint32_t no_slot = std::numeric_limits<uint32_t>::max();
+    // no handle carries generation 0, so a retired slot matches nothing
+    static constexpr uint32_t retired_generation = 0;
+
+    struct slot
+    {
+        // dense index while live, next free slot while free
+        uint32_t target = no_slot;
+        uint32_t generation = 1;
+    };
+public:
+    using handle_type = Handle;
+    using iterator = typename std::vector<T>::iterator;
+    using const_iterator = typename std::vector<T>::const_iterator;
+public:
+    slot_map() = default;
+    explicit slot_map(size_t capacity)
+    {
+        reserve(capacity);
+    }
+    ~slot_map() = default;
+public:
+    slot_map(slot_map&&) noexcept = default;
+    slot_map& operator=(slot_map&&) noexcept = default;
+private:
+    slot_map(const slot_map&) = delete;
+    slot_map& operator=(const slot_map&) = delete;
+public:
+    template <typename... Args>
+    handle_type emplace(Args&&... args)
+    {
+        if (free_head_ == no_slot && slots_.size() >= std::min<size_t>(handle_type::max_slots, no_slot))
+        {
+            throw ring::core::exception("slot map is out of handle indices");
+        }
+        // make room first: once the value is in, nothing below may throw, or
+        // values_ would hold an element without an owner
+        reserve_one(owners_);
+        if (free_head_ == no_slot)
+        {
+            reserve_one(slots_);
+        }
+        values_.emplace_back(std::forward<Args>(args)...);
+        uint32_t index = free_head_;
+        if (index == no_slot)
+        {
+            index = static_cast<uint32_t>(slots_.size());
+            slots_.emplace_back();
+        }
+        else
+        {
+            free_head_ = slots_[index].target;
+        }
+        slots_[index].target = static_cast<uint32_t>(values_.size() - 1);
+        owners_.push_back(index);
+        return handle_type(index, slots_[index].generation);
+    }
+
+    handle_type insert(T value)
+    {
+        return emplace(std::move(value));
+    }
+
+    bool erase(handle_type handle)
+    {
+        if (!contains(handle))
+        {
+            return false;
+        }
+        auto& erased = slots_[handle.index()];
+        uint32_t hole = erased.target;
+        uint32_t last = static_cast<uint32_t>(values_.size() - 1);
+        if (hole != last)
+        {
+            values_[hole] = std::move(values_[last]);
+            owners_[hole] = owners_[last];
+            slots_[owners_[hole]].target = hole;
+        }
+        values_.pop_back();
+        owners_.pop_back();
+
+        release(handle.index());
+        return true;
+    }
+
+    bool contains(handle_type handle) const
+    {
+        return handle.index() < slots_.size() && handle.generation() == slots_[handle.index()].generation &&
+            handle.generation() != retired_generation;
+    }
+
+    T* get(handle_type handle)
+    {
+        return contains(handle) ? &values_[slots_[handle.index()].target] : nullptr;
+    }
+
+    const T* get(handle_type handle) const
+    {
+        return contains(handle) ? &values_[slots_[handle.index()].target] : nullptr;
+    }
+
+    // handle of the value at a dense position, for iterating with handles
+    handle_type handle_at(size_t position) const
+    {
+        uint32_t index = owners_[position];
+        return handle_type(index, slots_[index].generation);
+    }
+
+    void clear()
+    {
+        for (uint32_t owner : owners_)
+        {
+            release(owner);
+        }
+        values_.clear();
+        owners_.clear();
+    }
+
+    void reserve(size_t capacity)
+    {
+        values_.reserve(capacity);
+        owners_.reserve(capacity);
+        slots_.reserve(capacity);
+    }
+
+    size_t size() const
+    {
+        return values_.size();
+    }
+
+    bool empty() const
+    {
+        return values_.empty();
+    }
+
+    // slots that exhausted their generations and are never handed out again
+    size_t retired() const
+    {
+        return retired_;
+    }
+
+    T* data()
+    {
+        return values_.data();
+    }
+
+    const T* data() const
+    {
+        return values_.data();
+    }
+
+    iterator begin()
+    {
+        return values_.begin();
+    }
+
+    iterator end()
+    {
+        return values_.end();
+    }
+
+    const_iterator begin() const
+    {
+        return values_.begin();
+    }
+
+    const_iterator end() const
+    {
+        return values_.end();
+    }
+private:
+    // grows geometrically, so the next push_back neither allocates nor throws
+    template <typename Vector>
+    static void reserve_one(Vector& vector)
+    {
+        if (vector.size() == vector.capacity())
+        {
+            vector.reserve(std::max<size_t>(vector.capacity() * 2, 1));
+        }
+    }
+
+    // Bumps the generation of a slot whose value is gone and puts it on the
+    // free list, or retires it once the generation has no room left.
+    void release(uint32_t index)
+    {
+        auto& entry = slots_[index];
+        if (entry.generation == static_cast<uint32_t>(handle_type::generation_mask))
+        {
+            entry.generation = retired_generation;
+            entry.target = no_slot;
+            ++retired_;
+            return;
+        }
+        ++entry.generation;
+        entry.target = free_head_;
+        free_head_ = index;
+    }
+private:
+    std::vector<T> values_;
+    std::vector<uint32_t> owners_;
+    std::vector<slot> slots_;
+    uint32_t free_head_ = no_slot;
+    size_t retired_ = 0;
+};
+
+// slot_map behind a reader/writer lock for resolving handles from network
+// threads while the owning thread mutates. Values move on erase, so access
+// goes through callbacks that run under the lock instead of raw pointers.
+template <typename T, typename Handle = slot_handle>
+class RING_API concurrent_slot_map final
+{
+public:
+    using handle_type = Handle;
+public:
+    concurrent_slot_map() = default;
+    explicit concurrent_slot_map(size_t capacity) :
+        map_(capacity) {}
+    ~concurrent_slot_map() = default;
+private:
+    concurrent_slot_map(const concurrent_slot_map&) = delete;
+    concurrent_slot_map& operator=(const concurrent_slot_map&) = delete;
+public:
+    template <typename... Args>
+    handle_type emplace(Args&&... args)
+    {
+        std::unique_lock lock(mutex_);
+        return map_.emplace(std::forward<Args>(args)...);
+    }
+
+    bool erase(handle_type handle)
+    {
+        std::unique_lock lock(mutex_);
+        return map_.erase(handle);
+    }
+
+    bool contains(handle_type handle) const
+    {
+        std::shared_lock lock(mutex_);
+        return map_.contains(handle);
+    }
+
+    // runs visitor(const T&) under a shared lock; false if the handle is stale
+    template <typename Visitor>
+    bool read(handle_type handle, Visitor&& visitor) const
+    {
+        std::shared_lock lock(mutex_);
+        const T* value = map_.get(handle);
+        if (!value)
+        {
+            return false;
+        }
+        std::forward<Visitor>(visitor)(*value);
+        return true;
+    }
+
+    // runs visitor(T&) under the exclusive lock; false if the handle is stale
+    template <typename Visitor>
+    bool write(handle_type handle, Visitor&& visitor)
+    {
+        std::unique_lock lock(mutex_);
+        T* value = map_.get(handle);
+        if (!value)
+        {
+            return false;
+        }
+        std::forward<Visitor>(visitor)(*value);
+        return true;
+    }
+
+    template <typename Visitor>
+    void for_each(Visitor&& visitor) const
+    {
+        std::shared_lock lock(mutex_);
+        for (const auto& value : map_)
+        {
+            visitor(value);
+        }
+    }
+
+    size_t size() const
+    {
+        std::shared_lock lock(mutex_);
+        return map_.size();
+    }
+
+    bool empty() const
+    {
+        return size() == 0;
+    }
+private:
+    mutable std::shared_mutex mutex_;
+    slot_map<T, Handle> map_;
+};
+
+} // namespace ring::core
+
+#endif // RING_CORE_SLOT_MAP_HPP_
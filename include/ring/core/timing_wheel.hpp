@@ -0,0 +1,352 @@
+#ifndef RING_CORE_TIMING_WHEEL_HPP_
+#define RING_CORE_TIMING_WHEEL_HPP_
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <utility>
+
+#include "ring/core/export.hpp"
+#include "ring/core/lockfree_queue.hpp"
+#include "ring/core/object_pool.hpp"
+
+namespace ring::core
+{
+
+class timer_handle;
+
+namespace detail
+{
+
+struct timer_link
+{
+    timer_link* prev = this;
+    timer_link* next = this;
+    timer_handle* handle = nullptr;
+
+    bool linked() const
+    {
+        return next != this;
+    }
+
+    void unlink()
+    {
+        prev->next = next;
+        next->prev = prev;
+        prev = next = this;
+    }
+
+    void push_back(timer_link* node)
+    {
+        node->prev = prev;
+        node->next = this;
+        prev->next = node;
+        prev = node;
+    }
+};
+
+} // namespace detail
+
+// Intrusive handle to a scheduled timer. The timer points back at its handle,
+// so the handle goes inactive once the timer fires or is cancelled. Dropping
+// the handle detaches it without cancelling the timer.
+class timer_handle final
+{
+public:
+    timer_handle() = default;
+    ~timer_handle()
+    {
+        if (node_)
+        {
+            node_->handle = nullptr;
+        }
+    }
+    timer_handle(timer_handle&& other) noexcept :
+        node_(std::exchange(other.node_, nullptr))
+    {
+        if (node_)
+        {
+            node_->handle = this;
+        }
+    }
+    timer_handle& operator=(timer_handle&& other) noexcept
+    {
+        if (this != &other)
+        {
+            if (node_)
+            {
+                node_->handle = nullptr;
+            }
+            node_ = std::exchange(other.node_, nullptr);
+            if (node_)
+            {
+                node_->handle = this;
+            }
+        }
+        return *this;
+    }
+private:
+    timer_handle(const timer_handle&) = delete;
+    timer_handle& operator=(const timer_handle&) = delete;
+public:
+    bool active() const
+    {
+        return node_ != nullptr;
+    }
+private:
+    template <typename Callback>
+    friend class timing_wheel;
+    detail::timer_link* node_ = nullptr;
+};
+
+// Hierarchical timing wheel (Varghese & Lauck) with 64-slot levels. Schedule,
+// reschedule and cancel are O(1); a timer cascades down at most once per
+// level. Everything except post() belongs to the thread that calls advance().
+template <typename Callback = std::function<void()>>
+class RING_API timing_wheel final
+{
+public:
+    using clock = std::chrono::steady_clock;
+    static constexpr size_t level_bits = 6;
+    static constexpr size_t level_slots = size_t{ 1 } << level_bits;
+    static constexpr size_t levels = 6;
+private:
+    static constexpr uint64_t slot_mask = level_slots - 1;
+    static constexpr uint64_t max_delta = (uint64_t{ 1 } << (level_bits * levels)) - 1;
+
+    struct node : detail::timer_link
+    {
+        explicit node(uint64_t expiry, Callback&& callback) :
+            expiry(expiry),
+            callback(std::move(callback)) {}
+
+        uint64_t expiry;
+        Callback callback;
+    };
+
+    struct request
+    {
+        clock::time_point deadline;
+        Callback callback;
+    };
+public:
+    explicit timing_wheel(std::chrono::nanoseconds resolution = std::chrono::milliseconds(1),
+        size_t post_capacity = 4096, clock::time_point origin = clock::now()) :
+        resolution_(resolution),
+        origin_(origin),
+        posted_(post_capacity) {}
+
+    ~timing_wheel()
+    {
+        for (auto& level : wheel_)
+        {
+            for (auto& slot : level)
+            {
+                while (slot.linked())
+                {
+                    release(static_cast<node*>(slot.next));
+                }
+            }
+        }
+    }
+private:
+    timing_wheel(const timing_wheel&) = delete;
+    timing_wheel& operator=(const timing_wheel&) = delete;
+public:
+    timer_handle schedule(clock::time_point deadline, Callback callback)
+    {
+        node* timer = pool_.acquire(deadline_tick(deadline), std::move(callback));
+        insert(timer, current_ + 1);
+        ++size_;
+        timer_handle handle;
+        handle.node_ = timer;
+        timer->handle = &handle;
+        return handle;
+    }
+
+    timer_handle schedule_after(std::chrono::nanoseconds delay, Callback callback)
+    {
+        return schedule(clock::now() + delay, std::move(callback));
+    }
+
+    bool reschedule(timer_handle& handle, clock::time_point deadline)
+    {
+        if (!handle.node_)
+        {
+            return false;
+        }
+        node* timer = static_cast<node*>(handle.node_);
+        timer->unlink();
+        timer->expiry = deadline_tick(deadline);
+        insert(timer, current_ + 1);
+        return true;
+    }
+
+    bool cancel(timer_handle& handle)
+    {
+        if (!handle.node_)
+        {
+            return false;
+        }
+        release(static_cast<node*>(handle.node_));
+        return true;
+    }
+
+    // safe from any thread; the timer is scheduled on the next advance()
+    bool post(clock::time_point deadline, Callback callback)
+    {
+        return posted_.try_push(request{ deadline, std::move(callback) });
+    }
+
+    // fires every timer due at or before now, returns how many fired
+    size_t advance(clock::time_point now)
+    {
+        request posted;
+        while (posted_.try_pop(posted))
+        {
+            node* timer = pool_.acquire(deadline_tick(posted.deadline), std::move(posted.callback));
+            insert(timer, current_ + 1);
+            ++size_;
+        }
+
+        uint64_t target = to_tick(now);
+        size_t fired = 0;
+        while (current_ < target)
+        {
+            if (size_ == 0)
+            {
+                current_ = target;
+                break;
+            }
+            ++current_;
+            for (size_t level = levels - 1; level > 0; --level)
+            {
+                if ((current_ & ((uint64_t{ 1 } << (level * level_bits)) - 1)) == 0)
+                {
+                    cascade(wheel_[level][(current_ >> (level * level_bits)) & slot_mask]);
+                }
+            }
+            fired += expire(wheel_[0][current_ & slot_mask]);
+        }
+        return fired;
+    }
+
+    size_t size() const
+    {
+        return size_;
+    }
+
+    bool empty() const
+    {
+        return size_ == 0;
+    }
+
+    std::chrono::nanoseconds resolution() const
+    {
+        return resolution_;
+    }
+private:
+    uint64_t to_tick(clock::time_point time) const
+    {
+        if (time <= origin_)
+        {
+            return 0;
+        }
+        return static_cast<uint64_t>((time - origin_) / resolution_);
+    }
+
+    // rounds up so that a timer never fires before its deadline
+    uint64_t deadline_tick(clock::time_point deadline) const
+    {
+        uint64_t tick = to_tick(deadline);
+        return origin_ + tick * resolution_ < deadline ? tick + 1 : tick;
+    }
+
+    // earliest is the first tick whose level 0 slot has not fired yet
+    void insert(node* timer, uint64_t earliest)
+    {
+        uint64_t expiry = std::max(timer->expiry, earliest);
+        uint64_t delta = std::min(expiry - current_, max_delta);
+        expiry = current_ + delta;
+        size_t level = 0;
+        while (delta >= (uint64_t{ 1 } << ((level + 1) * level_bits)))
+        {
+            ++level;
+        }
+        wheel_[level][(expiry >> (level * level_bits)) & slot_mask].push_back(timer);
+    }
+
+    void cascade(detail::timer_link& slot)
+    {
+        detail::timer_link pending;
+        splice(slot, pending);
+        while (pending.linked())
+        {
+            node* timer = static_cast<node*>(pending.next);
+            timer->unlink();
+            insert(timer, current_);
+        }
+    }
+
+    size_t expire(detail::timer_link& slot)
+    {
+        // detach the batch first so callbacks can schedule or cancel freely
+        detail::timer_link batch;
+        splice(slot, batch);
+        size_t fired = 0;
+        while (batch.linked())
+        {
+            node* timer = static_cast<node*>(batch.next);
+            timer->unlink();
+            if (timer->handle)
+            {
+                timer->handle->node_ = nullptr;
+                timer->handle = nullptr;
+            }
+            Callback callback = std::move(timer->callback);
+            pool_.release(timer);
+            --size_;
+            ++fired;
+            callback();
+        }
+        return fired;
+    }
+
+    void release(node* timer)
+    {
+        timer->unlink();
+        if (timer->handle)
+        {
+            timer->handle->node_ = nullptr;
+        }
+        pool_.release(timer);
+        --size_;
+    }
+
+    static void splice(detail::timer_link& from, detail::timer_link& to)
+    {
+        if (!from.linked())
+        {
+            return;
+        }
+        to.next = from.next;
+        to.prev = from.prev;
+        to.next->prev = &to;
+        to.prev->next = &to;
+        from.prev = from.next = &from;
+    }
+private:
+    const std::chrono::nanoseconds resolution_;
+    const clock::time_point origin_;
+    uint64_t current_ = 0;
+    size_t size_ = 0;
+    std::array<std::array<detail::timer_link, level_slots>, levels> wheel_;
+    object_pool<node> pool_;
+    mpsc_queue<request> posted_;
+};
+
+} // namespace ring::core
+
+#endif // RING_CORE_TIMING_WHEEL_HPP_
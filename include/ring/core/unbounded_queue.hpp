@@ -0,0 +1,372 @@
+#ifndef RING_CORE_UNBOUNDED_QUEUE_HPP_
+#define RING_CORE_UNBOUNDED_QUEUE_HPP_
+
+#include <algorithm>
+#include <atomic>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <type_traits>
+#include <vector>
+
+#include "ring/core/cache_line.hpp"
+#include "ring/core/lockfree_queue.hpp"
+
+namespace ring::core
+{
+
+namespace detail
+{
+
+// A linked list of bounded ring segments. Producers fill the tail segment and
+// close it with a flag in its tail cursor once it is full, then link a new one;
+// consumers drain the head segment and unlink it once it is closed and empty.
+// Segments are only reclaimed when the queue is destroyed: unlinked segments go
+// back to a free pool, which keeps stale segment pointers safe to dereference.
+template <typename T, bool MultiConsumer>
+class basic_unbounded_queue final
+{
+private:
+    static constexpr size_t closed_bit = size_t{ 1 } << (std::numeric_limits<size_t>::digits - 1);
+    static constexpr size_t unlinked_bit = closed_bit;
+
+    struct segment
+    {
+        explicit segment(size_t capacity) :
+            block(capacity) {}
+
+        void reset()
+        {
+            block.head->store(0, std::memory_order_relaxed);
+            block.tail->store(0, std::memory_order_relaxed);
+            for (size_t i = 0; i < block.capacity; ++i)
+            {
+                block.sequence(i).store(i, std::memory_order_relaxed);
+            }
+            next->store(nullptr, std::memory_order_relaxed);
+        }
+
+        memory_block<T, true> block;
+        cache_aligned<std::atomic<segment*>> next{ nullptr };
+        cache_aligned<std::atomic<size_t>> refs{ 0 };
+    };
+public:
+    explicit basic_unbounded_queue(size_t segment_capacity, size_t soft_limit = std::numeric_limits<size_t>::max()) :
+        segment_capacity_(segment_capacity),
+        soft_limit_(soft_limit)
+    {
+        segment* seg = allocate_segment();
+        head_->store(seg, std::memory_order_relaxed);
+        tail_->store(seg, std::memory_order_relaxed);
+        release(seg);
+    }
+
+    ~basic_unbounded_queue()
+    {
+        if constexpr (!std::is_trivially_destructible_v<T>)
+        {
+            for (segment* seg = head_->load(std::memory_order_relaxed); seg; seg = seg->next->load(std::memory_order_relaxed))
+            {
+                auto& block = seg->block;
+                size_t head = block.head->load(std::memory_order_relaxed);
+                size_t tail = block.tail->load(std::memory_order_relaxed) & ~closed_bit;
+                for ( ; head < tail; ++head)
+                {
+                    block[block.index(head)].~T();
+                }
+            }
+        }
+    }
+public:
+    template <typename Stats = no_queue_stats>
+    bool try_push(T&& value, Stats&& stats = {})
+    {
+        return try_push_batch(std::make_move_iterator(&value), std::make_move_iterator(&value + 1), stats) == 1;
+    }
+
+    template <typename Stats = no_queue_stats>
+    bool try_pop(T& result, Stats&& stats = {})
+    {
+        return try_pop_batch(&result, 1, stats) == 1;
+    }
+
+    template <typename InputIt, typename Stats = no_queue_stats>
+    size_t try_push_batch(InputIt first, InputIt last, Stats&& stats = {})
+    {
+        size_t requested = std::distance(first, last);
+        if (requested == 0)
+        {
+            return 0;
+        }
+        for (;;)
+        {
+            segment* seg = acquire(*tail_);
+            size_t pushed = push_segment(seg->block, first, requested, stats);
+            if (pushed == 0 && (seg->block.tail->load(std::memory_order_acquire) & closed_bit))
+            {
+                advance_tail(seg);
+            }
+            release(seg);
+            if (pushed)
+            {
+                return pushed;
+            }
+        }
+    }
+
+    template <typename OutputIt, typename Stats = no_queue_stats>
+    size_t try_pop_batch(OutputIt first, size_t max_count, Stats&& stats = {})
+    {
+        if (max_count == 0)
+        {
+            return 0;
+        }
+        for (;;)
+        {
+            segment* seg = acquire(*head_);
+            size_t popped = pop_segment(seg->block, first, max_count, stats);
+            if (popped || !advance_head(seg))
+            {
+                release(seg);
+                return popped;
+            }
+            release(seg);
+        }
+    }
+
+    size_t size() const
+    {
+        size_t total = 0;
+        const segment* seg = head_->load(std::memory_order_acquire);
+        for (size_t n = allocated_.load(std::memory_order_acquire); seg && n; --n)
+        {
+            size_t head = seg->block.head->load(std::memory_order_acquire);
+            size_t tail = seg->block.tail->load(std::memory_order_acquire) & ~closed_bit;
+            total += tail > head ? tail - head : 0;
+            seg = seg->next->load(std::memory_order_acquire);
+        }
+        return total;
+    }
+
+    size_t capacity() const
+    {
+        return std::numeric_limits<size_t>::max();
+    }
+
+    bool empty() const
+    {
+        return size() == 0;
+    }
+
+    size_t soft_limit() const
+    {
+        return soft_limit_;
+    }
+
+    bool backpressure() const
+    {
+        return size() > soft_limit_;
+    }
+private:
+    template <typename InputIt, typename Stats>
+    size_t push_segment(memory_block<T, true>& block, InputIt& first, size_t requested, Stats& stats)
+    {
+        size_t pos = block.tail->load(std::memory_order_relaxed);
+        if (pos & closed_bit)
+        {
+            return 0;
+        }
+        size_t count = 0;
+        for ( ; count < std::min(requested, block.capacity); ++count)
+        {
+            if (block.sequence(block.index(pos + count)).load(std::memory_order_acquire) != pos + count)
+            {
+                break;
+            }
+        }
+        if (count == 0)
+        {
+            // the slot still holds an element from the previous lap: the segment is full
+            if (block.sequence(block.index(pos)).load(std::memory_order_acquire) < pos)
+            {
+                block.tail->compare_exchange_strong(pos, pos | closed_bit,
+                    std::memory_order_acq_rel, std::memory_order_relaxed);
+            }
+            return 0;
+        }
+        bool won = block.tail->compare_exchange_weak(pos, pos + count,
+            std::memory_order_acq_rel, std::memory_order_relaxed);
+        stats.record_push_cas(!won);
+        if (!won)
+        {
+            return 0;
+        }
+        for (size_t i = 0; i < count; ++i, ++first)
+        {
+            size_t slot = block.index(pos + i);
+            new (&block[slot]) T(std::move(*first));
+            block.sequence(slot).store(pos + i + 1, std::memory_order_release);
+        }
+        return count;
+    }
+
+    template <typename OutputIt, typename Stats>
+    size_t pop_segment(memory_block<T, true>& block, OutputIt& first, size_t max_count, Stats& stats)
+    {
+        size_t pos = block.head->load(std::memory_order_relaxed);
+        size_t count = 0;
+        for ( ; count < std::min(max_count, block.capacity); ++count)
+        {
+            if (block.sequence(block.index(pos + count)).load(std::memory_order_acquire) != pos + count + 1)
+            {
+                break;
+            }
+        }
+        if (count == 0)
+        {
+            return 0;
+        }
+        if constexpr (MultiConsumer)
+        {
+            bool won = block.head->compare_exchange_weak(pos, pos + count,
+                std::memory_order_acq_rel, std::memory_order_relaxed);
+            stats.record_pop_cas(!won);
+            if (!won)
+            {
+                return 0;
+            }
+        }
+        for (size_t i = 0; i < count; ++i)
+        {
+            size_t slot = block.index(pos + i);
+            *first++ = std::move(block[slot]);
+            block[slot].~T();
+            block.sequence(slot).store(pos + i + block.capacity, std::memory_order_release);
+        }
+        if constexpr (!MultiConsumer)
+        {
+            block.head->store(pos + count, std::memory_order_release);
+        }
+        return count;
+    }
+
+    void advance_tail(segment* seg)
+    {
+        segment* next = seg->next->load(std::memory_order_acquire);
+        if (!next)
+        {
+            segment* fresh = allocate_segment();
+            if (seg->next->compare_exchange_strong(next, fresh,
+                std::memory_order_acq_rel, std::memory_order_acquire))
+            {
+                next = fresh;
+            }
+            else
+            {
+                fresh->refs->fetch_or(unlinked_bit, std::memory_order_acq_rel);
+            }
+            release(fresh);
+        }
+        tail_->compare_exchange_strong(seg, next, std::memory_order_acq_rel, std::memory_order_relaxed);
+    }
+
+    // unlinks seg once it is closed, drained and has a successor
+    bool advance_head(segment* seg)
+    {
+        size_t tail = seg->block.tail->load(std::memory_order_acquire);
+        segment* next = seg->next->load(std::memory_order_acquire);
+        if (!(tail & closed_bit) || !next ||
+            seg->block.head->load(std::memory_order_acquire) != (tail & ~closed_bit))
+        {
+            return false;
+        }
+        segment* expected = seg;
+        tail_->compare_exchange_strong(expected, next, std::memory_order_acq_rel, std::memory_order_relaxed);
+        expected = seg;
+        if (head_->compare_exchange_strong(expected, next, std::memory_order_acq_rel, std::memory_order_relaxed))
+        {
+            seg->refs->fetch_or(unlinked_bit, std::memory_order_acq_rel);
+        }
+        return true;
+    }
+
+    segment* acquire(const std::atomic<segment*>& cursor)
+    {
+        for (;;)
+        {
+            segment* seg = cursor.load(std::memory_order_acquire);
+            size_t refs = seg->refs->load(std::memory_order_relaxed);
+            if ((refs & unlinked_bit) || !seg->refs->compare_exchange_weak(refs, refs + 1,
+                std::memory_order_acq_rel, std::memory_order_relaxed))
+            {
+                continue;
+            }
+            if (cursor.load(std::memory_order_acquire) == seg)
+            {
+                return seg;
+            }
+            release(seg);
+        }
+    }
+
+    void release(segment* seg)
+    {
+        if (seg->refs->fetch_sub(1, std::memory_order_acq_rel) - 1 == unlinked_bit)
+        {
+            std::lock_guard lock(pool_mutex_);
+            pool_.push_back(seg);
+        }
+    }
+
+    // returns a reset segment holding one reference for the caller
+    segment* allocate_segment()
+    {
+        segment* seg = nullptr;
+        {
+            std::lock_guard lock(pool_mutex_);
+            if (pool_.empty())
+            {
+                segments_.emplace_back(std::make_unique<segment>(segment_capacity_));
+                allocated_.store(segments_.size(), std::memory_order_release);
+                seg = segments_.back().get();
+            }
+            else
+            {
+                seg = pool_.back();
+                pool_.pop_back();
+            }
+        }
+        seg->reset();
+        seg->refs->store(1, std::memory_order_release);
+        return seg;
+    }
+private:
+    const size_t segment_capacity_;
+    const size_t soft_limit_;
+    cache_aligned<std::atomic<segment*>> head_{ nullptr };
+    cache_aligned<std::atomic<segment*>> tail_{ nullptr };
+private:
+    std::mutex pool_mutex_;
+    std::vector<segment*> pool_;
+    std::vector<std::unique_ptr<segment>> segments_;
+    std::atomic<size_t> allocated_{ 0 };
+};
+
+template <typename T>
+using unbounded_mpsc_queue = basic_unbounded_queue<T, false>;
+
+template <typename T>
+using unbounded_mpmc_queue = basic_unbounded_queue<T, true>;
+
+} // namespace detail
+
+template <typename T, typename WaitStrategy = spin_yield_wait, typename Stats = default_queue_stats>
+using unbounded_mpsc_queue = lockfree_queue<T, detail::unbounded_mpsc_queue, WaitStrategy, Stats>;
+
+template <typename T, typename WaitStrategy = spin_yield_wait, typename Stats = default_queue_stats>
+using unbounded_mpmc_queue = lockfree_queue<T, detail::unbounded_mpmc_queue, WaitStrategy, Stats>;
+
+} // namespace ring::core
+
+#endif // RING_CORE_UNBOUNDED_QUEUE_HPP_
@@ -0,0 +1,327 @@
+#ifndef RING_CORE_WAIT_STRATEGY_HPP_
+#define RING_CORE_WAIT_STRATEGY_HPP_
+
+#include <atomic>
+#include <chrono>
+#include <climits>
+#include <cstdint>
+#include <thread>
+
+#ifdef RING_COMPILER_MSVC
+#include <intrin.h>
+#endif
+
+#ifdef RING_PLATFORM_LINUX
+#include <cerrno>
+#include <ctime>
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#include "ring/core/cache_line.hpp"
+#include "ring/core/export.hpp"
+
+namespace ring::core
+{
+
+enum class wait_channel
+{
+    not_empty,
+    not_full
+};
+
+namespace detail
+{
+
+inline void cpu_relax() noexcept
+{
+#if defined(_M_X64) || defined(_M_IX86)
+    _mm_pause();
+#elif defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#elif defined(__aarch64__) || defined(__arm__)
+    __asm__ __volatile__("yield");
+#else
+    std::atomic_signal_fence(std::memory_order_seq_cst);
+#endif
+}
+
+static_assert(sizeof(std::atomic<uint32_t>) == sizeof(uint32_t) && std::atomic<uint32_t>::is_always_lock_free,
+    "futex word must be a plain lock-free 32-bit integer");
+
+inline void futex_wait(std::atomic<uint32_t>& word, uint32_t expected, bool shared = false) noexcept
+{
+#ifdef RING_PLATFORM_LINUX
+    ::syscall(SYS_futex, reinterpret_cast<uint32_t*>(&word), shared ? FUTEX_WAIT : FUTEX_WAIT_PRIVATE,
+        expected, nullptr, nullptr, 0);
+#else
+    (void)shared;
+    word.wait(expected, std::memory_order_acquire);
+#endif
+}
+
+// returns false once the timeout elapsed without the word changing
+inline bool futex_wait_for(std::atomic<uint32_t>& word, uint32_t expected, std::chrono::nanoseconds timeout,
+    bool shared = false) noexcept
+{
+    if (timeout <= std::chrono::nanoseconds::zero())
+    {
+        return word.load(std::memory_order_acquire) != expected;
+    }
+#ifdef RING_PLATFORM_LINUX
+    auto seconds = std::chrono::duration_cast<std::chrono::seconds>(timeout);
+    timespec ts{};
+    ts.tv_sec = static_cast<time_t>(seconds.count());
+    ts.tv_nsec = static_cast<long>((timeout - seconds).count());
+    if (::syscall(SYS_futex, reinterpret_cast<uint32_t*>(&word), shared ? FUTEX_WAIT : FUTEX_WAIT_PRIVATE,
+        expected, &ts, nullptr, 0) == -1 && errno == ETIMEDOUT)
+    {
+        return false;
+    }
+    return true;
+#else
+    // std::atomic has no timed wait before C++26, so poll at a bounded interval
+    (void)shared;
+    std::this_thread::sleep_for(std::min<std::chrono::nanoseconds>(timeout, std::chrono::milliseconds(1)));
+    return word.load(std::memory_order_acquire) != expected;
+#endif
+}
+
+inline void futex_wake(std::atomic<uint32_t>& word, int count, bool shared = false) noexcept
+{
+#ifdef RING_PLATFORM_LINUX
+    ::syscall(SYS_futex, reinterpret_cast<uint32_t*>(&word), shared ? FUTEX_WAKE : FUTEX_WAKE_PRIVATE,
+        count, nullptr, nullptr, 0);
+#else
+    (void)shared;
+    if (count == 1)
+    {
+        word.notify_one();
+    }
+    else
+    {
+        word.notify_all();
+    }
+#endif
+}
+
+inline void futex_wake_all(std::atomic<uint32_t>& word, bool shared = false) noexcept
+{
+    futex_wake(word, INT_MAX, shared);
+}
+
+// shared event counts live in cross-process mappings and use process-shared futexes
+class event_count final
+{
+public:
+    explicit event_count(bool shared = false) noexcept :
+        shared_(shared) {}
+public:
+    uint32_t prepare_wait() noexcept
+    {
+        waiters_.fetch_add(1, std::memory_order_seq_cst);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        return epoch_.load(std::memory_order_acquire);
+    }
+
+    void cancel_wait() noexcept
+    {
+        waiters_.fetch_sub(1, std::memory_order_relaxed);
+    }
+
+    void commit_wait(uint32_t epoch) noexcept
+    {
+        futex_wait(epoch_, epoch, shared_);
+        waiters_.fetch_sub(1, std::memory_order_relaxed);
+    }
+
+    bool commit_wait_for(uint32_t epoch, std::chrono::nanoseconds timeout) noexcept
+    {
+        bool woken = futex_wait_for(epoch_, epoch, timeout, shared_);
+        waiters_.fetch_sub(1, std::memory_order_relaxed);
+        return woken;
+    }
+
+    void notify_one() noexcept
+    {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (waiters_.load(std::memory_order_relaxed) != 0)
+        {
+            epoch_.fetch_add(1, std::memory_order_release);
+            futex_wake(epoch_, 1, shared_);
+        }
+    }
+
+    void notify_all() noexcept
+    {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (waiters_.load(std::memory_order_relaxed) != 0)
+        {
+            epoch_.fetch_add(1, std::memory_order_release);
+            futex_wake_all(epoch_, shared_);
+        }
+    }
+private:
+    std::atomic<uint32_t> epoch_{ 0 };
+    std::atomic<uint32_t> waiters_{ 0 };
+    const bool shared_;
+};
+
+} // namespace detail
+
+class busy_spin_wait final
+{
+public:
+    template <typename Predicate>
+    void wait(wait_channel, Predicate&& ready)
+    {
+        while (!ready())
+        {
+            detail::cpu_relax();
+        }
+    }
+
+    template <typename Predicate, typename Clock, typename Duration>
+    bool wait_until(wait_channel, Predicate&& ready, const std::chrono::time_point<Clock, Duration>& deadline)
+    {
+        while (!ready())
+        {
+            if (Clock::now() >= deadline)
+            {
+                return false;
+            }
+            detail::cpu_relax();
+        }
+        return true;
+    }
+
+    void notify(wait_channel) noexcept {}
+};
+
+class spin_yield_wait final
+{
+public:
+    static constexpr uint32_t spin_limit = 64;
+public:
+    template <typename Predicate>
+    void wait(wait_channel, Predicate&& ready)
+    {
+        for (uint32_t spins = 0; !ready(); ++spins)
+        {
+            if (spins < spin_limit)
+            {
+                detail::cpu_relax();
+            }
+            else
+            {
+                std::this_thread::yield();
+            }
+        }
+    }
+
+    template <typename Predicate, typename Clock, typename Duration>
+    bool wait_until(wait_channel, Predicate&& ready, const std::chrono::time_point<Clock, Duration>& deadline)
+    {
+        for (uint32_t spins = 0; !ready(); ++spins)
+        {
+            if (Clock::now() >= deadline)
+            {
+                return false;
+            }
+            if (spins < spin_limit)
+            {
+                detail::cpu_relax();
+            }
+            else
+            {
+                std::this_thread::yield();
+            }
+        }
+        return true;
+    }
+
+    void notify(wait_channel) noexcept {}
+};
+
+class spin_park_wait final
+{
+public:
+    static constexpr uint32_t spin_limit = 64;
+    static constexpr uint32_t yield_limit = 16;
+public:
+    template <typename Predicate>
+    void wait(wait_channel channel, Predicate&& ready)
+    {
+        for (uint32_t spins = 0; !ready(); ++spins)
+        {
+            if (spins < spin_limit)
+            {
+                detail::cpu_relax();
+                continue;
+            }
+            if (spins < spin_limit + yield_limit)
+            {
+                std::this_thread::yield();
+                continue;
+            }
+            auto& event = event_for(channel);
+            uint32_t epoch = event.prepare_wait();
+            if (ready())
+            {
+                event.cancel_wait();
+                return;
+            }
+            event.commit_wait(epoch);
+        }
+    }
+
+    template <typename Predicate, typename Clock, typename Duration>
+    bool wait_until(wait_channel channel, Predicate&& ready, const std::chrono::time_point<Clock, Duration>& deadline)
+    {
+        for (uint32_t spins = 0; !ready(); ++spins)
+        {
+            auto now = Clock::now();
+            if (now >= deadline)
+            {
+                return false;
+            }
+            if (spins < spin_limit)
+            {
+                detail::cpu_relax();
+                continue;
+            }
+            if (spins < spin_limit + yield_limit)
+            {
+                std::this_thread::yield();
+                continue;
+            }
+            auto& event = event_for(channel);
+            uint32_t epoch = event.prepare_wait();
+            if (ready())
+            {
+                event.cancel_wait();
+                return true;
+            }
+            event.commit_wait_for(epoch, std::chrono::duration_cast<std::chrono::nanoseconds>(deadline - now));
+        }
+        return true;
+    }
+
+    void notify(wait_channel channel) noexcept
+    {
+        event_for(channel).notify_all();
+    }
+private:
+    detail::event_count& event_for(wait_channel channel) noexcept
+    {
+        return channel == wait_channel::not_empty ? *not_empty_ : *not_full_;
+    }
+private:
+    cache_aligned<detail::event_count> not_empty_;
+    cache_aligned<detail::event_count> not_full_;
+};
+
+} // namespace ring::core
+
+#endif // RING_CORE_WAIT_STRATEGY_HPP_
@@ -0,0 +1,150 @@
+#ifndef RING_CORE_WORK_STEALING_DEQUE_HPP_
+#define RING_CORE_WORK_STEALING_DEQUE_HPP_
+
+#include <atomic>
+#include <bit>
+#include <cstdint>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+#include "ring/core/cache_line.hpp"
+#include "ring/core/export.hpp"
+
+namespace ring::core
+{
+
+// Chase-Lev deque (Le et al., "Correct and Efficient Work-Stealing for Weak
+// Memory Models"). The owner pushes and pops at the bottom, thieves steal from
+// the top. Retired arrays are kept until destruction since thieves may still
+// be reading them.
+template <typename T>
+class RING_API work_stealing_deque final
+{
+    static_assert(std::is_trivially_copyable_v<T>, "work_stealing_deque stores trivially copyable values");
+private:
+    class ring_array
+    {
+    public:
+        explicit ring_array(size_t capacity) :
+            capacity(capacity),
+            mask(capacity - 1),
+            slots(std::make_unique<std::atomic<T>[]>(capacity)) {}
+    public:
+        T get(int64_t i) const
+        {
+            return slots[static_cast<size_t>(i) & mask].load(std::memory_order_relaxed);
+        }
+        void put(int64_t i, T value)
+        {
+            slots[static_cast<size_t>(i) & mask].store(value, std::memory_order_relaxed);
+        }
+    public:
+        const size_t capacity;
+        const size_t mask;
+        std::unique_ptr<std::atomic<T>[]> slots;
+    };
+public:
+    explicit work_stealing_deque(size_t capacity = 1024)
+    {
+        arrays_.emplace_back(std::make_unique<ring_array>(std::bit_ceil(std::max<size_t>(capacity, 2))));
+        array_.store(arrays_.back().get(), std::memory_order_relaxed);
+    }
+    ~work_stealing_deque() = default;
+private:
+    work_stealing_deque(const work_stealing_deque&) = delete;
+    work_stealing_deque& operator=(const work_stealing_deque&) = delete;
+public:
+    // owner only
+    void push(T value)
+    {
+        int64_t bottom = bottom_->load(std::memory_order_relaxed);
+        int64_t top = top_->load(std::memory_order_acquire);
+        ring_array* array = array_.load(std::memory_order_relaxed);
+        if (bottom - top > static_cast<int64_t>(array->capacity) - 1)
+        {
+            array = grow(array, top, bottom);
+        }
+        array->put(bottom, value);
+        bottom_->store(bottom + 1, std::memory_order_release);
+    }
+
+    // owner only
+    bool pop(T& result)
+    {
+        int64_t bottom = bottom_->load(std::memory_order_relaxed) - 1;
+        ring_array* array = array_.load(std::memory_order_relaxed);
+        bottom_->store(bottom, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        int64_t top = top_->load(std::memory_order_relaxed);
+        if (top > bottom)
+        {
+            bottom_->store(bottom + 1, std::memory_order_relaxed);
+            return false;
+        }
+        result = array->get(bottom);
+        if (top == bottom)
+        {
+            bool won = top_->compare_exchange_strong(top, top + 1,
+                std::memory_order_seq_cst, std::memory_order_relaxed);
+            bottom_->store(bottom + 1, std::memory_order_relaxed);
+            return won;
+        }
+        return true;
+    }
+
+    // any thread
+    bool steal(T& result)
+    {
+        int64_t top = top_->load(std::memory_order_acquire);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        int64_t bottom = bottom_->load(std::memory_order_acquire);
+        if (top >= bottom)
+        {
+            return false;
+        }
+        ring_array* array = array_.load(std::memory_order_acquire);
+        T value = array->get(top);
+        if (!top_->compare_exchange_strong(top, top + 1,
+            std::memory_order_seq_cst, std::memory_order_relaxed))
+        {
+            return false;
+        }
+        result = value;
+        return true;
+    }
+
+    size_t size() const
+    {
+        int64_t bottom = bottom_->load(std::memory_order_relaxed);
+        int64_t top = top_->load(std::memory_order_relaxed);
+        return bottom > top ? static_cast<size_t>(bottom - top) : 0;
+    }
+
+    bool empty() const
+    {
+        return size() == 0;
+    }
+private:
+    ring_array* grow(ring_array* array, int64_t top, int64_t bottom)
+    {
+        auto bigger = std::make_unique<ring_array>(array->capacity * 2);
+        for (int64_t i = top; i < bottom; ++i)
+        {
+            bigger->put(i, array->get(i));
+        }
+        ring_array* result = bigger.get();
+        arrays_.emplace_back(std::move(bigger));
+        array_.store(result, std::memory_order_release);
+        return result;
+    }
+private:
+    cache_aligned<std::atomic<int64_t>> top_{ 0 };
+    cache_aligned<std::atomic<int64_t>> bottom_{ 0 };
+    std::atomic<ring_array*> array_{ nullptr };
+    std::vector<std::unique_ptr<ring_array>> arrays_;
+};
+
+} // namespace ring::core
+
+#endif // RING_CORE_WORK_STEALING_DEQUE_HPP_
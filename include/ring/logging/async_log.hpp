@@ -0,0 +1,85 @@
+#ifndef RING_LOGGING_ASYNC_LOG_HPP_
+#define RING_LOGGING_ASYNC_LOG_HPP_
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+#include "ring/core/export.hpp"
+#include "ring/logging/logger.hpp"
+
+namespace ring::logging::detail
+{
+
+// A logger's end of the async backend: where its records are written and
+// what happens when the producing thread's channel is full.
+class RING_API async_sink
+{
+public:
+    explicit async_sink(overflow_policy policy) :
+        policy_(policy) {}
+    virtual ~async_sink() = default;
+private:
+    async_sink(const async_sink&) = delete;
+    async_sink& operator=(const async_sink&) = delete;
+public:
+    // runs on a writer thread; thread_id is the producer's, see log_thread_id()
+    virtual void write(log_level level, std::chrono::system_clock::time_point time, size_t thread_id,
+        std::string_view message) = 0;
+
+    overflow_policy policy() const
+    {
+        return policy_;
+    }
+
+    log_drop_stats drop_stats() const
+    {
+        return { dropped_.load(std::memory_order_relaxed), overwritten_.load(std::memory_order_relaxed) };
+    }
+
+    void count_dropped()
+    {
+        dropped_.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    void count_overwritten()
+    {
+        overwritten_.fetch_add(1, std::memory_order_relaxed);
+    }
+private:
+    const overflow_policy policy_;
+    std::atomic<uint64_t> dropped_{ 0 };
+    std::atomic<uint64_t> overwritten_{ 0 };
+};
+
+struct async_record
+{
+    async_sink* target = nullptr;
+    log_level level = log_level::info;
+    std::chrono::system_clock::time_point time;
+    size_t thread_id = 0;
+    std::string message;
+};
+
+// writers start with the first registered sink
+RING_API void register_async_sink(async_sink& sink);
+// flushes pending records first; the sink must not be logged to afterwards
+RING_API void unregister_async_sink(async_sink& sink);
+
+// Queues a record on the calling thread's channel for the sink's overflow
+// policy and applies that policy when it is full. With no writer running the
+// record is written in place.
+RING_API void enqueue_async(async_sink& target, log_level level, std::string&& message);
+
+// waits until every record queued so far is written or evicted
+RING_API void flush_async();
+// takes effect the next time writers start
+RING_API void configure_async(const log_service_config& config);
+// stops the writers and writes whatever is still queued on the calling thread
+RING_API void shutdown_async();
+
+} // namespace ring::logging::detail
+
+#endif // RING_LOGGING_ASYNC_LOG_HPP_
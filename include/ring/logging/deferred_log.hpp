@@ -0,0 +1,342 @@
+#ifndef RING_LOGGING_DEFERRED_LOG_HPP_
+#define RING_LOGGING_DEFERRED_LOG_HPP_
+
+#include <array>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <format>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <tuple>
+#include <type_traits>
+
+#if defined(_M_X64) || defined(_M_IX86)
+#include <intrin.h>
+#elif defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+#include "ring/core/cache_line.hpp"
+#include "ring/core/export.hpp"
+#include "ring/logging/logger.hpp"
+
+namespace ring::logging
+{
+
+namespace detail
+{
+
+// raw counter captured on the hot path; the backend converts it to wall time
+inline uint64_t log_timestamp() noexcept
+{
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    return static_cast<uint64_t>(std::chrono::steady_clock::now().time_since_epoch().count());
+#endif
+}
+
+// trivially copyable arguments travel as raw bytes
+template <typename T>
+struct log_arg_codec
+{
+    static_assert(std::is_trivially_copyable_v<T>,
+        "deferred log arguments must be trivially copyable or strings; format them eagerly instead");
+
+    using decoded_type = T;
+
+    static size_t size(const T&) noexcept
+    {
+        return sizeof(T);
+    }
+    static std::byte* encode(std::byte* out, const T& value) noexcept
+    {
+        std::memcpy(out, &value, sizeof(T));
+        return out + sizeof(T);
+    }
+    static T decode(const std::byte*& in) noexcept
+    {
+        std::array<std::byte, sizeof(T)> raw;
+        std::memcpy(raw.data(), in, sizeof(T));
+        in += sizeof(T);
+        return std::bit_cast<T>(raw);
+    }
+};
+
+// strings are copied as length + bytes and come back as views into the record
+struct log_string_codec
+{
+    using decoded_type = std::string_view;
+
+    static size_t size(std::string_view value) noexcept
+    {
+        return sizeof(uint32_t) + value.size();
+    }
+    static std::byte* encode(std::byte* out, std::string_view value) noexcept
+    {
+        auto length = static_cast<uint32_t>(value.size());
+        std::memcpy(out, &length, sizeof(length));
+        std::memcpy(out + sizeof(length), value.data(), length);
+        return out + sizeof(length) + length;
+    }
+    static std::string_view decode(const std::byte*& in) noexcept
+    {
+        uint32_t length = 0;
+        std::memcpy(&length, in, sizeof(length));
+        std::string_view value(reinterpret_cast<const char*>(in + sizeof(length)), length);
+        in += sizeof(length) + length;
+        return value;
+    }
+};
+
+template <> struct log_arg_codec<const char*> : log_string_codec {};
+template <> struct log_arg_codec<char*> : log_string_codec {};
+template <> struct log_arg_codec<std::string_view> : log_string_codec {};
+template <> struct log_arg_codec<std::string> : log_string_codec {};
+
+template <typename T>
+using log_codec_t = log_arg_codec<std::decay_t<T>>;
+
+using log_format_fn = std::string (*)(std::string_view format, const std::byte* payload);
+
+// runs on the backend thread; braced init decodes arguments left to right
+template <typename... Args>
+std::string format_log_payload(std::string_view format, [[maybe_unused]] const std::byte* payload)
+{
+    std::tuple<typename log_codec_t<Args>::decoded_type...> values{ log_codec_t<Args>::decode(payload)... };
+    return std::apply([&](auto&... value) { return std::vformat(format, std::make_format_args(value...)); }, values);
+}
+
+enum class log_record_kind : uint32_t
+{
+    skip,
+    deferred
+};
+
+struct log_record_header
+{
+    // whole record including the header, multiple of record_alignment
+    uint32_t size;
+    log_record_kind kind;
+    const log_site* site;
+    log_format_fn format;
+    logger* target;
+    uint64_t timestamp;
+    // the producer's id for %t; the backend thread formats the record
+    size_t thread_id;
+};
+
+constexpr size_t record_alignment = alignof(log_record_header);
+
+// Single-producer byte ring owned by one logging thread and drained by the
+// backend. Records never wrap: a skip record pads out the tail of the buffer.
+class RING_API log_channel final
+{
+public:
+    static constexpr size_t default_capacity = 1 << 20;
+public:
+    // constructed on the producing thread, which it takes its thread id from
+    explicit log_channel(size_t capacity = default_capacity) :
+        data_(ring::core::make_unique_buffer_aligned(std::bit_ceil(capacity))),
+        capacity_(std::bit_ceil(capacity)),
+        thread_id_(log_thread_id()) {}
+private:
+    log_channel(const log_channel&) = delete;
+    log_channel& operator=(const log_channel&) = delete;
+public:
+    // bytes is a multiple of record_alignment; nullptr when the ring is full
+    std::byte* try_reserve(size_t bytes) noexcept
+    {
+        size_t tail = tail_->load(std::memory_order_relaxed);
+        size_t offset = tail & (capacity_ - 1);
+        size_t contiguous = capacity_ - offset;
+        size_t needed = bytes <= contiguous ? bytes : contiguous + bytes;
+        if (tail + needed - cached_head_ > capacity_)
+        {
+            cached_head_ = head_->load(std::memory_order_acquire);
+            if (tail + needed - cached_head_ > capacity_)
+            {
+                return nullptr;
+            }
+        }
+        if (bytes > contiguous)
+        {
+            auto* skip = reinterpret_cast<log_record_header*>(data_.get() + offset);
+            skip->size = static_cast<uint32_t>(contiguous);
+            skip->kind = log_record_kind::skip;
+            tail += contiguous;
+            offset = 0;
+        }
+        reserved_ = tail;
+        return reinterpret_cast<std::byte*>(data_.get() + offset);
+    }
+
+    void commit(size_t bytes) noexcept
+    {
+        tail_->store(reserved_ + bytes, std::memory_order_release);
+    }
+
+    // consumer side: hands every published record to handler, then frees the space
+    template <typename Handler>
+    size_t drain(Handler&& handler)
+    {
+        size_t head = head_->load(std::memory_order_relaxed);
+        size_t tail = tail_->load(std::memory_order_acquire);
+        size_t count = 0;
+        while (head != tail)
+        {
+            auto* header = reinterpret_cast<const log_record_header*>(data_.get() + (head & (capacity_ - 1)));
+            if (header->kind != log_record_kind::skip)
+            {
+                handler(*header);
+                ++count;
+            }
+            head += header->size;
+        }
+        head_->store(head, std::memory_order_release);
+        return count;
+    }
+
+    size_t published() const noexcept
+    {
+        return tail_->load(std::memory_order_acquire);
+    }
+
+    size_t consumed() const noexcept
+    {
+        return head_->load(std::memory_order_acquire);
+    }
+
+    size_t capacity() const noexcept
+    {
+        return capacity_;
+    }
+
+    size_t thread_id() const noexcept
+    {
+        return thread_id_;
+    }
+private:
+    ring::core::buffer_aligned data_;
+    const size_t capacity_;
+    const size_t thread_id_;
+    ring::core::cache_aligned<std::atomic<size_t>> head_{ 0 };
+    ring::core::cache_aligned<std::atomic<size_t>> tail_{ 0 };
+    // producer-only state
+    size_t cached_head_ = 0;
+    size_t reserved_ = 0;
+};
+
+// creates and registers the calling thread's channel with the backend
+RING_API log_channel& register_log_channel();
+// waits until the records published so far on channel have been handed to their loggers
+RING_API void flush_log_channel(const log_channel& channel);
+
+inline log_channel& local_log_channel()
+{
+    static thread_local log_channel* channel = nullptr;
+    if (!channel)
+    {
+        channel = &register_log_channel();
+    }
+    return *channel;
+}
+
+} // namespace detail
+
+// Records a statement as a site pointer + raw argument bytes in the calling
+// thread's channel; formatting happens on the backend thread. Blocks only
+// when the channel is full. The target logger must outlive flush_deferred().
+template <typename... Args>
+void log_deferred(logger& target, const log_site& site, std::format_string<Args...>, Args&&... args)
+{
+    flight_recorder::instance().capture(site.level(), site.format(), args...);
+    if (!target.should_log(site.level()))
+    {
+        return;
+    }
+    size_t payload = (size_t{ 0 } + ... + detail::log_codec_t<Args>::size(args));
+    size_t bytes = (sizeof(detail::log_record_header) + payload + detail::record_alignment - 1) &
+        ~(detail::record_alignment - 1);
+    auto& channel = detail::local_log_channel();
+    if (bytes > channel.capacity() / 2)
+    {
+        // too large for the channel, so written in place; what this thread
+        // queued before it goes out first to keep its records in order
+        if (channel.consumed() != channel.published())
+        {
+            detail::flush_log_channel(channel);
+        }
+        target.log(site.level(), std::vformat(site.format(), std::make_format_args(args...)));
+        return;
+    }
+    uint64_t timestamp = detail::log_timestamp();
+    std::byte* out = nullptr;
+    while (!(out = channel.try_reserve(bytes)))
+    {
+        std::this_thread::yield();
+    }
+    auto* header = reinterpret_cast<detail::log_record_header*>(out);
+    header->size = static_cast<uint32_t>(bytes);
+    header->kind = detail::log_record_kind::deferred;
+    header->site = &site;
+    header->format = &detail::format_log_payload<Args...>;
+    header->target = &target;
+    header->timestamp = timestamp;
+    header->thread_id = channel.thread_id();
+    out += sizeof(detail::log_record_header);
+    ((out = detail::log_codec_t<Args>::encode(out, args)), ...);
+    channel.commit(bytes);
+}
+
+// waits until every record published so far has been formatted and handed to its logger
+RING_API void flush_deferred();
+
+} // namespace ring::logging
+
+#define RING_LOG_DEFERRED(logger, level, fmt, ...)                                                  \
+    do                                                                                              \
+    {                                                                                               \
+        RING_LOG_SITE_(ring_log_site_, level, fmt);                                                 \
+        if (ring_log_site_.enabled())                                                               \
+        {                                                                                           \
+            ::ring::logging::log_deferred(logger, ring_log_site_, fmt __VA_OPT__(,) __VA_ARGS__);   \
+        }                                                                                           \
+    } while (0)
+
+#if RING_ACTIVE_LOG_LEVEL <= RING_LOG_LEVEL_TRACE
+#define RING_DEFERRED_TRACE(logger, ...)    RING_LOG_DEFERRED(logger, ::ring::logging::log_level::trace, __VA_ARGS__)
+#else
+#define RING_DEFERRED_TRACE(...)            RING_LOG_STRIPPED_(__VA_ARGS__)
+#endif
+#if RING_ACTIVE_LOG_LEVEL <= RING_LOG_LEVEL_DEBUG
+#define RING_DEFERRED_DEBUG(logger, ...)    RING_LOG_DEFERRED(logger, ::ring::logging::log_level::debug, __VA_ARGS__)
+#else
+#define RING_DEFERRED_DEBUG(...)            RING_LOG_STRIPPED_(__VA_ARGS__)
+#endif
+#if RING_ACTIVE_LOG_LEVEL <= RING_LOG_LEVEL_INFO
+#define RING_DEFERRED_INFO(logger, ...)     RING_LOG_DEFERRED(logger, ::ring::logging::log_level::info, __VA_ARGS__)
+#else
+#define RING_DEFERRED_INFO(...)             RING_LOG_STRIPPED_(__VA_ARGS__)
+#endif
+#if RING_ACTIVE_LOG_LEVEL <= RING_LOG_LEVEL_WARN
+#define RING_DEFERRED_WARN(logger, ...)     RING_LOG_DEFERRED(logger, ::ring::logging::log_level::warn, __VA_ARGS__)
+#else
+#define RING_DEFERRED_WARN(...)             RING_LOG_STRIPPED_(__VA_ARGS__)
+#endif
+#if RING_ACTIVE_LOG_LEVEL <= RING_LOG_LEVEL_ERROR
+#define RING_DEFERRED_ERROR(logger, ...)    RING_LOG_DEFERRED(logger, ::ring::logging::log_level::error, __VA_ARGS__)
+#else
+#define RING_DEFERRED_ERROR(...)            RING_LOG_STRIPPED_(__VA_ARGS__)
+#endif
+#if RING_ACTIVE_LOG_LEVEL <= RING_LOG_LEVEL_CRITICAL
+#define RING_DEFERRED_CRITICAL(logger, ...) RING_LOG_DEFERRED(logger, ::ring::logging::log_level::critical, __VA_ARGS__)
+#else
+#define RING_DEFERRED_CRITICAL(...)         RING_LOG_STRIPPED_(__VA_ARGS__)
+#endif
+
+#endif // RING_LOGGING_DEFERRED_LOG_HPP_
@@ -0,0 +1,280 @@
+#ifndef RING_LOGGING_FLIGHT_RECORDER_HPP_
+#define RING_LOGGING_FLIGHT_RECORDER_HPP_
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+#include "ring/core/cache_line.hpp"
+#include "ring/core/export.hpp"
+#include "ring/logging/log_level.hpp"
+
+namespace ring::logging
+{
+
+struct flight_recorder_config
+{
+    // slots in each thread's ring; older records are overwritten
+    size_t records_per_thread = 4096;
+    // lowest level captured, independent of any logger's level
+    log_level level = log_level::trace;
+    // how many of the newest records a dump writes
+    size_t dump_records = 1024;
+};
+
+namespace detail
+{
+
+enum class flight_arg : uint8_t
+{
+    none,
+    signed_integer,
+    unsigned_integer,
+    floating,
+    boolean,
+    character,
+    string,
+    pointer,
+    // captured as a placeholder: the type has no compact encoding
+    unsupported
+};
+
+// One captured statement. Arguments are packed into payload; a string is a
+// one-byte length and its (possibly cut) bytes.
+struct alignas(64) flight_slot
+{
+    static constexpr size_t max_args = 8;
+
+    // even when complete, odd while the owner thread writes it
+    std::atomic<uint64_t> sequence{ 0 };
+    int64_t time = 0;
+    const char* format = nullptr;
+    uint32_t format_size = 0;
+    uint32_t thread_id = 0;
+    uint8_t level = 0;
+    uint8_t arg_count = 0;
+    uint8_t payload_size = 0;
+    uint8_t truncated = 0;
+    flight_arg types[max_args] = {};
+    std::byte payload[84];
+};
+
+static_assert(sizeof(flight_slot) == 128);
+
+// A thread's ring. Rings are never freed: when a thread exits its ring is
+// handed to the next new thread, and its old records stay dumpable.
+struct flight_ring
+{
+    flight_ring* next = nullptr;
+    std::atomic<bool> in_use{ true };
+    // current owner, copied into each record
+    uint32_t thread_id = 0;
+    size_t capacity = 0;
+    ring::core::buffer_aligned storage;
+    flight_slot* slots = nullptr;
+    // records written so far; the newest is slots[(head - 1) % capacity]
+    std::atomic<uint64_t> head{ 0 };
+    // dump-only state: [0] for dump(), [1] for the crash handler, so a crash
+    // can dump while an on-demand dump is still walking the rings
+    uint64_t cursor[2] = {};
+    uint64_t floor[2] = {};
+};
+
+class flight_writer
+{
+public:
+    explicit flight_writer(flight_slot& slot) :
+        slot_(slot) {}
+public:
+    template <typename T>
+    void add(const T& value)
+    {
+        using type = std::remove_cvref_t<T>;
+        if (slot_.arg_count == flight_slot::max_args)
+        {
+            slot_.truncated = 1;
+            return;
+        }
+        if constexpr (std::is_same_v<type, bool>)
+        {
+            put(flight_arg::boolean, static_cast<uint8_t>(value));
+        }
+        else if constexpr (std::is_same_v<type, char>)
+        {
+            put(flight_arg::character, value);
+        }
+        else if constexpr (std::is_integral_v<type> && std::is_signed_v<type>)
+        {
+            put(flight_arg::signed_integer, static_cast<int64_t>(value));
+        }
+        else if constexpr (std::is_integral_v<type>)
+        {
+            put(flight_arg::unsigned_integer, static_cast<uint64_t>(value));
+        }
+        else if constexpr (std::is_floating_point_v<type>)
+        {
+            put(flight_arg::floating, static_cast<double>(value));
+        }
+        else if constexpr (std::is_convertible_v<const T&, std::string_view>)
+        {
+            if constexpr (std::is_pointer_v<type>)
+            {
+                if (!value)
+                {
+                    put_string("(null)");
+                    return;
+                }
+            }
+            put_string(std::string_view(value));
+        }
+        else if constexpr (std::is_pointer_v<std::decay_t<type>>)
+        {
+            put(flight_arg::pointer, reinterpret_cast<uint64_t>(static_cast<const void*>(value)));
+        }
+        else
+        {
+            slot_.types[slot_.arg_count++] = flight_arg::unsupported;
+        }
+    }
+private:
+    template <typename U>
+    void put(flight_arg type, U value)
+    {
+        if (slot_.payload_size + sizeof(U) > sizeof(slot_.payload))
+        {
+            slot_.truncated = 1;
+            slot_.arg_count = flight_slot::max_args;
+            return;
+        }
+        std::memcpy(slot_.payload + slot_.payload_size, &value, sizeof(U));
+        slot_.payload_size += sizeof(U);
+        slot_.types[slot_.arg_count++] = type;
+    }
+
+    void put_string(std::string_view value)
+    {
+        size_t room = sizeof(slot_.payload) - slot_.payload_size;
+        if (room < 2)
+        {
+            slot_.truncated = 1;
+            slot_.arg_count = flight_slot::max_args;
+            return;
+        }
+        size_t length = std::min(value.size(), room - 1);
+        slot_.truncated |= length < value.size();
+        slot_.payload[slot_.payload_size] = static_cast<std::byte>(length);
+        std::memcpy(slot_.payload + slot_.payload_size + 1, value.data(), length);
+        slot_.payload_size += static_cast<uint8_t>(length + 1);
+        slot_.types[slot_.arg_count++] = flight_arg::string;
+    }
+private:
+    flight_slot& slot_;
+};
+
+} // namespace detail
+
+// Always-on, in-memory capture of recent log statements. Each thread writes
+// compact binary records into its own ring without locks or I/O; a dump
+// writes the newest of them to a file using only async-signal-safe calls, so
+// it can run from a crash handler. Decode a dump with decode().
+class RING_API flight_recorder final
+{
+private:
+    flight_recorder() = default;
+    ~flight_recorder() = default;
+private:
+    flight_recorder(const flight_recorder&) = delete;
+    flight_recorder& operator=(const flight_recorder&) = delete;
+public:
+    static flight_recorder& instance()
+    {
+        static flight_recorder instance;
+        return instance;
+    }
+public:
+    void enable(const flight_recorder_config& config = {});
+    void disable();
+
+    bool captures(log_level level) const
+    {
+        return level >= level_.load(std::memory_order_relaxed);
+    }
+
+    template <typename... Args>
+    void capture(log_level level, std::string_view format, const Args&... args)
+    {
+        if (!captures(level))
+        {
+            return;
+        }
+        auto& ring = local_ring();
+        uint64_t index = ring.head.load(std::memory_order_relaxed);
+        auto& slot = ring.slots[index % ring.capacity];
+        uint64_t sequence = slot.sequence.load(std::memory_order_relaxed);
+        slot.sequence.store(sequence + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+
+        slot.time = std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::system_clock::now().time_since_epoch()).count();
+        slot.format = format.data();
+        slot.format_size = static_cast<uint32_t>(format.size());
+        slot.thread_id = ring.thread_id;
+        slot.level = static_cast<uint8_t>(level);
+        slot.arg_count = 0;
+        slot.payload_size = 0;
+        slot.truncated = 0;
+        std::memset(slot.types, 0, sizeof(slot.types));
+        detail::flight_writer writer(slot);
+        (writer.add(args), ...);
+
+        slot.sequence.store(sequence + 2, std::memory_order_release);
+        ring.head.store(index + 1, std::memory_order_release);
+    }
+
+    // Writes the newest dump_records records, newest first. Async-signal-safe;
+    // returns the number of records written, or 0 when the file can't be opened.
+    size_t dump(const char* path);
+    // dump() for the crash handler. It never waits for or skips on account of
+    // an on-demand dump in progress on another thread, so the crash isn't lost.
+    size_t dump_on_crash(const char* path);
+
+    // dumps to path on SIGSEGV, SIGBUS, SIGFPE, SIGILL and SIGABRT, then hands
+    // the signal to the previous handler
+    bool install_crash_handler(const char* path);
+    void remove_crash_handler();
+
+    // renders a dump as "[time] [level] [thread id] message" lines, oldest first
+    static std::vector<std::string> decode(const std::string& path);
+private:
+    detail::flight_ring& local_ring()
+    {
+        static thread_local detail::flight_ring* ring = nullptr;
+        if (!ring || ring->capacity != capacity_.load(std::memory_order_relaxed)) [[unlikely]]
+        {
+            ring = &acquire_ring(ring);
+        }
+        return *ring;
+    }
+
+    detail::flight_ring& acquire_ring(detail::flight_ring* previous);
+    size_t write_dump(const char* path, size_t pass);
+private:
+    // off until enable()
+    std::atomic<log_level> level_{ log_level::off };
+    std::atomic<size_t> capacity_{ 0 };
+    std::atomic<size_t> dump_records_{ 0 };
+    std::atomic<detail::flight_ring*> rings_{ nullptr };
+    std::atomic<bool> dumping_{ false };
+    std::atomic<bool> crash_dumping_{ false };
+};
+
+} // namespace ring::logging
+
+#endif // RING_LOGGING_FLIGHT_RECORDER_HPP_
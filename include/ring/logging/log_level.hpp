@@ -0,0 +1,20 @@
+#ifndef RING_LOGGING_LOG_LEVEL_HPP_
+#define RING_LOGGING_LOG_LEVEL_HPP_
+
+namespace ring::logging
+{
+
+enum class log_level
+{
+    trace,
+    debug,
+    info,
+    warn,
+    error,
+    critical,
+    off
+};
+
+} // namespace ring::logging
+
+#endif // RING_LOGGING_LOG_LEVEL_HPP_
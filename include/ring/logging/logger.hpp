@@ -1,24 +1,106 @@
 #ifndef RING_LOGGING_LOGGER_HPP_
 #define RING_LOGGING_LOGGER_HPP_
 
+#include <atomic>
+#include <chrono>
+#include <cstdint>
 #include <format>
 #include <memory>
+#include <source_location>
 #include <string>
+#include <string_view>
+#include <vector>
 
 #include "ring/core/export.hpp"
+#include "ring/logging/flight_recorder.hpp"
+#include "ring/logging/log_level.hpp"
 
 namespace ring::logging
 {
 
-enum class log_level
+// Static descriptor of one RING_* / RING_DEFERRED_* statement. A site
+// registers itself on its first hit; after that checking it costs a single
+// relaxed load, so sites can be switched off at runtime without a lock.
+class RING_API log_site final
 {
-    trace,
-    debug,
-    info,
-    warn,
-    error,
-    critical,
-    off
+private:
+    static constexpr uint8_t unregistered = 0;
+    static constexpr uint8_t enabled_state = 1;
+    static constexpr uint8_t disabled_state = 2;
+public:
+    constexpr log_site(log_level level, std::string_view format, std::source_location location) noexcept :
+        level_(level),
+        format_(format),
+        location_(location) {}
+private:
+    log_site(const log_site&) = delete;
+    log_site& operator=(const log_site&) = delete;
+public:
+    bool enabled()
+    {
+        uint8_t state = state_.load(std::memory_order_relaxed);
+        if (state == unregistered) [[unlikely]]
+        {
+            return register_site();
+        }
+        return state == enabled_state;
+    }
+    void set_enabled(bool enabled);
+
+    log_level level() const noexcept
+    {
+        return level_;
+    }
+    std::string_view format() const noexcept
+    {
+        return format_;
+    }
+    const std::source_location& location() const noexcept
+    {
+        return location_;
+    }
+private:
+    bool register_site();
+
+    friend size_t set_log_sites_enabled(std::string_view file, int line, bool enabled);
+private:
+    const log_level level_;
+    const std::string_view format_;
+    const std::source_location location_;
+    std::atomic<uint8_t> state_{ unregistered };
+};
+
+// every site hit so far
+RING_API std::vector<log_site*> log_sites();
+// Switches sites whose file ends with file (empty matches all) and, unless
+// line is 0, sit on that line. The rule also applies to sites registered
+// later. Returns the number of registered sites it matched.
+RING_API size_t set_log_sites_enabled(std::string_view file, int line, bool enabled);
+
+// what an async logger does when the calling thread's channel is full
+enum class overflow_policy
+{
+    // wait for the writers to make room
+    block,
+    // discard the record being logged
+    drop_newest,
+    // discard the oldest record this thread queued for an overwrite_oldest logger
+    overwrite_oldest
+};
+
+// how a logger's file records reach the disk
+enum class file_sink_mode
+{
+    // spdlog's rotating file sink: buffered stdio writes, flushed periodically
+    stream,
+    // a mapped_log_file: appends are memcpys, syncs batched on sync_interval
+    mapped
+};
+
+struct log_drop_stats
+{
+    uint64_t dropped = 0;
+    uint64_t overwritten = 0;
 };
 
 struct logger_config
@@ -31,6 +113,19 @@ struct logger_config
     bool console = true;
     std::string file = "";
     bool async = true;
+    overflow_policy overflow = overflow_policy::block;
+    file_sink_mode file_mode = file_sink_mode::stream;
+    // mapped files only; zero syncs on flush() alone
+    std::chrono::milliseconds sync_interval{ 1000 };
+};
+
+struct log_service_config
+{
+    // records per producing thread
+    size_t queue_size = 8192;
+    size_t writer_threads = 1;
+    // how often loggers that lost records say so; zero disables the report
+    std::chrono::milliseconds drop_report_interval{ 5000 };
 };
 
 class logger;
@@ -51,11 +146,22 @@ public:
     }
 public:
     void initialize();
+    void initialize(const log_service_config& config);
+    // Releases every logger, including the copies other threads cached for
+    // lock-free lookups. No other thread may be logging through the service
+    // while it runs.
     void shutdown();
     std::shared_ptr<logger> create_logger(const logger_config& config);
     std::shared_ptr<logger> get_default_logger();
+    // No lock and no reference count. The reference is only valid until the
+    // calling thread's next lookup through the service (which may pick up a
+    // reconfiguration and release the old logger) or shutdown(); keep
+    // get_default_logger() when it has to live longer.
+    logger& default_logger();
     std::shared_ptr<logger> get_logger(std::string_view name);
     void flush_all();
+    // writes the flight recorder's newest records to path; see flight_recorder::dump
+    size_t dump_flight_recorder(const std::string& path);
 public:
     class impl;
     std::unique_ptr<impl> impl_;
@@ -65,6 +171,7 @@ class RING_API logger final
 {
 public:
     logger(const std::string& name);
+    explicit logger(const logger_config& config);
     ~logger();
 private:
     logger(const logger&) = delete;
@@ -75,11 +182,20 @@ public:
     log_level level() const;
     const std::string& name() const;
     void flush();
+    // records lost to the overflow policy so far
+    log_drop_stats drop_stats() const;
 public:
     void log(log_level level, const std::string& message);
+    void log(log_level level, std::string&& message);
+    // already-formatted record captured earlier on another thread, e.g. by the
+    // deferred backend; thread_id is what %t prints, see detail::log_thread_id()
+    void log(log_level level, std::chrono::system_clock::time_point time, const char* file, int line,
+        size_t thread_id, std::string_view message);
     template <typename... Args>
     void log(log_level level, std::format_string<Args...> fmt, Args&&... args)
     {
+        // recorded below the logger's level too, so a dump shows what led up to a failure
+        flight_recorder::instance().capture(level, fmt.get(), args...);
         if (should_log(level))
         {
             log(level, std::format(fmt, std::forward<Args>(args)...));
@@ -88,32 +204,32 @@ public:
     template <typename... Args>
     void trace(std::format_string<Args...> fmt, Args&&... args)
     {
-        log(log_level::trace, std::format(fmt, std::forward<Args>(args)...));
+        log(log_level::trace, fmt, std::forward<Args>(args)...);
     }
     template <typename... Args>
     void debug(std::format_string<Args...> fmt, Args&&... args)
     {
-        log(log_level::debug, std::format(fmt, std::forward<Args>(args)...));
+        log(log_level::debug, fmt, std::forward<Args>(args)...);
     }
     template <typename... Args>
     void info(std::format_string<Args...> fmt, Args&&... args)
     {
-        log(log_level::info, std::format(fmt, std::forward<Args>(args)...));
+        log(log_level::info, fmt, std::forward<Args>(args)...);
     }
     template <typename... Args>
     void warn(std::format_string<Args...> fmt, Args&&... args)
     {
-        log(log_level::warn, std::format(fmt, std::forward<Args>(args)...));
+        log(log_level::warn, fmt, std::forward<Args>(args)...);
     }
     template <typename... Args>
     void error(std::format_string<Args...> fmt, Args&&... args)
     {
-        log(log_level::error, std::format(fmt, std::forward<Args>(args)...));
+        log(log_level::error, fmt, std::forward<Args>(args)...);
     }
     template <typename... Args>
     void critical(std::format_string<Args...> fmt, Args&&... args)
     {
-        log(log_level::critical, std::format(fmt, std::forward<Args>(args)...));
+        log(log_level::critical, fmt, std::forward<Args>(args)...);
     }
 private:
     class impl;
@@ -123,41 +239,118 @@ private:
 template <typename... Args>
 void trace(std::format_string<Args...> fmt, Args&&... args)
 {
-    log_service::instance().get_default_logger()->trace(fmt, std::forward<Args>(args)...);
+    log_service::instance().default_logger().trace(fmt, std::forward<Args>(args)...);
 }
 template <typename... Args>
 void debug(std::format_string<Args...> fmt, Args&&... args)
 {
-    log_service::instance().get_default_logger()->debug(fmt, std::forward<Args>(args)...);
+    log_service::instance().default_logger().debug(fmt, std::forward<Args>(args)...);
 }
 template <typename... Args>
 void info(std::format_string<Args...> fmt, Args&&... args)
 {
-    log_service::instance().get_default_logger()->info(fmt, std::forward<Args>(args)...);
+    log_service::instance().default_logger().info(fmt, std::forward<Args>(args)...);
 }
 template <typename... Args>
 void warn(std::format_string<Args...> fmt, Args&&... args)
 {
-    log_service::instance().get_default_logger()->warn(fmt, std::forward<Args>(args)...);
+    log_service::instance().default_logger().warn(fmt, std::forward<Args>(args)...);
 }
 template <typename... Args>
 void error(std::format_string<Args...> fmt, Args&&... args)
 {
-    log_service::instance().get_default_logger()->error(fmt, std::forward<Args>(args)...);
+    log_service::instance().default_logger().error(fmt, std::forward<Args>(args)...);
 }
 template <typename... Args>
 void critical(std::format_string<Args...> fmt, Args&&... args)
 {
-    log_service::instance().get_default_logger()->critical(fmt, std::forward<Args>(args)...);
+    log_service::instance().default_logger().critical(fmt, std::forward<Args>(args)...);
 }
 
+namespace detail
+{
+
+// the calling thread's id as %t prints it
+RING_API size_t log_thread_id();
+
+// only named inside sizeof by RING_LOG_STRIPPED_, never defined
+template <typename... Args>
+int log_stripped(Args&&...);
+
+template <typename... Args>
+void log_default(const log_site& site, std::format_string<Args...> fmt, Args&&... args)
+{
+    log_service::instance().default_logger().log(site.level(), fmt, std::forward<Args>(args)...);
+}
+
+} // namespace detail
+
 } // namespace ring::logging
 
-#define RING_TRACE(...)     ring::logging::trace(__VA_ARGS__)
-#define RING_DEBUG(...)     ring::logging::debug(__VA_ARGS__)
-#define RING_INFO(...)      ring::logging::info(__VA_ARGS__)
-#define RING_WARN(...)      ring::logging::warn(__VA_ARGS__)
-#define RING_ERROR(...)     ring::logging::error(__VA_ARGS__)
-#define RING_CRITICAL(...)  ring::logging::critical(__VA_ARGS__)
+// numeric levels for RING_ACTIVE_LOG_LEVEL; they follow log_level
+#define RING_LOG_LEVEL_TRACE    0
+#define RING_LOG_LEVEL_DEBUG    1
+#define RING_LOG_LEVEL_INFO     2
+#define RING_LOG_LEVEL_WARN     3
+#define RING_LOG_LEVEL_ERROR    4
+#define RING_LOG_LEVEL_CRITICAL 5
+#define RING_LOG_LEVEL_OFF      6
+
+// statements below this level compile to nothing; their arguments are never evaluated
+#ifndef RING_ACTIVE_LOG_LEVEL
+#define RING_ACTIVE_LOG_LEVEL RING_LOG_LEVEL_TRACE
+#endif
+
+#define RING_LOG_SITE_(name, level, fmt)                                                            \
+    static constinit ::ring::logging::log_site name(level, fmt, std::source_location::current())
+
+#define RING_LOG_AT_(level, fmt, ...)                                                               \
+    do                                                                                              \
+    {                                                                                               \
+        RING_LOG_SITE_(ring_log_site_, level, fmt);                                                 \
+        if (ring_log_site_.enabled())                                                               \
+        {                                                                                           \
+            ::ring::logging::detail::log_default(ring_log_site_, fmt __VA_OPT__(,) __VA_ARGS__);    \
+        }                                                                                           \
+    } while (0)
+
+// Compiled-out statement. The arguments stay in an unevaluated sizeof, so
+// nothing runs but variables used only for logging don't trip -Wunused.
+#define RING_LOG_STRIPPED_(...)                                                                     \
+    do                                                                                              \
+    {                                                                                               \
+        (void)sizeof(::ring::logging::detail::log_stripped(__VA_ARGS__));                           \
+    } while (0)
+
+#if RING_ACTIVE_LOG_LEVEL <= RING_LOG_LEVEL_TRACE
+#define RING_TRACE(...)     RING_LOG_AT_(::ring::logging::log_level::trace, __VA_ARGS__)
+#else
+#define RING_TRACE(...)     RING_LOG_STRIPPED_(__VA_ARGS__)
+#endif
+#if RING_ACTIVE_LOG_LEVEL <= RING_LOG_LEVEL_DEBUG
+#define RING_DEBUG(...)     RING_LOG_AT_(::ring::logging::log_level::debug, __VA_ARGS__)
+#else
+#define RING_DEBUG(...)     RING_LOG_STRIPPED_(__VA_ARGS__)
+#endif
+#if RING_ACTIVE_LOG_LEVEL <= RING_LOG_LEVEL_INFO
+#define RING_INFO(...)      RING_LOG_AT_(::ring::logging::log_level::info, __VA_ARGS__)
+#else
+#define RING_INFO(...)      RING_LOG_STRIPPED_(__VA_ARGS__)
+#endif
+#if RING_ACTIVE_LOG_LEVEL <= RING_LOG_LEVEL_WARN
+#define RING_WARN(...)      RING_LOG_AT_(::ring::logging::log_level::warn, __VA_ARGS__)
+#else
+#define RING_WARN(...)      RING_LOG_STRIPPED_(__VA_ARGS__)
+#endif
+#if RING_ACTIVE_LOG_LEVEL <= RING_LOG_LEVEL_ERROR
+#define RING_ERROR(...)     RING_LOG_AT_(::ring::logging::log_level::error, __VA_ARGS__)
+#else
+#define RING_ERROR(...)     RING_LOG_STRIPPED_(__VA_ARGS__)
+#endif
+#if RING_ACTIVE_LOG_LEVEL <= RING_LOG_LEVEL_CRITICAL
+#define RING_CRITICAL(...)  RING_LOG_AT_(::ring::logging::log_level::critical, __VA_ARGS__)
+#else
+#define RING_CRITICAL(...)  RING_LOG_STRIPPED_(__VA_ARGS__)
+#endif
 
 #endif // RING_LOGGING_LOGGER_HPP_
\ No newline at end of file
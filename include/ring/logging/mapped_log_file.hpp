@@ -0,0 +1,61 @@
+#ifndef RING_LOGGING_MAPPED_LOG_FILE_HPP_
+#define RING_LOGGING_MAPPED_LOG_FILE_HPP_
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+
+#include "ring/core/export.hpp"
+
+namespace ring::logging
+{
+
+struct mapped_log_file_config
+{
+    std::string path;
+    // bytes preallocated per segment; a full segment rotates to path.1, path.2, ...
+    size_t segment_size = 100ul * 1024 * 1024;
+    // rotated segments kept besides path
+    size_t max_files = 1024;
+    // how often written bytes are synced in the background; zero leaves it to sync()
+    std::chrono::milliseconds sync_interval{ 1000 };
+};
+
+// Append-only log file made of preallocated, memory-mapped segments. An
+// append is a memcpy into the active segment; a background thread maps the
+// next segment ahead of time, trims and renames full ones, and syncs written
+// pages on the configured cadence. A live segment keeps its preallocated size,
+// so the file ends in zero bytes until it is rotated or closed. An existing
+// file at path is rotated away on open, and path.pending.* segments left by a
+// crashed process are removed.
+class RING_API mapped_log_file final
+{
+public:
+    explicit mapped_log_file(const mapped_log_file_config& config);
+    ~mapped_log_file();
+private:
+    mapped_log_file(const mapped_log_file&) = delete;
+    mapped_log_file& operator=(const mapped_log_file&) = delete;
+public:
+    // Callers serialize appends. A record is never split across segments
+    // unless it is larger than a whole segment.
+    void append(std::string_view data);
+    // Blocks until everything appended so far is written back, including
+    // rotated segments. Safe to call alongside append().
+    void sync();
+
+    const std::string& path() const;
+    // segments the appending thread had to create itself because the
+    // background one was not ready yet
+    uint64_t inline_segments() const;
+private:
+    class impl;
+    std::unique_ptr<impl> impl_;
+};
+
+} // namespace ring::logging
+
+#endif // RING_LOGGING_MAPPED_LOG_FILE_HPP_
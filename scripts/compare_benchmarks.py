@@ -0,0 +1,58 @@
+#!/usr/bin/env python3
+# scripts/compare_benchmarks.py
+#
+# Compares two bench_queue_suite --json outputs and exits non-zero when any
+# configuration lost throughput or gained p99 latency beyond the threshold.
+#
+#   compare_benchmarks.py baseline.json current.json [--threshold 10]
+
+import argparse
+import json
+import sys
+
+KEY_FIELDS = ("queue", "producers", "consumers", "batch", "payload", "pinning")
+
+
+def load(path):
+    with open(path) as f:
+        results = json.load(f)["results"]
+    return {tuple(r[k] for k in KEY_FIELDS): r for r in results}
+
+
+def change(before, after):
+    return (after - before) / before * 100.0 if before else 0.0
+
+
+def main():
+    parser = argparse.ArgumentParser(description="flag queue benchmark regressions")
+    parser.add_argument("baseline")
+    parser.add_argument("current")
+    parser.add_argument("--threshold", type=float, default=10.0,
+                        help="allowed regression in percent (default: 10)")
+    args = parser.parse_args()
+
+    baseline = load(args.baseline)
+    current = load(args.current)
+
+    regressions = 0
+    print(f"{'configuration':<44} {'Mops/s':>16} {'push p99':>16} {'pop p99':>16}")
+    for key in sorted(baseline.keys() & current.keys()):
+        old, new = baseline[key], current[key]
+        mops = change(old["mops"], new["mops"])
+        push = change(old["push_ns"]["p99"], new["push_ns"]["p99"])
+        pop = change(old["pop_ns"]["p99"], new["pop_ns"]["p99"])
+        flagged = mops < -args.threshold or push > args.threshold or pop > args.threshold
+        regressions += flagged
+        name = "{} {}p/{}c batch={} payload={} {}".format(*key)
+        print(f"{name:<44} {new['mops']:>8.2f} ({mops:+5.1f}%) {new['push_ns']['p99']:>7.0f} ({push:+5.1f}%) "
+              f"{new['pop_ns']['p99']:>7.0f} ({pop:+5.1f}%){'  REGRESSION' if flagged else ''}")
+
+    for key in sorted(baseline.keys() - current.keys()):
+        print(f"missing from current run: {key}")
+
+    print(f"{regressions} regression(s) beyond {args.threshold:.0f}%")
+    return 1 if regressions else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
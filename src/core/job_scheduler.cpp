@@ -0,0 +1,331 @@
+#include "ring/core/job_scheduler.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "ring/core/exception.hpp"
+#include "ring/core/initializer_registry.hpp"
+#include "ring/core/lockfree_queue.hpp"
+#include "ring/core/wait_strategy.hpp"
+#include "ring/core/work_stealing_deque.hpp"
+
+namespace ring::core
+{
+
+class job_scheduler::impl final
+{
+private:
+    static constexpr size_t cache_batch = 64;
+    static constexpr size_t depot_capacity = 4096;
+    static constexpr uint32_t spin_limit = 64;
+
+    struct worker
+    {
+        explicit worker(size_t capacity, uint64_t seed) :
+            deque(capacity),
+            rng(seed) {}
+
+        work_stealing_deque<detail::job*> deque;
+        uint64_t rng;
+        std::thread thread;
+    };
+
+    // jobs are recycled per thread; surplus batches travel through the shared depot
+    struct job_cache
+    {
+        ~job_cache()
+        {
+            for (detail::job* job : jobs)
+            {
+                delete job;
+            }
+        }
+
+        std::vector<detail::job*> jobs;
+    };
+public:
+    impl() :
+        depot_(depot_capacity) {}
+
+    ~impl()
+    {
+        shutdown();
+        detail::job* job = nullptr;
+        while (depot_.try_pop(job))
+        {
+            delete job;
+        }
+    }
+public:
+    void initialize(const job_scheduler_config& config)
+    {
+        std::lock_guard lock(mutex_);
+        if (running_.load(std::memory_order_relaxed))
+        {
+            throw ring::core::exception("already initialized");
+        }
+        size_t count = config.workers;
+        if (count == 0)
+        {
+            count = std::max<size_t>(1, std::thread::hardware_concurrency()) - 1;
+            count = std::max<size_t>(count, 1);
+        }
+        injection_ = std::make_unique<mpmc_queue<detail::job*>>(config.injection_capacity);
+        stopping_.store(false, std::memory_order_relaxed);
+        for (size_t i = 0; i < count; ++i)
+        {
+            workers_.emplace_back(std::make_unique<worker>(config.deque_capacity, 0x9e3779b97f4a7c15ull * (i + 1)));
+        }
+        running_.store(true, std::memory_order_release);
+        for (auto& w : workers_)
+        {
+            w->thread = std::thread([this, self = w.get()]() { run(self); });
+        }
+    }
+
+    void shutdown()
+    {
+        std::lock_guard lock(mutex_);
+        if (!running_.load(std::memory_order_relaxed))
+        {
+            return;
+        }
+        stopping_.store(true, std::memory_order_seq_cst);
+        idle_->notify_all();
+        for (auto& w : workers_)
+        {
+            w->thread.join();
+        }
+        workers_.clear();
+        detail::job* job = nullptr;
+        while (injection_->try_pop(job))
+        {
+            execute(job);
+        }
+        injection_.reset();
+        running_.store(false, std::memory_order_release);
+    }
+
+    size_t worker_count() const
+    {
+        return running_.load(std::memory_order_acquire) ? workers_.size() : 0;
+    }
+
+    detail::job* allocate_job()
+    {
+        if (!running_.load(std::memory_order_acquire))
+        {
+            throw ring::core::exception("job scheduler is not initialized");
+        }
+        auto& jobs = cache_.jobs;
+        if (jobs.empty())
+        {
+            detail::job* batch[cache_batch];
+            size_t count = depot_.try_pop_batch(batch, cache_batch);
+            if (count == 0)
+            {
+                return new detail::job;
+            }
+            jobs.insert(jobs.end(), batch, batch + count);
+        }
+        detail::job* job = jobs.back();
+        jobs.pop_back();
+        return job;
+    }
+
+    void submit(detail::job* job)
+    {
+        if (current_)
+        {
+            current_->deque.push(job);
+        }
+        else
+        {
+            for (uint32_t spins = 0; !injection_->try_push(job); ++spins)
+            {
+                // the injection queue is full: make progress instead of blocking
+                if (detail::job* other = find_job(nullptr))
+                {
+                    execute(other);
+                }
+                else if (spins < spin_limit)
+                {
+                    detail::cpu_relax();
+                }
+                else
+                {
+                    std::this_thread::yield();
+                }
+            }
+        }
+        idle_->notify_one();
+    }
+
+    void wait(job_counter& counter)
+    {
+        for (uint32_t spins = 0; !counter.done(); )
+        {
+            if (detail::job* job = find_job(current_))
+            {
+                execute(job);
+                spins = 0;
+            }
+            else if (++spins < spin_limit)
+            {
+                detail::cpu_relax();
+            }
+            else
+            {
+                std::this_thread::yield();
+            }
+        }
+    }
+private:
+    void run(worker* self)
+    {
+        current_ = self;
+        for (;;)
+        {
+            if (detail::job* job = find_job(self))
+            {
+                execute(job);
+                continue;
+            }
+            uint32_t epoch = idle_->prepare_wait();
+            if (detail::job* job = find_job(self))
+            {
+                idle_->cancel_wait();
+                execute(job);
+                continue;
+            }
+            if (stopping_.load(std::memory_order_seq_cst))
+            {
+                idle_->cancel_wait();
+                break;
+            }
+            idle_->commit_wait(epoch);
+        }
+        current_ = nullptr;
+    }
+
+    detail::job* find_job(worker* self)
+    {
+        detail::job* job = nullptr;
+        if (self && self->deque.pop(job))
+        {
+            return job;
+        }
+        if (injection_->try_pop(job))
+        {
+            return job;
+        }
+        size_t count = workers_.size();
+        uint64_t& rng = self ? self->rng : steal_rng_;
+        for (size_t attempt = 0; attempt < count; ++attempt)
+        {
+            rng ^= rng << 13;
+            rng ^= rng >> 7;
+            rng ^= rng << 17;
+            worker* victim = workers_[rng % count].get();
+            if (victim != self && victim->deque.steal(job))
+            {
+                return job;
+            }
+        }
+        return nullptr;
+    }
+
+    void execute(detail::job* job)
+    {
+        job_counter* counter = job->counter;
+        job->invoke(*job);
+        release_job(job);
+        if (counter)
+        {
+            counter->pending_.fetch_sub(1, std::memory_order_release);
+        }
+    }
+
+    void release_job(detail::job* job)
+    {
+        auto& jobs = cache_.jobs;
+        jobs.push_back(job);
+        if (jobs.size() >= 2 * cache_batch)
+        {
+            auto first = jobs.end() - cache_batch;
+            size_t pushed = depot_.try_push_batch(first, jobs.end());
+            std::for_each(first + pushed, jobs.end(), [](detail::job* job) { delete job; });
+            jobs.erase(first, jobs.end());
+        }
+    }
+private:
+    static thread_local worker* current_;
+    static thread_local job_cache cache_;
+    static thread_local uint64_t steal_rng_;
+private:
+    std::mutex mutex_;
+    std::atomic<bool> running_{ false };
+    std::atomic<bool> stopping_{ false };
+    std::vector<std::unique_ptr<worker>> workers_;
+    std::unique_ptr<mpmc_queue<detail::job*>> injection_;
+    mpmc_queue<detail::job*> depot_;
+    cache_aligned<detail::event_count> idle_;
+};
+
+thread_local job_scheduler::impl::worker* job_scheduler::impl::current_ = nullptr;
+thread_local job_scheduler::impl::job_cache job_scheduler::impl::cache_;
+thread_local uint64_t job_scheduler::impl::steal_rng_ = 0x2545f4914f6cdd1dull;
+
+job_scheduler::job_scheduler() :
+    impl_(std::make_unique<impl>()) {}
+
+job_scheduler::~job_scheduler() {}
+
+void job_scheduler::initialize(const job_scheduler_config& config)
+{
+    impl_->initialize(config);
+}
+
+void job_scheduler::shutdown()
+{
+    impl_->shutdown();
+}
+
+void job_scheduler::register_initializer(const job_scheduler_config& config, int priority)
+{
+    initializer_registry::instance().register_entry("job_scheduler",
+        [this, config]() { initialize(config); },
+        [this]() { shutdown(); },
+        priority);
+}
+
+size_t job_scheduler::worker_count() const
+{
+    return impl_->worker_count();
+}
+
+size_t job_scheduler::concurrency() const
+{
+    return impl_->worker_count() + 1;
+}
+
+void job_scheduler::wait(job_counter& counter)
+{
+    impl_->wait(counter);
+}
+
+detail::job* job_scheduler::allocate_job()
+{
+    return impl_->allocate_job();
+}
+
+void job_scheduler::submit(detail::job* job)
+{
+    impl_->submit(job);
+}
+
+} // namespace ring::core
@@ -0,0 +1,213 @@
+#include "ring/core/memory_policy.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <new>
+
+#ifdef RING_PLATFORM_LINUX
+#include <linux/mempolicy.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#include "ring/core/cache_line.hpp"
+
+namespace ring::core
+{
+
+namespace
+{
+
+constexpr size_t huge_page_size = 2 * 1024 * 1024;
+
+std::mutex default_mutex;
+memory_policy default_policy;
+// bumped under default_mutex on every set
+std::atomic<uint64_t> default_version{ 0 };
+
+size_t round_up(size_t value, size_t alignment)
+{
+    return (value + alignment - 1) / alignment * alignment;
+}
+
+void touch_pages(void* data, size_t size, size_t page)
+{
+    auto* bytes = static_cast<volatile std::byte*>(data);
+    for (size_t offset = 0; offset < size; offset += page)
+    {
+        bytes[offset] = std::byte{ 0 };
+    }
+}
+
+} // namespace
+
+void set_default_memory_policy(const memory_policy& policy)
+{
+    std::lock_guard lock(default_mutex);
+    default_policy = policy;
+    default_version.fetch_add(1, std::memory_order_release);
+}
+
+memory_policy default_memory_policy()
+{
+    static thread_local uint64_t seen = ~uint64_t{ 0 };
+    static thread_local memory_policy cached;
+    if (default_version.load(std::memory_order_acquire) != seen) [[unlikely]]
+    {
+        std::lock_guard lock(default_mutex);
+        cached = default_policy;
+        seen = default_version.load(std::memory_order_relaxed);
+    }
+    return cached;
+}
+
+#ifdef RING_PLATFORM_LINUX
+
+namespace
+{
+
+void* map_anonymous(size_t size, int flags)
+{
+    void* data = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | flags, -1, 0);
+    return data == MAP_FAILED ? nullptr : data;
+}
+
+// over-maps by one alignment unit and trims, e.g. so THP can back the whole range
+void* map_aligned(size_t size, size_t alignment)
+{
+    auto* raw = static_cast<std::byte*>(map_anonymous(size + alignment, 0));
+    if (!raw)
+    {
+        return nullptr;
+    }
+    auto* aligned = reinterpret_cast<std::byte*>(round_up(reinterpret_cast<uintptr_t>(raw), alignment));
+    if (aligned != raw)
+    {
+        ::munmap(raw, aligned - raw);
+    }
+    size_t tail = alignment - (aligned - raw);
+    if (tail)
+    {
+        ::munmap(aligned + size, tail);
+    }
+    return aligned;
+}
+
+void bind_node(void* data, size_t size, int node)
+{
+#ifdef SYS_mbind
+    if (node < 0 || node >= static_cast<int>(sizeof(unsigned long) * 8))
+    {
+        return;
+    }
+    unsigned long mask = 1ul << node;
+    ::syscall(SYS_mbind, data, size, MPOL_PREFERRED, &mask, sizeof(mask) * 8, 0);
+#else
+    (void)data;
+    (void)size;
+    (void)node;
+#endif
+}
+
+} // namespace
+
+int current_numa_node()
+{
+    unsigned cpu = 0;
+    unsigned node = 0;
+#ifdef SYS_getcpu
+    if (::syscall(SYS_getcpu, &cpu, &node, nullptr) == 0)
+    {
+        return static_cast<int>(node);
+    }
+#endif
+    return 0;
+}
+
+namespace detail
+{
+
+page_allocation allocate_pages(size_t size, const memory_policy& policy, size_t alignment)
+{
+    page_allocation result;
+    size_t page = static_cast<size_t>(::sysconf(_SC_PAGESIZE));
+    if (policy.pages == page_mode::explicit_huge && alignment <= huge_page_size)
+    {
+        size_t mapped = round_up(size, huge_page_size);
+        if (void* data = map_anonymous(mapped, MAP_HUGETLB))
+        {
+            result = { data, mapped, page_mode::explicit_huge };
+        }
+    }
+    if (!result.data && policy.pages != page_mode::standard)
+    {
+        size_t mapped = round_up(size, huge_page_size);
+        if (void* data = map_aligned(mapped, std::max(alignment, huge_page_size)))
+        {
+            bool advised = ::madvise(data, mapped, MADV_HUGEPAGE) == 0;
+            result = { data, mapped, advised ? page_mode::transparent_huge : page_mode::standard };
+        }
+    }
+    if (!result.data)
+    {
+        size_t mapped = round_up(size, page);
+        void* data = alignment <= page ? map_anonymous(mapped, 0) : map_aligned(mapped, alignment);
+        if (!data)
+        {
+            throw std::bad_alloc();
+        }
+        result = { data, mapped, page_mode::standard };
+    }
+
+    if (policy.numa_node != memory_policy::any_node)
+    {
+        bind_node(result.data, result.mapped,
+            policy.numa_node == memory_policy::local_node ? current_numa_node() : policy.numa_node);
+    }
+    if (policy.prefault)
+    {
+        touch_pages(result.data, result.mapped, page);
+    }
+    return result;
+}
+
+void release_pages(void* data, size_t mapped)
+{
+    ::munmap(data, mapped);
+}
+
+} // namespace detail
+
+#else
+
+int current_numa_node()
+{
+    return 0;
+}
+
+namespace detail
+{
+
+page_allocation allocate_pages(size_t size, const memory_policy& policy, size_t alignment)
+{
+    void* data = ::operator new(size, std::align_val_t{ std::max(alignment, cache_line_size) });
+    if (policy.prefault)
+    {
+        touch_pages(data, size, 4096);
+    }
+    return { data, 0, page_mode::standard };
+}
+
+void release_pages(void* data, size_t)
+{
+    ::operator delete(data, cache_line_alignment);
+}
+
+} // namespace detail
+
+#endif
+
+} // namespace ring::core
@@ -0,0 +1,161 @@
+#include "ring/core/shared_memory.hpp"
+
+#include <thread>
+
+#ifdef RING_PLATFORM_LINUX
+#include <cerrno>
+#include <csignal>
+#include <ctime>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "ring/core/exception.hpp"
+
+namespace ring::core
+{
+
+#ifdef RING_PLATFORM_LINUX
+
+namespace
+{
+
+std::string normalize_name(std::string_view name)
+{
+    std::string result(name);
+    if (result.empty() || result.front() != '/')
+    {
+        result.insert(result.begin(), '/');
+    }
+    return result;
+}
+
+} // namespace
+
+shared_memory_region::shared_memory_region(std::string_view name, shm_mode mode, size_t size,
+    std::chrono::milliseconds timeout) :
+    name_(normalize_name(name)),
+    owner_(mode == shm_mode::create)
+{
+    int fd = -1;
+    if (owner_)
+    {
+        if (size == 0)
+        {
+            throw ring::core::exception("shared memory size must not be zero");
+        }
+        fd = ::shm_open(name_.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+        if (fd == -1)
+        {
+            throw ring::core::exception("failed to create shared memory " + name_);
+        }
+        if (::ftruncate(fd, static_cast<off_t>(size)) == -1)
+        {
+            ::close(fd);
+            ::shm_unlink(name_.c_str());
+            throw ring::core::exception("failed to size shared memory " + name_);
+        }
+    }
+    else
+    {
+        auto deadline = std::chrono::steady_clock::now() + timeout;
+        for (;;)
+        {
+            fd = ::shm_open(name_.c_str(), O_RDWR, 0600);
+            if (fd != -1)
+            {
+                struct stat st{};
+                if (::fstat(fd, &st) == 0 && st.st_size > 0)
+                {
+                    size = static_cast<size_t>(st.st_size);
+                    break;
+                }
+                ::close(fd);
+            }
+            if (std::chrono::steady_clock::now() >= deadline)
+            {
+                throw ring::core::exception("failed to attach shared memory " + name_);
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    }
+    void* mem = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (mem == MAP_FAILED)
+    {
+        if (owner_)
+        {
+            ::shm_unlink(name_.c_str());
+        }
+        throw ring::core::exception("failed to map shared memory " + name_);
+    }
+    data_ = static_cast<std::byte*>(mem);
+    size_ = size;
+}
+
+shared_memory_region::~shared_memory_region()
+{
+    ::munmap(data_, size_);
+    if (owner_)
+    {
+        ::shm_unlink(name_.c_str());
+    }
+}
+
+bool shared_memory_region::remove(std::string_view name)
+{
+    return ::shm_unlink(normalize_name(name).c_str()) == 0;
+}
+
+int64_t shared_memory_region::monotonic_now()
+{
+    timespec ts{};
+    ::clock_gettime(CLOCK_MONOTONIC, &ts);
+    return static_cast<int64_t>(ts.tv_sec) * 1000000000 + ts.tv_nsec;
+}
+
+int32_t shared_memory_region::process_id()
+{
+    return static_cast<int32_t>(::getpid());
+}
+
+bool shared_memory_region::process_alive(int32_t pid)
+{
+    return pid > 0 && (::kill(pid, 0) == 0 || errno == EPERM);
+}
+
+#else
+
+shared_memory_region::shared_memory_region(std::string_view, shm_mode, size_t, std::chrono::milliseconds)
+{
+    throw ring::core::exception("shared memory is not supported on this platform");
+}
+
+shared_memory_region::~shared_memory_region() {}
+
+bool shared_memory_region::remove(std::string_view)
+{
+    return false;
+}
+
+int64_t shared_memory_region::monotonic_now()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+int32_t shared_memory_region::process_id()
+{
+    return 0;
+}
+
+bool shared_memory_region::process_alive(int32_t)
+{
+    return true;
+}
+
+#endif
+
+} // namespace ring::core
@@ -0,0 +1,241 @@
+#include "ring/core/slab_allocator.hpp"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <new>
+#include <utility>
+
+#include "ring/core/cache_line.hpp"
+#include "ring/core/object_pool.hpp"
+
+namespace ring::core
+{
+
+namespace
+{
+
+constexpr size_t stats_shards = 16;
+constexpr size_t peak_sample_interval = 64;
+constexpr size_t chunk_bytes = 256 * 1024;
+constexpr std::align_val_t large_alignment{ slab_allocator::max_alignment };
+
+template <size_t Size>
+struct slab_block
+{
+    // leaves the bytes uninitialised; object_pool_mt would otherwise zero every block
+    slab_block() {}
+
+    alignas(std::min(Size, slab_allocator::max_alignment)) std::byte data[Size];
+};
+
+// live and requested bytes are sharded per thread; peak is sampled from their sum
+class class_counters
+{
+private:
+    struct alignas(detail::cache_line_size) shard
+    {
+        std::atomic<int64_t> live{ 0 };
+        std::atomic<int64_t> requested{ 0 };
+        std::atomic<size_t> allocations{ 0 };
+    };
+public:
+    void on_allocate(size_t requested)
+    {
+        auto& local = shards_[detail::thread_index() % stats_shards];
+        local.live.fetch_add(1, std::memory_order_relaxed);
+        local.requested.fetch_add(static_cast<int64_t>(requested), std::memory_order_relaxed);
+        if (local.allocations.fetch_add(1, std::memory_order_relaxed) % peak_sample_interval == 0)
+        {
+            sample_peak();
+        }
+    }
+
+    void on_deallocate(size_t requested)
+    {
+        auto& local = shards_[detail::thread_index() % stats_shards];
+        local.live.fetch_sub(1, std::memory_order_relaxed);
+        local.requested.fetch_sub(static_cast<int64_t>(requested), std::memory_order_relaxed);
+    }
+
+    size_t sample_peak()
+    {
+        size_t current = live();
+        size_t peak = peak_->load(std::memory_order_relaxed);
+        while (current > peak && !peak_->compare_exchange_weak(peak, current, std::memory_order_relaxed))
+        {
+        }
+        return std::max(current, peak);
+    }
+
+    size_t live() const
+    {
+        return sum(&shard::live);
+    }
+
+    size_t requested() const
+    {
+        return sum(&shard::requested);
+    }
+private:
+    size_t sum(std::atomic<int64_t> shard::* field) const
+    {
+        int64_t total = 0;
+        for (const auto& entry : shards_)
+        {
+            total += (entry.*field).load(std::memory_order_relaxed);
+        }
+        return total > 0 ? static_cast<size_t>(total) : 0;
+    }
+private:
+    std::array<shard, stats_shards> shards_;
+    cache_aligned<std::atomic<size_t>> peak_{ 0 };
+};
+
+class size_class
+{
+public:
+    virtual ~size_class() = default;
+public:
+    virtual std::byte* allocate() = 0;
+    virtual void deallocate(std::byte* block) = 0;
+    virtual size_t block_size() const = 0;
+    virtual size_t reserved() const = 0;
+};
+
+template <size_t Size>
+class pooled_size_class final : public size_class
+{
+public:
+    pooled_size_class() :
+        pool_(std::max<size_t>(4, chunk_bytes / Size)) {}
+public:
+    std::byte* allocate() override
+    {
+        return pool_.acquire()->data;
+    }
+    void deallocate(std::byte* block) override
+    {
+        pool_.release(reinterpret_cast<slab_block<Size>*>(block));
+    }
+    size_t block_size() const override
+    {
+        return Size;
+    }
+    size_t reserved() const override
+    {
+        return pool_.capacity();
+    }
+private:
+    object_pool_mt<slab_block<Size>> pool_;
+};
+
+} // namespace
+
+class slab_allocator::impl final
+{
+public:
+    impl() :
+        impl(std::make_index_sequence<class_count>()) {}
+private:
+    template <size_t... Index>
+    explicit impl(std::index_sequence<Index...>) :
+        classes_{ std::make_unique<pooled_size_class<(min_block_size << Index)>>()... } {}
+public:
+    std::array<std::unique_ptr<size_class>, class_count> classes_;
+    std::array<class_counters, class_count> counters_;
+    class_counters large_;
+    cache_aligned<std::atomic<size_t>> large_bytes_{ 0 };
+};
+
+slab_allocator::slab_allocator() :
+    impl_(std::make_unique<impl>()) {}
+
+slab_allocator::~slab_allocator() = default;
+
+std::span<std::byte> slab_allocator::allocate(size_t size)
+{
+    if (size > max_block_size)
+    {
+        auto* block = static_cast<std::byte*>(::operator new(size, large_alignment));
+        impl_->large_.on_allocate(size);
+        impl_->large_bytes_->fetch_add(size, std::memory_order_relaxed);
+        return { block, size };
+    }
+    size_t index = class_index(size);
+    auto* block = impl_->classes_[index]->allocate();
+    impl_->counters_[index].on_allocate(size);
+    return { block, size };
+}
+
+void slab_allocator::deallocate(std::span<std::byte> buffer)
+{
+    if (!buffer.data())
+    {
+        return;
+    }
+    if (buffer.size() > max_block_size)
+    {
+        ::operator delete(buffer.data(), large_alignment);
+        impl_->large_.on_deallocate(buffer.size());
+        impl_->large_bytes_->fetch_sub(buffer.size(), std::memory_order_relaxed);
+        return;
+    }
+    size_t index = class_index(buffer.size());
+    impl_->classes_[index]->deallocate(buffer.data());
+    impl_->counters_[index].on_deallocate(buffer.size());
+}
+
+slab_stats slab_allocator::stats() const
+{
+    slab_stats result;
+    result.classes.reserve(class_count);
+    for (size_t i = 0; i < class_count; ++i)
+    {
+        auto& counters = impl_->counters_[i];
+        slab_class_stats entry;
+        entry.block_size = impl_->classes_[i]->block_size();
+        entry.live = counters.live();
+        entry.peak = counters.sample_peak();
+        entry.reserved = impl_->classes_[i]->reserved();
+        entry.requested_bytes = counters.requested();
+        size_t reserved_bytes = entry.reserved * entry.block_size;
+        if (reserved_bytes)
+        {
+            entry.fragmentation = 1.0 - static_cast<double>(std::min(entry.requested_bytes, reserved_bytes)) /
+                static_cast<double>(reserved_bytes);
+        }
+        result.classes.push_back(entry);
+    }
+    result.large_live = impl_->large_.live();
+    result.large_bytes = impl_->large_bytes_->load(std::memory_order_relaxed);
+    return result;
+}
+
+void* slab_memory_resource::do_allocate(size_t bytes, size_t alignment)
+{
+    if (alignment > slab_allocator::max_alignment)
+    {
+        return upstream_->allocate(bytes, alignment);
+    }
+    // a power-of-two block is aligned to min(block, max_alignment)
+    return allocator_.allocate(std::max(bytes, alignment)).data();
+}
+
+void slab_memory_resource::do_deallocate(void* ptr, size_t bytes, size_t alignment)
+{
+    if (alignment > slab_allocator::max_alignment)
+    {
+        upstream_->deallocate(ptr, bytes, alignment);
+        return;
+    }
+    allocator_.deallocate({ static_cast<std::byte*>(ptr), std::max(bytes, alignment) });
+}
+
+bool slab_memory_resource::do_is_equal(const std::pmr::memory_resource& other) const noexcept
+{
+    auto* slab = dynamic_cast<const slab_memory_resource*>(&other);
+    return slab && &slab->allocator_ == &allocator_;
+}
+
+} // namespace ring::core
@@ -0,0 +1,366 @@
+#include "ring/logging/async_log.hpp"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <condition_variable>
+#include <format>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "ring/core/lockfree_queue.hpp"
+
+namespace ring::logging::detail
+{
+
+namespace
+{
+
+// One producing thread's records for loggers sharing an overflow policy, so
+// evicting under overwrite_oldest never costs a block or drop_newest logger a
+// record. The queue is single-producer; its consumer side is guarded by a flag
+// so that the producer can evict its own oldest record while no writer is
+// draining it.
+struct async_channel
+{
+    async_channel(size_t capacity, size_t writer) :
+        queue(std::bit_ceil(capacity)),
+        thread_id(log_thread_id()),
+        writer(writer) {}
+
+    bool try_consume()
+    {
+        return !consuming.test_and_set(std::memory_order_acquire);
+    }
+
+    void end_consume()
+    {
+        consuming.clear(std::memory_order_release);
+    }
+
+    ring::core::spsc_queue<async_record> queue;
+    std::atomic_flag consuming;
+    // records queued, and records written or evicted; flush compares the two
+    std::atomic<uint64_t> pushed{ 0 };
+    std::atomic<uint64_t> consumed{ 0 };
+    // set when the producing thread exits; the channel goes once drained
+    std::atomic<bool> closed{ false };
+    // the producing thread, as %t prints it
+    const size_t thread_id;
+    const size_t writer;
+};
+
+struct channel_owner
+{
+    ~channel_owner()
+    {
+        if (channel)
+        {
+            channel->closed.store(true, std::memory_order_release);
+        }
+    }
+
+    std::shared_ptr<async_channel> channel;
+};
+
+struct sink_entry
+{
+    async_sink* sink;
+    log_drop_stats reported;
+};
+
+class async_backend final
+{
+private:
+    static constexpr size_t batch_size = 256;
+    static constexpr size_t policy_count = static_cast<size_t>(overflow_policy::overwrite_oldest) + 1;
+    static constexpr auto idle_interval = std::chrono::milliseconds(1);
+private:
+    async_backend() = default;
+    ~async_backend()
+    {
+        stop();
+    }
+private:
+    async_backend(const async_backend&) = delete;
+    async_backend& operator=(const async_backend&) = delete;
+public:
+    static async_backend& instance()
+    {
+        static async_backend instance;
+        return instance;
+    }
+public:
+    void configure(const log_service_config& config)
+    {
+        std::lock_guard lock(mutex_);
+        config_ = config;
+        config_.writer_threads = std::max<size_t>(config_.writer_threads, 1);
+    }
+
+    void add_sink(async_sink& sink)
+    {
+        std::lock_guard lock(mutex_);
+        sinks_.push_back({ &sink, sink.drop_stats() });
+        if (writers_.empty())
+        {
+            stop_ = false;
+            writer_count_ = config_.writer_threads;
+            for (size_t i = 0; i < writer_count_; ++i)
+            {
+                writers_.emplace_back([this, i]() { run(i); });
+            }
+            running_.store(true, std::memory_order_release);
+        }
+    }
+
+    void remove_sink(async_sink& sink)
+    {
+        flush();
+        std::lock_guard lock(mutex_);
+        std::erase_if(sinks_, [&](const sink_entry& entry) { return entry.sink == &sink; });
+    }
+
+    void enqueue(async_sink& target, log_level level, std::string&& message)
+    {
+        auto time = std::chrono::system_clock::now();
+        if (!running_.load(std::memory_order_acquire))
+        {
+            target.write(level, time, log_thread_id(), message);
+            return;
+        }
+        auto& channel = local_channel(target.policy());
+        async_record record{ &target, level, time, channel.thread_id, std::move(message) };
+        while (!channel.queue.try_push(std::move(record)))
+        {
+            if (target.policy() == overflow_policy::drop_newest)
+            {
+                target.count_dropped();
+                return;
+            }
+            if (target.policy() == overflow_policy::overwrite_oldest && channel.try_consume())
+            {
+                async_record oldest;
+                bool evicted = channel.queue.try_pop(oldest);
+                channel.end_consume();
+                if (evicted)
+                {
+                    oldest.target->count_overwritten();
+                    channel.consumed.fetch_add(1, std::memory_order_release);
+                }
+                continue;
+            }
+            if (!running_.load(std::memory_order_acquire))
+            {
+                target.write(record.level, record.time, record.thread_id, record.message);
+                return;
+            }
+            // an idle writer may be parked for idle_interval; don't wait that out
+            wake_.notify_all();
+            std::this_thread::yield();
+        }
+        channel.pushed.fetch_add(1, std::memory_order_release);
+    }
+
+    void flush()
+    {
+        std::unique_lock lock(mutex_);
+        if (writers_.empty())
+        {
+            drain_all();
+            return;
+        }
+        std::vector<std::pair<std::shared_ptr<async_channel>, uint64_t>> targets;
+        targets.reserve(channels_.size());
+        for (auto& channel : channels_)
+        {
+            targets.emplace_back(channel, channel->pushed.load(std::memory_order_acquire));
+        }
+        wake_.notify_all();
+        drained_.wait(lock, [&]()
+            {
+                return writers_.empty() || std::all_of(targets.begin(), targets.end(), [](const auto& target)
+                    {
+                        return target.first->consumed.load(std::memory_order_acquire) >= target.second;
+                    });
+            });
+    }
+
+    void stop()
+    {
+        std::vector<std::thread> writers;
+        {
+            std::lock_guard lock(mutex_);
+            running_.store(false, std::memory_order_release);
+            stop_ = true;
+            writers.swap(writers_);
+        }
+        wake_.notify_all();
+        for (auto& writer : writers)
+        {
+            writer.join();
+        }
+        drained_.notify_all();
+
+        std::lock_guard lock(mutex_);
+        drain_all();
+    }
+private:
+    async_channel& local_channel(overflow_policy policy)
+    {
+        static thread_local std::array<channel_owner, policy_count> owners;
+        auto& owner = owners[static_cast<size_t>(policy)];
+        if (!owner.channel) [[unlikely]]
+        {
+            std::lock_guard lock(mutex_);
+            owner.channel = std::make_shared<async_channel>(config_.queue_size, next_writer_++);
+            channels_.push_back(owner.channel);
+        }
+        return *owner.channel;
+    }
+
+    // writes what is queued in channel unless someone else is consuming it
+    static size_t drain(async_channel& channel, std::vector<async_record>& batch)
+    {
+        size_t total = 0;
+        while (true)
+        {
+            if (!channel.try_consume())
+            {
+                return total;
+            }
+            size_t count = channel.queue.try_pop_batch(batch.begin(), batch.size());
+            channel.end_consume();
+            if (!count)
+            {
+                return total;
+            }
+            for (size_t i = 0; i < count; ++i)
+            {
+                batch[i].target->write(batch[i].level, batch[i].time, batch[i].thread_id, batch[i].message);
+            }
+            channel.consumed.fetch_add(count, std::memory_order_release);
+            total += count;
+        }
+    }
+
+    // called with mutex_ held once no writer is running
+    void drain_all()
+    {
+        std::vector<async_record> batch(batch_size);
+        for (auto& channel : channels_)
+        {
+            drain(*channel, batch);
+        }
+    }
+
+    void run(size_t index)
+    {
+        std::vector<async_record> batch(batch_size);
+        std::vector<std::shared_ptr<async_channel>> mine;
+        std::unique_lock lock(mutex_);
+        auto last_report = std::chrono::steady_clock::now();
+        while (!stop_)
+        {
+            mine.clear();
+            for (auto& channel : channels_)
+            {
+                if (channel->writer % writer_count_ == index)
+                {
+                    mine.push_back(channel);
+                }
+            }
+            lock.unlock();
+
+            size_t count = 0;
+            for (auto& channel : mine)
+            {
+                count += drain(*channel, batch);
+            }
+
+            lock.lock();
+            std::erase_if(channels_, [](const auto& channel)
+                {
+                    return channel->closed.load(std::memory_order_acquire) &&
+                        channel->consumed.load(std::memory_order_acquire) == channel->pushed.load(std::memory_order_acquire);
+                });
+            auto now = std::chrono::steady_clock::now();
+            if (index == 0 && config_.drop_report_interval.count() && now - last_report >= config_.drop_report_interval)
+            {
+                report_drops();
+                last_report = now;
+            }
+            drained_.notify_all();
+            if (!count)
+            {
+                wake_.wait_for(lock, idle_interval);
+            }
+        }
+    }
+
+    // called with mutex_ held so no sink is unregistered underneath
+    void report_drops()
+    {
+        for (auto& entry : sinks_)
+        {
+            auto stats = entry.sink->drop_stats();
+            uint64_t dropped = stats.dropped - entry.reported.dropped;
+            uint64_t overwritten = stats.overwritten - entry.reported.overwritten;
+            if (dropped || overwritten)
+            {
+                entry.sink->write(log_level::warn, std::chrono::system_clock::now(), log_thread_id(),
+                    std::format("async log overflow: dropped {} newest and overwrote {} oldest records "
+                        "in the last {} ms", dropped, overwritten, config_.drop_report_interval.count()));
+                entry.reported = stats;
+            }
+        }
+    }
+private:
+    std::mutex mutex_;
+    std::condition_variable wake_;
+    std::condition_variable drained_;
+    log_service_config config_;
+    std::vector<std::shared_ptr<async_channel>> channels_;
+    std::vector<sink_entry> sinks_;
+    std::vector<std::thread> writers_;
+    size_t writer_count_ = 1;
+    size_t next_writer_ = 0;
+    std::atomic<bool> running_{ false };
+    bool stop_ = false;
+};
+
+} // namespace
+
+void register_async_sink(async_sink& sink)
+{
+    async_backend::instance().add_sink(sink);
+}
+
+void unregister_async_sink(async_sink& sink)
+{
+    async_backend::instance().remove_sink(sink);
+}
+
+void enqueue_async(async_sink& target, log_level level, std::string&& message)
+{
+    async_backend::instance().enqueue(target, level, std::move(message));
+}
+
+void flush_async()
+{
+    async_backend::instance().flush();
+}
+
+void configure_async(const log_service_config& config)
+{
+    async_backend::instance().configure(config);
+}
+
+void shutdown_async()
+{
+    async_backend::instance().stop();
+}
+
+} // namespace ring::logging::detail
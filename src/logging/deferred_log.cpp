@@ -0,0 +1,243 @@
+#include "ring/logging/deferred_log.hpp"
+
+#include <algorithm>
+#include <condition_variable>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace ring::logging
+{
+
+namespace detail
+{
+
+namespace
+{
+
+struct channel_entry
+{
+    log_channel channel;
+    // set when the producing thread exits; the entry goes once drained
+    std::atomic<bool> closed{ false };
+};
+
+// keeps the calling thread's channel alive until the thread exits
+struct channel_owner
+{
+    ~channel_owner()
+    {
+        if (entry)
+        {
+            entry->closed.store(true, std::memory_order_release);
+        }
+    }
+
+    std::shared_ptr<channel_entry> entry;
+};
+
+// maps raw log_timestamp() values to wall time, re-anchored about once a second
+class timestamp_clock
+{
+public:
+    timestamp_clock()
+    {
+        anchor();
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        calibrate();
+    }
+public:
+    std::chrono::system_clock::time_point to_time(uint64_t stamp) const
+    {
+        double delta = (static_cast<double>(stamp) - static_cast<double>(stamp_)) * ns_per_tick_;
+        return wall_ + std::chrono::duration_cast<std::chrono::system_clock::duration>(
+            std::chrono::nanoseconds(static_cast<int64_t>(delta)));
+    }
+
+    void update()
+    {
+        if (std::chrono::steady_clock::now() - steady_ >= std::chrono::seconds(1))
+        {
+            calibrate();
+        }
+    }
+private:
+    void anchor()
+    {
+        stamp_ = log_timestamp();
+        steady_ = std::chrono::steady_clock::now();
+        wall_ = std::chrono::system_clock::now();
+    }
+
+    void calibrate()
+    {
+        uint64_t stamp = log_timestamp();
+        auto steady = std::chrono::steady_clock::now();
+        auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(steady - steady_).count();
+        if (stamp > stamp_ && elapsed > 0)
+        {
+            ns_per_tick_ = static_cast<double>(elapsed) / static_cast<double>(stamp - stamp_);
+        }
+        anchor();
+    }
+private:
+    uint64_t stamp_ = 0;
+    std::chrono::steady_clock::time_point steady_;
+    std::chrono::system_clock::time_point wall_;
+    double ns_per_tick_ = 1.0;
+};
+
+// Owns every thread's channel and the single thread that drains, formats and
+// forwards their records. The mutex guards the registry only; producers never
+// take it after registering.
+class log_backend final
+{
+private:
+    static constexpr auto idle_interval = std::chrono::milliseconds(1);
+private:
+    log_backend() = default;
+    ~log_backend()
+    {
+        {
+            std::lock_guard lock(mutex_);
+            stop_ = true;
+        }
+        wake_.notify_all();
+        if (thread_.joinable())
+        {
+            thread_.join();
+        }
+    }
+private:
+    log_backend(const log_backend&) = delete;
+    log_backend& operator=(const log_backend&) = delete;
+public:
+    static log_backend& instance()
+    {
+        static log_backend instance;
+        return instance;
+    }
+public:
+    log_channel& register_channel()
+    {
+        static thread_local channel_owner owner;
+        auto entry = std::make_shared<channel_entry>();
+        {
+            std::lock_guard lock(mutex_);
+            entries_.push_back(entry);
+            if (!thread_.joinable())
+            {
+                thread_ = std::thread([this]() { run(); });
+            }
+        }
+        owner.entry = entry;
+        return entry->channel;
+    }
+
+    void flush()
+    {
+        std::unique_lock lock(mutex_);
+        if (!thread_.joinable())
+        {
+            return;
+        }
+        std::vector<std::pair<std::shared_ptr<channel_entry>, size_t>> targets;
+        targets.reserve(entries_.size());
+        for (auto& entry : entries_)
+        {
+            targets.emplace_back(entry, entry->channel.published());
+        }
+        wake_.notify_all();
+        drained_.wait(lock, [&]()
+            {
+                return stop_ || std::all_of(targets.begin(), targets.end(),
+                    [](const auto& target) { return target.first->channel.consumed() >= target.second; });
+            });
+    }
+
+    void flush(const log_channel& channel)
+    {
+        std::unique_lock lock(mutex_);
+        size_t target = channel.published();
+        wake_.notify_all();
+        drained_.wait(lock, [&]() { return stop_ || channel.consumed() >= target; });
+    }
+private:
+    void run()
+    {
+        timestamp_clock clock;
+        std::vector<std::shared_ptr<channel_entry>> snapshot;
+        std::unique_lock lock(mutex_);
+        while (!stop_)
+        {
+            snapshot = entries_;
+            lock.unlock();
+
+            size_t count = 0;
+            clock.update();
+            for (auto& entry : snapshot)
+            {
+                count += entry->channel.drain([&](const log_record_header& record) { forward(record, clock); });
+            }
+
+            lock.lock();
+            std::erase_if(entries_, [](const auto& entry)
+                {
+                    return entry->closed.load(std::memory_order_acquire) &&
+                        entry->channel.consumed() == entry->channel.published();
+                });
+            drained_.notify_all();
+            if (!count)
+            {
+                wake_.wait_for(lock, idle_interval);
+            }
+        }
+    }
+
+    static void forward(const log_record_header& record, const timestamp_clock& clock)
+    {
+        const auto* payload = reinterpret_cast<const std::byte*>(&record + 1);
+        std::string message;
+        try
+        {
+            message = record.format(record.site->format(), payload);
+        }
+        catch (const std::exception& e)
+        {
+            message = std::string("deferred log format failed: ") + e.what();
+        }
+        const auto& location = record.site->location();
+        record.target->log(record.site->level(), clock.to_time(record.timestamp), location.file_name(),
+            static_cast<int>(location.line()), record.thread_id, message);
+    }
+private:
+    std::mutex mutex_;
+    std::condition_variable wake_;
+    std::condition_variable drained_;
+    std::vector<std::shared_ptr<channel_entry>> entries_;
+    std::thread thread_;
+    bool stop_ = false;
+};
+
+} // namespace
+
+log_channel& register_log_channel()
+{
+    return log_backend::instance().register_channel();
+}
+
+void flush_log_channel(const log_channel& channel)
+{
+    log_backend::instance().flush(channel);
+}
+
+} // namespace detail
+
+void flush_deferred()
+{
+    detail::log_backend::instance().flush();
+}
+
+} // namespace ring::logging
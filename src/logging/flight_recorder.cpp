@@ -0,0 +1,582 @@
+#include "ring/logging/flight_recorder.hpp"
+
+#include <algorithm>
+#include <csignal>
+#include <format>
+#include <fstream>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <thread>
+#include <utility>
+
+#ifdef RING_PLATFORM_WINDOWS
+#include <fcntl.h>
+#include <io.h>
+#include <sys/stat.h>
+#else
+#include <fcntl.h>
+#include <signal.h>
+#include <unistd.h>
+#endif
+
+#ifdef RING_PLATFORM_LINUX
+#include <sys/syscall.h>
+#endif
+
+namespace ring::logging
+{
+
+namespace
+{
+
+constexpr char dump_magic[8] = { 'R', 'I', 'N', 'G', 'F', 'L', 'T', '1' };
+
+// fixed part of one record in a dump; followed by the payload, then the format string
+struct dump_record
+{
+    int64_t time;
+    uint32_t thread_id;
+    uint32_t format_size;
+    uint8_t level;
+    uint8_t arg_count;
+    uint8_t payload_size;
+    uint8_t truncated;
+    detail::flight_arg types[detail::flight_slot::max_args];
+    uint32_t reserved;
+};
+
+// a slot copied out under its sequence number
+struct slot_snapshot
+{
+    dump_record record;
+    const char* format;
+    std::byte payload[sizeof(detail::flight_slot::payload)];
+};
+
+// releases the calling thread's ring when it exits
+struct ring_owner
+{
+    ~ring_owner()
+    {
+        if (ring)
+        {
+            ring->in_use.store(false, std::memory_order_release);
+        }
+    }
+
+    detail::flight_ring* ring = nullptr;
+};
+
+uint32_t current_thread_id()
+{
+#ifdef RING_PLATFORM_LINUX
+    return static_cast<uint32_t>(::syscall(SYS_gettid));
+#else
+    return static_cast<uint32_t>(std::hash<std::thread::id>{}(std::this_thread::get_id()));
+#endif
+}
+
+#ifdef RING_PLATFORM_WINDOWS
+
+int open_dump(const char* path)
+{
+    return ::_open(path, _O_WRONLY | _O_CREAT | _O_TRUNC | _O_BINARY, _S_IREAD | _S_IWRITE);
+}
+
+bool write_all(int fd, const void* data, size_t size)
+{
+    return ::_write(fd, data, static_cast<unsigned>(size)) == static_cast<int>(size);
+}
+
+void close_dump(int fd)
+{
+    ::_close(fd);
+}
+
+#else
+
+int open_dump(const char* path)
+{
+    return ::open(path, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+}
+
+bool write_all(int fd, const void* data, size_t size)
+{
+    const auto* bytes = static_cast<const char*>(data);
+    while (size)
+    {
+        ssize_t written = ::write(fd, bytes, size);
+        if (written <= 0)
+        {
+            return false;
+        }
+        bytes += written;
+        size -= static_cast<size_t>(written);
+    }
+    return true;
+}
+
+void close_dump(int fd)
+{
+    ::close(fd);
+}
+
+#endif
+
+// only plain loads and copies: safe inside a signal handler
+bool read_slot(const detail::flight_ring& ring, uint64_t index, slot_snapshot& out)
+{
+    const auto& slot = ring.slots[index % ring.capacity];
+    uint64_t expected = 2 * (index / ring.capacity + 1);
+    if (slot.sequence.load(std::memory_order_acquire) != expected)
+    {
+        return false;
+    }
+    out.record = { slot.time, slot.thread_id, slot.format_size, slot.level, slot.arg_count, slot.payload_size,
+        slot.truncated, {}, 0 };
+    std::copy(std::begin(slot.types), std::end(slot.types), out.record.types);
+    out.format = slot.format;
+    std::copy(slot.payload, slot.payload + slot.payload_size, out.payload);
+    std::atomic_thread_fence(std::memory_order_acquire);
+    return slot.sequence.load(std::memory_order_relaxed) == expected;
+}
+
+constexpr int crash_signals[] = { SIGSEGV, SIGFPE, SIGILL, SIGABRT,
+#ifdef SIGBUS
+    SIGBUS
+#endif
+};
+
+char crash_path[4096];
+std::atomic<bool> crash_handler_installed{ false };
+
+#ifdef RING_PLATFORM_WINDOWS
+
+using signal_handler = void (*)(int);
+signal_handler previous_handlers[std::size(crash_signals)];
+
+void on_crash(int signal)
+{
+    flight_recorder::instance().dump_on_crash(crash_path);
+    for (size_t i = 0; i < std::size(crash_signals); ++i)
+    {
+        if (crash_signals[i] == signal)
+        {
+            std::signal(signal, previous_handlers[i] ? previous_handlers[i] : SIG_DFL);
+        }
+    }
+    std::raise(signal);
+}
+
+#else
+
+struct sigaction previous_actions[std::size(crash_signals)];
+// lets the handler run after a stack overflow on the thread that installed it
+alignas(16) char alternate_stack[64 * 1024];
+
+void on_crash(int signal)
+{
+    flight_recorder::instance().dump_on_crash(crash_path);
+    // put back whatever was there and let it see the signal once we return
+    for (size_t i = 0; i < std::size(crash_signals); ++i)
+    {
+        if (crash_signals[i] == signal)
+        {
+            ::sigaction(signal, &previous_actions[i], nullptr);
+        }
+    }
+    ::raise(signal);
+}
+
+#endif
+
+struct decoded_arg
+{
+    detail::flight_arg type = detail::flight_arg::none;
+    int64_t signed_value = 0;
+    uint64_t unsigned_value = 0;
+    double floating_value = 0;
+    std::string_view string_value;
+};
+
+std::string render_arg(const decoded_arg& arg, std::string_view spec)
+{
+    std::string pattern = "{:" + std::string(spec) + "}";
+    try
+    {
+        switch (arg.type)
+        {
+        case detail::flight_arg::signed_integer:
+        {
+            int64_t value = arg.signed_value;
+            return std::vformat(pattern, std::make_format_args(value));
+        }
+        case detail::flight_arg::unsigned_integer:
+        {
+            uint64_t value = arg.unsigned_value;
+            return std::vformat(pattern, std::make_format_args(value));
+        }
+        case detail::flight_arg::floating:
+        {
+            double value = arg.floating_value;
+            return std::vformat(pattern, std::make_format_args(value));
+        }
+        case detail::flight_arg::boolean:
+        {
+            bool value = arg.unsigned_value != 0;
+            return std::vformat(pattern, std::make_format_args(value));
+        }
+        case detail::flight_arg::character:
+        {
+            char value = static_cast<char>(arg.unsigned_value);
+            return std::vformat(pattern, std::make_format_args(value));
+        }
+        case detail::flight_arg::string:
+        {
+            std::string_view value = arg.string_value;
+            return std::vformat(pattern, std::make_format_args(value));
+        }
+        case detail::flight_arg::pointer:
+        {
+            const void* value = reinterpret_cast<const void*>(static_cast<uintptr_t>(arg.unsigned_value));
+            return std::vformat(pattern, std::make_format_args(value));
+        }
+        case detail::flight_arg::unsupported:
+            return "<?>";
+        default:
+            return "<truncated>";
+        }
+    }
+    catch (const std::exception&)
+    {
+        // the spec was written for the original type; fall back to the default presentation
+        return spec.empty() ? "<?>" : render_arg(arg, {});
+    }
+}
+
+std::vector<decoded_arg> decode_args(const dump_record& record, const std::byte* payload)
+{
+    std::vector<decoded_arg> args(record.arg_count);
+    size_t offset = 0;
+    for (size_t i = 0; i < args.size(); ++i)
+    {
+        auto& arg = args[i];
+        arg.type = record.types[i];
+        switch (arg.type)
+        {
+        case detail::flight_arg::signed_integer:
+            std::memcpy(&arg.signed_value, payload + offset, sizeof(int64_t));
+            offset += sizeof(int64_t);
+            break;
+        case detail::flight_arg::unsigned_integer:
+        case detail::flight_arg::pointer:
+            std::memcpy(&arg.unsigned_value, payload + offset, sizeof(uint64_t));
+            offset += sizeof(uint64_t);
+            break;
+        case detail::flight_arg::floating:
+            std::memcpy(&arg.floating_value, payload + offset, sizeof(double));
+            offset += sizeof(double);
+            break;
+        case detail::flight_arg::boolean:
+        case detail::flight_arg::character:
+            arg.unsigned_value = std::to_integer<uint8_t>(payload[offset]);
+            offset += 1;
+            break;
+        case detail::flight_arg::string:
+        {
+            size_t length = std::to_integer<uint8_t>(payload[offset]);
+            arg.string_value = std::string_view(reinterpret_cast<const char*>(payload + offset + 1), length);
+            offset += length + 1;
+            break;
+        }
+        default:
+            break;
+        }
+    }
+    return args;
+}
+
+// std::format replacement fields against the decoded arguments; nested fields are not supported
+std::string render_message(std::string_view format, const std::vector<decoded_arg>& args)
+{
+    std::string message;
+    size_t next_arg = 0;
+    for (size_t i = 0; i < format.size(); ++i)
+    {
+        char c = format[i];
+        if (c == '{' && i + 1 < format.size() && format[i + 1] == '{')
+        {
+            message += '{';
+            ++i;
+        }
+        else if (c == '}' && i + 1 < format.size() && format[i + 1] == '}')
+        {
+            message += '}';
+            ++i;
+        }
+        else if (c == '{')
+        {
+            size_t close = format.find('}', i);
+            if (close == std::string_view::npos)
+            {
+                message.append(format.substr(i));
+                break;
+            }
+            std::string_view field = format.substr(i + 1, close - i - 1);
+            size_t colon = field.find(':');
+            std::string_view id = field.substr(0, colon);
+            std::string_view spec = colon == std::string_view::npos ? std::string_view{} : field.substr(colon + 1);
+            size_t index = next_arg++;
+            if (!id.empty())
+            {
+                index = 0;
+                for (char digit : id)
+                {
+                    index = index * 10 + static_cast<size_t>(digit - '0');
+                }
+            }
+            message += index < args.size() ? render_arg(args[index], spec) : render_arg({}, spec);
+            i = close;
+        }
+        else
+        {
+            message += c;
+        }
+    }
+    return message;
+}
+
+std::string_view level_name(uint8_t level)
+{
+    constexpr std::string_view names[] = { "trace", "debug", "info", "warning", "error", "critical", "off" };
+    return level < std::size(names) ? names[level] : "unknown";
+}
+
+std::string format_time(int64_t since_epoch)
+{
+    using namespace std::chrono;
+    sys_time<nanoseconds> time{ nanoseconds(since_epoch) };
+    auto day = floor<days>(time);
+    year_month_day date{ day };
+    hh_mm_ss clock{ floor<microseconds>(time - day) };
+    return std::format("{:04}-{:02}-{:02} {:02}:{:02}:{:02}.{:06}", static_cast<int>(date.year()),
+        static_cast<unsigned>(date.month()), static_cast<unsigned>(date.day()), clock.hours().count(),
+        clock.minutes().count(), clock.seconds().count(), clock.subseconds().count());
+}
+
+} // namespace
+
+void flight_recorder::enable(const flight_recorder_config& config)
+{
+    dump_records_.store(config.dump_records, std::memory_order_relaxed);
+    capacity_.store(std::max<size_t>(config.records_per_thread, 1), std::memory_order_relaxed);
+    level_.store(config.level, std::memory_order_relaxed);
+}
+
+void flight_recorder::disable()
+{
+    level_.store(log_level::off, std::memory_order_relaxed);
+}
+
+detail::flight_ring& flight_recorder::acquire_ring(detail::flight_ring* previous)
+{
+    static thread_local ring_owner owner;
+    if (previous)
+    {
+        previous->in_use.store(false, std::memory_order_release);
+    }
+    size_t capacity = capacity_.load(std::memory_order_relaxed);
+    for (auto* ring = rings_.load(std::memory_order_acquire); ring; ring = ring->next)
+    {
+        bool idle = false;
+        if (ring->capacity == capacity && ring->in_use.compare_exchange_strong(idle, true, std::memory_order_acquire))
+        {
+            ring->thread_id = current_thread_id();
+            owner.ring = ring;
+            return *ring;
+        }
+    }
+
+    auto* ring = new detail::flight_ring;
+    ring->thread_id = current_thread_id();
+    ring->capacity = capacity;
+    ring->storage = ring::core::make_unique_buffer_aligned(capacity * sizeof(detail::flight_slot));
+    ring->slots = reinterpret_cast<detail::flight_slot*>(ring->storage.get());
+    std::uninitialized_default_construct_n(ring->slots, capacity);
+    ring->next = rings_.load(std::memory_order_relaxed);
+    while (!rings_.compare_exchange_weak(ring->next, ring, std::memory_order_release, std::memory_order_relaxed))
+    {
+    }
+    owner.ring = ring;
+    return *ring;
+}
+
+size_t flight_recorder::dump(const char* path)
+{
+    if (dumping_.exchange(true, std::memory_order_acquire))
+    {
+        return 0;
+    }
+    size_t written = write_dump(path, 0);
+    dumping_.store(false, std::memory_order_release);
+    return written;
+}
+
+size_t flight_recorder::dump_on_crash(const char* path)
+{
+    // only a second crash racing the first one is turned away
+    if (crash_dumping_.exchange(true, std::memory_order_acquire))
+    {
+        return 0;
+    }
+    size_t written = write_dump(path, 1);
+    crash_dumping_.store(false, std::memory_order_release);
+    return written;
+}
+
+size_t flight_recorder::write_dump(const char* path, size_t pass)
+{
+    int fd = open_dump(path);
+    if (fd < 0)
+    {
+        return 0;
+    }
+    write_all(fd, dump_magic, sizeof(dump_magic));
+
+    auto* first = rings_.load(std::memory_order_acquire);
+    for (auto* ring = first; ring; ring = ring->next)
+    {
+        ring->cursor[pass] = ring->head.load(std::memory_order_acquire);
+        ring->floor[pass] = ring->cursor[pass] > ring->capacity ? ring->cursor[pass] - ring->capacity : 0;
+    }
+
+    // merge the rings newest first until dump_records are out
+    size_t limit = dump_records_.load(std::memory_order_relaxed);
+    size_t written = 0;
+    slot_snapshot best;
+    slot_snapshot candidate;
+    while (written < limit)
+    {
+        detail::flight_ring* source = nullptr;
+        for (auto* ring = first; ring; ring = ring->next)
+        {
+            while (ring->cursor[pass] > ring->floor[pass])
+            {
+                if (read_slot(*ring, ring->cursor[pass] - 1, candidate))
+                {
+                    if (!source || candidate.record.time > best.record.time)
+                    {
+                        source = ring;
+                        best = candidate;
+                    }
+                    break;
+                }
+                // torn or already overwritten, and so is everything older
+                ring->floor[pass] = ring->cursor[pass];
+            }
+        }
+        if (!source)
+        {
+            break;
+        }
+        --source->cursor[pass];
+        if (!write_all(fd, &best.record, sizeof(best.record)) ||
+            !write_all(fd, best.payload, best.record.payload_size) ||
+            !write_all(fd, best.format, best.record.format_size))
+        {
+            break;
+        }
+        ++written;
+    }
+
+    close_dump(fd);
+    return written;
+}
+
+bool flight_recorder::install_crash_handler(const char* path)
+{
+    size_t length = std::char_traits<char>::length(path);
+    if (length >= sizeof(crash_path) || crash_handler_installed.exchange(true))
+    {
+        return false;
+    }
+    std::copy(path, path + length + 1, crash_path);
+#ifdef RING_PLATFORM_WINDOWS
+    for (size_t i = 0; i < std::size(crash_signals); ++i)
+    {
+        previous_handlers[i] = std::signal(crash_signals[i], on_crash);
+    }
+#else
+    stack_t stack{};
+    stack.ss_sp = alternate_stack;
+    stack.ss_size = sizeof(alternate_stack);
+    ::sigaltstack(&stack, nullptr);
+
+    struct sigaction action{};
+    action.sa_handler = on_crash;
+    action.sa_flags = SA_ONSTACK;
+    sigemptyset(&action.sa_mask);
+    for (size_t i = 0; i < std::size(crash_signals); ++i)
+    {
+        ::sigaction(crash_signals[i], &action, &previous_actions[i]);
+    }
+#endif
+    return true;
+}
+
+void flight_recorder::remove_crash_handler()
+{
+    if (!crash_handler_installed.exchange(false))
+    {
+        return;
+    }
+    for (size_t i = 0; i < std::size(crash_signals); ++i)
+    {
+#ifdef RING_PLATFORM_WINDOWS
+        std::signal(crash_signals[i], previous_handlers[i] ? previous_handlers[i] : SIG_DFL);
+#else
+        ::sigaction(crash_signals[i], &previous_actions[i], nullptr);
+#endif
+    }
+}
+
+std::vector<std::string> flight_recorder::decode(const std::string& path)
+{
+    std::ifstream file(path, std::ios::binary);
+    char magic[sizeof(dump_magic)] = {};
+    if (!file.read(magic, sizeof(magic)) || !std::equal(std::begin(magic), std::end(magic), dump_magic))
+    {
+        return {};
+    }
+
+    std::vector<std::pair<int64_t, std::string>> records;
+    dump_record record;
+    std::byte payload[sizeof(detail::flight_slot::payload)];
+    std::string format;
+    while (file.read(reinterpret_cast<char*>(&record), sizeof(record)))
+    {
+        format.resize(record.format_size);
+        if (record.payload_size > sizeof(payload) ||
+            !file.read(reinterpret_cast<char*>(payload), record.payload_size) ||
+            !file.read(format.data(), record.format_size))
+        {
+            break;
+        }
+        auto message = render_message(format, decode_args(record, payload));
+        records.emplace_back(record.time, std::format("[{}] [{}] [thread {}] {}{}", format_time(record.time),
+            level_name(record.level), record.thread_id, message, record.truncated ? " [truncated]" : ""));
+    }
+
+    std::stable_sort(records.begin(), records.end(),
+        [](const auto& l, const auto& r) { return l.first < r.first; });
+    std::vector<std::string> lines;
+    lines.reserve(records.size());
+    for (auto& [_, line] : records)
+    {
+        lines.push_back(std::move(line));
+    }
+    return lines;
+}
+
+} // namespace ring::logging
@@ -0,0 +1,103 @@
+#include "ring/logging/logger.hpp"
+
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace ring::logging
+{
+
+namespace
+{
+
+struct site_rule
+{
+    std::string file;
+    int line;
+    bool enabled;
+
+    bool matches(const log_site& site) const
+    {
+        std::string_view name = site.location().file_name();
+        return name.ends_with(file) && (line == 0 || static_cast<int>(site.location().line()) == line);
+    }
+};
+
+// sites are never unregistered: they are function-local statics
+class site_registry final
+{
+public:
+    static site_registry& instance()
+    {
+        static site_registry instance;
+        return instance;
+    }
+public:
+    std::mutex mutex;
+    std::vector<log_site*> sites;
+    // applied in order, so a later rule overrides an earlier one
+    std::vector<site_rule> rules;
+};
+
+} // namespace
+
+void log_site::set_enabled(bool enabled)
+{
+    auto& registry = site_registry::instance();
+    std::lock_guard lock(registry.mutex);
+    if (state_.load(std::memory_order_relaxed) == unregistered)
+    {
+        registry.sites.push_back(this);
+    }
+    state_.store(enabled ? enabled_state : disabled_state, std::memory_order_relaxed);
+}
+
+bool log_site::register_site()
+{
+    auto& registry = site_registry::instance();
+    std::lock_guard lock(registry.mutex);
+    uint8_t state = state_.load(std::memory_order_relaxed);
+    if (state == unregistered)
+    {
+        bool enabled = true;
+        for (const auto& rule : registry.rules)
+        {
+            if (rule.matches(*this))
+            {
+                enabled = rule.enabled;
+            }
+        }
+        registry.sites.push_back(this);
+        state = enabled ? enabled_state : disabled_state;
+        state_.store(state, std::memory_order_relaxed);
+    }
+    return state == enabled_state;
+}
+
+std::vector<log_site*> log_sites()
+{
+    auto& registry = site_registry::instance();
+    std::lock_guard lock(registry.mutex);
+    return registry.sites;
+}
+
+size_t set_log_sites_enabled(std::string_view file, int line, bool enabled)
+{
+    auto& registry = site_registry::instance();
+    std::lock_guard lock(registry.mutex);
+    site_rule rule{ std::string(file), line, enabled };
+    size_t count = 0;
+    for (auto* site : registry.sites)
+    {
+        if (rule.matches(*site))
+        {
+            site->state_.store(enabled ? log_site::enabled_state : log_site::disabled_state, std::memory_order_relaxed);
+            ++count;
+        }
+    }
+    std::erase_if(registry.rules, [&](const site_rule& old) { return old.file == rule.file && old.line == rule.line; });
+    registry.rules.push_back(std::move(rule));
+    return count;
+}
+
+} // namespace ring::logging
@@ -1,16 +1,21 @@
 #include "ring/logging/logger.hpp"
 
+#include <atomic>
 #include <memory>
 #include <unordered_map>
 #include <mutex>
 
 #include <spdlog/spdlog.h>
+#include <spdlog/details/os.h>
+#include <spdlog/pattern_formatter.h>
 #include <spdlog/sinks/stdout_color_sinks.h>
 #include <spdlog/sinks/basic_file_sink.h>
 #include <spdlog/sinks/rotating_file_sink.h>
-#include <spdlog/async.h>
 
 #include "ring/core/exception.hpp"
+#include "ring/logging/async_log.hpp"
+#include "ring/logging/deferred_log.hpp"
+#include "ring/logging/mapped_log_file.hpp"
 
 namespace ring::logging
 {
@@ -45,9 +50,58 @@ log_level from_spdlog_level(spdlog::level::level_enum level)
     }
 }
 
-struct log_service_config
+// Exposes spdlog's sink dispatch, so a record written on a backend thread can
+// carry the id of the thread that logged it instead of the writer's.
+class record_logger final : public spdlog::logger
 {
-    size_t queue_size = 8192;
+public:
+    using spdlog::logger::logger;
+public:
+    void write(const spdlog::details::log_msg& msg)
+    {
+        if (should_log(msg.level))
+        {
+            sink_it_(msg);
+        }
+    }
+};
+
+// Formats into a reused buffer and appends it to a mapped_log_file. The
+// mutex only orders writer threads; nothing here makes a syscall per record.
+class mapped_file_sink final : public spdlog::sinks::sink
+{
+public:
+    mapped_file_sink(const mapped_log_file_config& config) :
+        file_(config),
+        formatter_(std::make_unique<spdlog::pattern_formatter>()) {}
+public:
+    void log(const spdlog::details::log_msg& msg) override
+    {
+        std::lock_guard lock(mutex_);
+
+        buffer_.clear();
+        formatter_->format(msg, buffer_);
+        file_.append({ buffer_.data(), buffer_.size() });
+    }
+    void flush() override
+    {
+        file_.sync();
+    }
+    void set_pattern(const std::string& pattern) override
+    {
+        set_formatter(std::make_unique<spdlog::pattern_formatter>(pattern));
+    }
+    void set_formatter(std::unique_ptr<spdlog::formatter> formatter) override
+    {
+        std::lock_guard lock(mutex_);
+
+        formatter_ = std::move(formatter);
+    }
+private:
+    std::mutex mutex_;
+    mapped_log_file file_;
+    std::unique_ptr<spdlog::formatter> formatter_;
+    spdlog::memory_buf_t buffer_;
 };
 
 class log_service::impl final
@@ -55,6 +109,9 @@ class log_service::impl final
 public:
     impl()
     {
+        // constructed first so both backends outlive this service
+        flush_deferred();
+        detail::configure_async(service_config_);
         initialize();
     }
     ~impl()
@@ -67,19 +124,34 @@ public:
         std::lock_guard lock(mutex_);
 
         spdlog::drop_all();
-        spdlog::flush_on(spdlog::level::warn);
-        spdlog::flush_every(std::chrono::seconds(3));
 
         auto logger = create_logger_impl({ .name = "", .pattern = "[%Y-%m-%d %H:%M:%S.%e] [%l] [thread %t] %v" });
         default_logger_ = logger;
+        publish();
+    }
+    void initialize(const log_service_config& config)
+    {
+        {
+            std::lock_guard lock(mutex_);
+
+            service_config_ = config;
+            detail::configure_async(config);
+        }
+        initialize();
     }
     void shutdown()
     {
+        flush_deferred();
+        detail::shutdown_async();
+
         std::lock_guard lock(mutex_);
 
         loggers_.clear();
         default_logger_.reset();
+        publish();
+        release_caches();
         spdlog::shutdown();
+        periodic_flush_ = false;
     }
     std::shared_ptr<logger> create_logger(const logger_config& config)
     {
@@ -90,36 +162,52 @@ public:
         {
             throw ring::core::exception("Logger with name '" + config.name + "' already exists.");
         }
-        return create_logger_impl(config);
+        auto logger = create_logger_impl(config);
+        publish();
+        return logger;
     }
     void set_default_logger(std::shared_ptr<logger> logger)
     {
         std::lock_guard lock(mutex_);
 
         default_logger_ = logger;
+        publish();
     }
     std::shared_ptr<logger> get_default_logger()
     {
-        std::lock_guard lock(mutex_);
-
-        return default_logger_;
+        return current().default_logger;
+    }
+    logger& default_logger()
+    {
+        return *current().default_logger;
     }
     std::shared_ptr<logger> get_logger(std::string_view name)
     {
-        std::lock_guard lock(mutex_);
-        
-        auto it = loggers_.find(name.data());
-        if (it != loggers_.end())
+        const auto& loggers = current().loggers;
+        auto it = loggers.find(name);
+        if (it != loggers.end())
         {
             return it->second;
         }
-        auto logger = create_logger_impl({ .name = name.data() });
+
+        std::lock_guard lock(mutex_);
+
+        // another thread may have created it since our snapshot
+        auto found = loggers_.find(name);
+        if (found != loggers_.end())
+        {
+            return found->second;
+        }
+        auto logger = create_logger_impl({ .name = std::string(name) });
+        publish();
         return logger;
     }
     void flush_all()
     {
+        flush_deferred();
+
         std::lock_guard lock(mutex_);
-        
+
         for (auto& [_, logger] : loggers_)
         {
             logger->flush();
@@ -135,39 +223,41 @@ private:
             console_sink->set_pattern(config.pattern);
             sinks.push_back(console_sink);
         }
-        if (!config.file.empty())
+        if (!config.file.empty() && config.file_mode == file_sink_mode::mapped)
         {
-            auto file_sink = std::make_shared<spdlog::sinks::rotating_file_sink_mt>(
-                config.file, config.max_file_size, config.max_files);
+            auto file_sink = std::make_shared<mapped_file_sink>(mapped_log_file_config{ .path = config.file,
+                .segment_size = config.max_file_size, .max_files = config.max_files,
+                .sync_interval = config.sync_interval });
             file_sink->set_pattern(config.pattern);
             sinks.push_back(file_sink);
         }
-        std::shared_ptr<spdlog::logger> spd_logger;
-        if (config.async)
+        else if (!config.file.empty())
         {
-            if (!spdlog::thread_pool())
+            auto file_sink = std::make_shared<spdlog::sinks::rotating_file_sink_mt>(
+                config.file, config.max_file_size, config.max_files);
+            file_sink->set_pattern(config.pattern);
+            sinks.push_back(file_sink);
+            // stdio buffers need a periodic flush; mapped files sync on their own cadence
+            if (!periodic_flush_)
             {
-                spdlog::init_thread_pool(service_config_.queue_size, 1);
+                spdlog::flush_every(std::chrono::seconds(3));
+                periodic_flush_ = true;
             }
-
-            spd_logger = std::make_shared<spdlog::async_logger>(
-                config.name, sinks.begin(), sinks.end(), 
-                spdlog::thread_pool(), spdlog::async_overflow_policy::block);
-        }
-        else
-        {
-            spd_logger = std::make_shared<spdlog::logger>(config.name, sinks.begin(), sinks.end());
         }
+        // async loggers hand records to the writer threads, which call the sinks directly
+        auto spd_logger = std::make_shared<record_logger>(config.name, sinks.begin(), sinks.end());
         spd_logger->set_level(to_spdlog_level(config.level));
         spdlog::register_logger(spd_logger);
 
-        auto logger = std::make_shared<ring::logging::logger>(spd_logger->name());
+        auto logger = std::make_shared<ring::logging::logger>(config);
         loggers_[config.name] = logger;
         return logger;
     }
 private:
     struct string_hash
     {
+        using is_transparent = void;
+
         size_t operator()(std::string_view view) const
         {
             return std::hash<std::string_view>{}(view);
@@ -175,16 +265,102 @@ private:
     };
     struct string_equal
     {
+        using is_transparent = void;
+
         bool operator()(std::string_view l, std::string_view r) const
         {
             return l == r;
         }
     };
+    using logger_map = std::unordered_map<std::string, std::shared_ptr<logger>, string_hash, string_equal>;
+
+    // immutable copy of the registry that readers use without locking
+    struct snapshot
+    {
+        logger_map loggers;
+        std::shared_ptr<logger> default_logger;
+    };
+
+    struct snapshot_cache;
+
+    // every thread's cache, so shutdown() can drop snapshots held by idle threads
+    struct cache_registry
+    {
+        std::mutex mutex;
+        std::vector<snapshot_cache*> caches;
+    };
+
+    struct snapshot_cache
+    {
+        ~snapshot_cache()
+        {
+            if (registry)
+            {
+                std::lock_guard lock(registry->mutex);
+
+                std::erase(registry->caches, this);
+            }
+        }
+
+        uint64_t version = 0;
+        std::shared_ptr<const snapshot> current;
+        // kept alive by the cache too, as threads may outlive the service
+        std::shared_ptr<cache_registry> registry;
+    };
+private:
+    // called with mutex_ held after every change to loggers_ or default_logger_
+    void publish()
+    {
+        snapshot_ = std::make_shared<const snapshot>(snapshot{ loggers_, default_logger_ });
+        version_.fetch_add(1, std::memory_order_release);
+    }
+
+    // Each thread keeps the last snapshot it saw and only takes the lock when
+    // the version moved. An old snapshot lives on until every thread holding
+    // it has refreshed, so references handed out stay valid meanwhile. A
+    // reconfiguration is picked up lazily, but shutdown() drops every cached
+    // snapshot, so idle threads don't keep old loggers and their files open.
+    const snapshot& current()
+    {
+        static thread_local snapshot_cache cache;
+        if (cache.version != version_.load(std::memory_order_acquire)) [[unlikely]]
+        {
+            std::lock_guard lock(mutex_);
+
+            if (!cache.registry)
+            {
+                cache.registry = caches_;
+                std::lock_guard registry_lock(caches_->mutex);
+
+                caches_->caches.push_back(&cache);
+            }
+            cache.current = snapshot_;
+            cache.version = version_.load(std::memory_order_relaxed);
+        }
+        return *cache.current;
+    }
+
+    // called with mutex_ held, while no other thread is logging
+    void release_caches()
+    {
+        std::lock_guard lock(caches_->mutex);
+
+        for (auto* cache : caches_->caches)
+        {
+            cache->current.reset();
+            cache->version = 0;
+        }
+    }
 private:
     std::mutex mutex_;
     log_service_config service_config_;
-    std::unordered_map<std::string, std::shared_ptr<logger>, string_hash, string_equal> loggers_;
+    logger_map loggers_;
     std::shared_ptr<logger> default_logger_;
+    std::shared_ptr<const snapshot> snapshot_;
+    // starts above the zero that marks a released cache
+    std::atomic<uint64_t> version_{ 1 };
+    std::shared_ptr<cache_registry> caches_ = std::make_shared<cache_registry>();
+    bool periodic_flush_ = false;
 };
 
 log_service::log_service() :
@@ -197,6 +373,11 @@ void log_service::initialize()
     impl_->initialize();
 }
 
+void log_service::initialize(const log_service_config& config)
+{
+    impl_->initialize(config);
+}
+
 void log_service::shutdown()
 {
     impl_->shutdown();
@@ -212,6 +393,11 @@ std::shared_ptr<logger> log_service::get_default_logger()
     return impl_->get_default_logger();
 }
 
+logger& log_service::default_logger()
+{
+    return impl_->default_logger();
+}
+
 std::shared_ptr<logger> log_service::get_logger(std::string_view name)
 {
     return impl_->get_logger(name);
@@ -222,11 +408,19 @@ void log_service::flush_all()
     impl_->flush_all();
 }
 
-class logger::impl final
+size_t log_service::dump_flight_recorder(const std::string& path)
+{
+    flush_all();
+    return flight_recorder::instance().dump(path.c_str());
+}
+
+class logger::impl final : public detail::async_sink
 {
 public:
-    impl(const std::string& name) :
-        name_(name)
+    impl(const std::string& name, bool async, overflow_policy overflow) :
+        async_sink(overflow),
+        name_(name),
+        async_(async)
     {
         auto spd_logger = spdlog::get(name_);
         if (!spd_logger)
@@ -234,10 +428,21 @@ public:
             throw ring::core::exception("spdlog logger with name '" + name_ + "' does not exist.");
         }
         spd_logger_ = spd_logger;
+        // null for spdlog loggers registered outside the service
+        record_logger_ = dynamic_cast<record_logger*>(spd_logger_.get());
+        if (async_)
+        {
+            detail::register_async_sink(*this);
+        }
     }
     ~impl()
     {
-        if (spd_logger_)
+        if (async_)
+        {
+            detail::unregister_async_sink(*this);
+        }
+        // a logger of the same name may have been created after a reinitialize
+        if (spd_logger_ && spdlog::get(spd_logger_->name()) == spd_logger_)
         {
             spdlog::drop(spd_logger_->name());
         }
@@ -261,20 +466,66 @@ public:
     }
     void flush()
     {
+        if (async_)
+        {
+            detail::flush_async();
+        }
         spd_logger_->flush();
     }
 public:
     void log(log_level level, const std::string& str)
     {
+        if (async_)
+        {
+            detail::enqueue_async(*this, level, std::string(str));
+            return;
+        }
         spd_logger_->log(to_spdlog_level(level), str);
     }
+    void log(log_level level, std::string&& str)
+    {
+        if (async_)
+        {
+            detail::enqueue_async(*this, level, std::move(str));
+            return;
+        }
+        spd_logger_->log(to_spdlog_level(level), str);
+    }
+    void log(log_level level, std::chrono::system_clock::time_point time, const char* file, int line,
+        size_t thread_id, std::string_view message)
+    {
+        dispatch(to_spdlog_level(level), time, spdlog::source_loc{ file, line, "" }, thread_id, message);
+    }
+    void write(log_level level, std::chrono::system_clock::time_point time, size_t thread_id,
+        std::string_view message) override
+    {
+        dispatch(to_spdlog_level(level), time, spdlog::source_loc{}, thread_id, message);
+    }
+private:
+    void dispatch(spdlog::level::level_enum level, std::chrono::system_clock::time_point time,
+        const spdlog::source_loc& location, size_t thread_id, std::string_view message)
+    {
+        if (!record_logger_)
+        {
+            spd_logger_->log(time, location, level, message);
+            return;
+        }
+        spdlog::details::log_msg msg(time, location, spd_logger_->name(), level, message);
+        msg.thread_id = thread_id;
+        record_logger_->write(msg);
+    }
 private:
     std::string name_;
     std::shared_ptr<spdlog::logger> spd_logger_;
+    record_logger* record_logger_ = nullptr;
+    const bool async_;
 };
 
 logger::logger(const std::string &name) :
-    impl_(std::make_unique<impl>(name)) {}
+    impl_(std::make_unique<impl>(name, false, overflow_policy::block)) {}
+
+logger::logger(const logger_config& config) :
+    impl_(std::make_unique<impl>(config.name, config.async, config.overflow)) {}
 
 logger::~logger() {}
 
@@ -303,9 +554,30 @@ void logger::flush()
     impl_->flush();
 }
 
+log_drop_stats logger::drop_stats() const
+{
+    return impl_->drop_stats();
+}
+
 void logger::log(log_level level, const std::string& str)
 {
     impl_->log(level, str);
 }
 
+void logger::log(log_level level, std::string&& str)
+{
+    impl_->log(level, std::move(str));
+}
+
+void logger::log(log_level level, std::chrono::system_clock::time_point time, const char* file, int line,
+    size_t thread_id, std::string_view message)
+{
+    impl_->log(level, time, file, line, thread_id, message);
+}
+
+size_t detail::log_thread_id()
+{
+    return spdlog::details::os::thread_id();
+}
+
 } // namespace ring::logging
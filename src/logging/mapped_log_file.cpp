@@ -0,0 +1,431 @@
+#include "ring/logging/mapped_log_file.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <filesystem>
+#include <mutex>
+#include <thread>
+
+#ifndef RING_PLATFORM_WINDOWS
+#include <cerrno>
+#include <cstdio>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "ring/core/exception.hpp"
+
+namespace ring::logging
+{
+
+#ifndef RING_PLATFORM_WINDOWS
+
+namespace
+{
+
+struct segment
+{
+    std::string name;
+    int fd = -1;
+    std::byte* data = nullptr;
+    size_t size = 0;
+    // bytes appended; only the appending thread stores it
+    std::atomic<size_t> written{ 0 };
+    // bytes known to be written back; guarded by the file's mutex
+    size_t synced = 0;
+    // msyncs running on it without the mutex; it is not closed until they finish
+    size_t pins = 0;
+};
+
+size_t page_size()
+{
+    static const size_t size = static_cast<size_t>(::sysconf(_SC_PAGESIZE));
+    return size;
+}
+
+bool file_exists(const std::string& name)
+{
+    struct stat st{};
+    return ::stat(name.c_str(), &st) == 0;
+}
+
+// Creates name at full size and maps it. populate faults the pages in up
+// front so the appending thread doesn't; only worth it off that thread.
+std::unique_ptr<segment> create_segment(const std::string& name, size_t size, [[maybe_unused]] bool populate)
+{
+    int fd = ::open(name.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd == -1)
+    {
+        throw ring::core::exception("failed to create log segment " + name);
+    }
+    int allocated = -1;
+#ifdef RING_PLATFORM_LINUX
+    // reserves the blocks so page faults on the mapping never hit a full disk
+    allocated = ::fallocate(fd, 0, 0, static_cast<off_t>(size));
+#endif
+    if (allocated == -1 && ::ftruncate(fd, static_cast<off_t>(size)) == -1)
+    {
+        ::close(fd);
+        ::unlink(name.c_str());
+        throw ring::core::exception("failed to size log segment " + name);
+    }
+    int flags = MAP_SHARED;
+#ifdef RING_PLATFORM_LINUX
+    flags |= populate ? MAP_POPULATE : 0;
+#endif
+    void* mem = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, flags, fd, 0);
+    if (mem == MAP_FAILED)
+    {
+        ::close(fd);
+        ::unlink(name.c_str());
+        throw ring::core::exception("failed to map log segment " + name);
+    }
+    auto result = std::make_unique<segment>();
+    result->name = name;
+    result->fd = fd;
+    result->data = static_cast<std::byte*>(mem);
+    result->size = size;
+    return result;
+}
+
+// unmaps a segment and cuts the unused preallocation off its file
+void close_segment(segment& target)
+{
+    size_t written = target.written.load(std::memory_order_acquire);
+    ::munmap(target.data, target.size);
+    target.data = nullptr;
+    if (::ftruncate(target.fd, static_cast<off_t>(written)) == 0)
+    {
+        ::fdatasync(target.fd);
+    }
+    ::close(target.fd);
+    target.fd = -1;
+}
+
+} // namespace
+
+class mapped_log_file::impl final
+{
+public:
+    explicit impl(const mapped_log_file_config& config) :
+        config_(config)
+    {
+        if (config_.path.empty() || config_.segment_size == 0)
+        {
+            throw ring::core::exception("mapped log file needs a path and a segment size");
+        }
+        config_.segment_size = (config_.segment_size + page_size() - 1) & ~(page_size() - 1);
+        remove_stale_pending();
+        if (file_exists(config_.path))
+        {
+            shift_rotated();
+        }
+        active_ = create_segment(config_.path, config_.segment_size, false);
+        worker_ = std::thread([this]() { run(); });
+    }
+    ~impl()
+    {
+        {
+            std::lock_guard lock(mutex_);
+            stop_ = true;
+        }
+        wake_.notify_all();
+        worker_.join();
+
+        std::unique_lock lock(mutex_);
+        retire_pending(lock);
+        if (active_)
+        {
+            close_segment(*active_);
+        }
+        if (next_)
+        {
+            close_segment(*next_);
+            ::unlink(next_->name.c_str());
+        }
+    }
+public:
+    void append(std::string_view data)
+    {
+        while (!data.empty())
+        {
+            if (!active_) [[unlikely]]
+            {
+                rotate();
+                continue;
+            }
+            auto& target = *active_;
+            size_t offset = target.written.load(std::memory_order_relaxed);
+            size_t room = target.size - offset;
+            size_t count = data.size();
+            if (count > room)
+            {
+                // split only what can't fit any segment whole
+                if (offset != 0)
+                {
+                    rotate();
+                    continue;
+                }
+                count = room;
+            }
+            std::memcpy(target.data + offset, data.data(), count);
+            target.written.store(offset + count, std::memory_order_release);
+            data.remove_prefix(count);
+            if (offset + count == target.size)
+            {
+                rotate();
+            }
+        }
+    }
+
+    void sync()
+    {
+        std::unique_lock lock(mutex_);
+        wake_.notify_all();
+        retired_cv_.wait(lock, [this]() { return retired_.empty() || stop_; });
+        if (active_)
+        {
+            sync_segment(*active_, lock);
+        }
+    }
+
+    const std::string& path() const
+    {
+        return config_.path;
+    }
+
+    uint64_t inline_segments() const
+    {
+        return inline_segments_.load(std::memory_order_relaxed);
+    }
+private:
+    // runs on the appending thread
+    void rotate()
+    {
+        std::unique_lock lock(mutex_);
+        auto fresh = std::move(next_);
+        if (!fresh)
+        {
+            // the background thread fell behind; pay for the segment here, but
+            // without the lock so its syncs and retirements carry on
+            inline_segments_.fetch_add(1, std::memory_order_relaxed);
+            auto name = pending_name();
+            lock.unlock();
+            fresh = create_segment(name, config_.segment_size, false);
+            lock.lock();
+        }
+        if (active_)
+        {
+            retired_.push_back(std::move(active_));
+        }
+        active_ = std::move(fresh);
+        lock.unlock();
+        wake_.notify_all();
+    }
+
+    std::string pending_name()
+    {
+        return config_.path + ".pending." + std::to_string(pending_serial_++);
+    }
+
+    // Segments a crashed process mapped ahead under path.pending.N. Serials
+    // restart at 0, so nothing else would ever reclaim their preallocation.
+    void remove_stale_pending()
+    {
+        std::filesystem::path base(config_.path);
+        auto directory = base.has_parent_path() ? base.parent_path() : std::filesystem::path(".");
+        auto prefix = base.filename().string() + ".pending.";
+        std::error_code error;
+        for (std::filesystem::directory_iterator it(directory, error), end; !error && it != end; it.increment(error))
+        {
+            if (it->path().filename().string().starts_with(prefix))
+            {
+                std::filesystem::remove(it->path(), error);
+            }
+        }
+    }
+
+    std::string rotated_name(size_t index) const
+    {
+        return index == 0 ? config_.path : config_.path + "." + std::to_string(index);
+    }
+
+    // path.(n-1) -> path.n, ..., path -> path.1; the oldest falls off
+    void shift_rotated()
+    {
+        for (size_t i = config_.max_files; i > 0; --i)
+        {
+            auto source = rotated_name(i - 1);
+            if (file_exists(source))
+            {
+                ::rename(source.c_str(), rotated_name(i).c_str());
+            }
+        }
+        if (config_.max_files == 0)
+        {
+            ::unlink(config_.path.c_str());
+        }
+    }
+
+    // Writes back [synced, written) of target. Called with mutex_ held; the
+    // msync runs without it, so neither rotate() nor other syncs wait on the
+    // disk, and the pin keeps target mapped until it returns.
+    void sync_segment(segment& target, std::unique_lock<std::mutex>& lock)
+    {
+        size_t written = target.written.load(std::memory_order_acquire);
+        if (written == target.synced)
+        {
+            return;
+        }
+        size_t begin = target.synced & ~(page_size() - 1);
+        ++target.pins;
+        lock.unlock();
+        ::msync(target.data + begin, written - begin, MS_SYNC);
+        lock.lock();
+        target.synced = std::max(target.synced, written);
+        if (--target.pins == 0)
+        {
+            unpinned_.notify_all();
+        }
+    }
+
+    // Closes retired segments oldest first. Each one sits at path, so it is
+    // shifted to path.1 and its successor, still under a pending name, takes
+    // its place. Called with mutex_ held; file work happens without it.
+    void retire_pending(std::unique_lock<std::mutex>& lock)
+    {
+        while (!retired_.empty())
+        {
+            auto& oldest = *retired_.front();
+            unpinned_.wait(lock, [&oldest]() { return oldest.pins == 0; });
+            lock.unlock();
+            close_segment(oldest);
+            shift_rotated();
+            lock.lock();
+
+            retired_.pop_front();
+            segment* successor = retired_.empty() ? active_.get() : retired_.front().get();
+            if (successor && successor->name != config_.path)
+            {
+                ::rename(successor->name.c_str(), config_.path.c_str());
+                successor->name = config_.path;
+            }
+        }
+        retired_cv_.notify_all();
+    }
+
+    void run()
+    {
+        auto next_sync = std::chrono::steady_clock::now() + config_.sync_interval;
+        std::unique_lock lock(mutex_);
+        while (!stop_)
+        {
+            retire_pending(lock);
+            if (!next_)
+            {
+                auto name = pending_name();
+                lock.unlock();
+                std::unique_ptr<segment> prepared;
+                try
+                {
+                    prepared = create_segment(name, config_.segment_size, true);
+                }
+                catch (const ring::core::exception&)
+                {
+                    // rotate() retries on the appending thread and reports the failure there
+                }
+                lock.lock();
+                next_ = std::move(prepared);
+            }
+            auto now = std::chrono::steady_clock::now();
+            if (config_.sync_interval.count() && now >= next_sync && active_)
+            {
+                sync_segment(*active_, lock);
+                next_sync = now + config_.sync_interval;
+            }
+
+            auto wakeup = [this]() { return stop_ || !retired_.empty(); };
+            if (config_.sync_interval.count())
+            {
+                wake_.wait_until(lock, next_sync, wakeup);
+            }
+            else
+            {
+                wake_.wait(lock, wakeup);
+            }
+        }
+    }
+private:
+    mapped_log_file_config config_;
+    // the appending thread writes through active_ without the lock; swapping
+    // it and everything else here happens under mutex_
+    std::mutex mutex_;
+    std::condition_variable wake_;
+    std::condition_variable retired_cv_;
+    std::condition_variable unpinned_;
+    std::unique_ptr<segment> active_;
+    std::unique_ptr<segment> next_;
+    std::deque<std::unique_ptr<segment>> retired_;
+    uint64_t pending_serial_ = 0;
+    std::atomic<uint64_t> inline_segments_{ 0 };
+    bool stop_ = false;
+    std::thread worker_;
+};
+
+#else
+
+class mapped_log_file::impl final
+{
+public:
+    explicit impl(const mapped_log_file_config&)
+    {
+        throw ring::core::exception("mapped log files are not supported on this platform");
+    }
+public:
+    void append(std::string_view) {}
+    void sync() {}
+    const std::string& path() const
+    {
+        return path_;
+    }
+    uint64_t inline_segments() const
+    {
+        return 0;
+    }
+private:
+    std::string path_;
+};
+
+#endif
+
+mapped_log_file::mapped_log_file(const mapped_log_file_config& config) :
+    impl_(std::make_unique<impl>(config)) {}
+
+mapped_log_file::~mapped_log_file() {}
+
+void mapped_log_file::append(std::string_view data)
+{
+    impl_->append(data);
+}
+
+void mapped_log_file::sync()
+{
+    impl_->sync();
+}
+
+const std::string& mapped_log_file::path() const
+{
+    return impl_->path();
+}
+
+uint64_t mapped_log_file::inline_segments() const
+{
+    return impl_->inline_segments();
+}
+
+} // namespace ring::logging
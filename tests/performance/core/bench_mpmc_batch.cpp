@@ -0,0 +1,123 @@
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <cstdio>
+#include <thread>
+#include <vector>
+
+#include "ring/core/lockfree_queue.hpp"
+
+namespace ring::core
+{
+
+struct bench_result
+{
+    double seconds = 0.0;
+    queue_stats_snapshot stats;
+};
+
+// The queue counts every compare-exchange on its tail and head, including the
+// ones lost to another thread, so the CAS columns are the real traffic on the
+// shared cursors. The counters themselves cost a little throughput.
+bench_result run(size_t producers, size_t consumers, size_t batch, size_t items)
+{
+    mpmc_queue<size_t, spin_yield_wait, split_layout, queue_stats> queue(65536);
+    std::atomic<size_t> popped{ 0 };
+    std::atomic<bool> start{ false };
+
+    std::vector<std::thread> threads;
+    for (size_t p = 0; p < producers; ++p)
+    {
+        size_t quota = items / producers + (p == 0 ? items % producers : 0);
+        threads.emplace_back([&, quota]()
+            {
+                std::vector<size_t> buffer(batch);
+                while (!start.load(std::memory_order_acquire))
+                {
+                    std::this_thread::yield();
+                }
+                for (size_t sent = 0; sent < quota; )
+                {
+                    size_t count = std::min(batch, quota - sent);
+                    for (size_t i = 0; i < count; ++i)
+                    {
+                        buffer[i] = sent + i;
+                    }
+                    size_t offset = 0;
+                    while (offset < count)
+                    {
+                        size_t pushed = batch == 1 ?
+                            static_cast<size_t>(queue.try_push(std::move(buffer[0]))) :
+                            queue.try_push_batch(buffer.begin() + offset, buffer.begin() + count);
+                        if (pushed == 0)
+                        {
+                            std::this_thread::yield();
+                        }
+                        offset += pushed;
+                    }
+                    sent += count;
+                }
+            });
+    }
+    for (size_t c = 0; c < consumers; ++c)
+    {
+        threads.emplace_back([&]()
+            {
+                std::vector<size_t> buffer(batch);
+                while (!start.load(std::memory_order_acquire))
+                {
+                    std::this_thread::yield();
+                }
+                while (popped.load(std::memory_order_relaxed) < items)
+                {
+                    size_t count = batch == 1 ?
+                        static_cast<size_t>(queue.try_pop(buffer[0])) :
+                        queue.try_pop_batch(buffer.begin(), batch);
+                    if (count == 0)
+                    {
+                        std::this_thread::yield();
+                        continue;
+                    }
+                    popped.fetch_add(count, std::memory_order_relaxed);
+                }
+            });
+    }
+
+    auto begin = std::chrono::steady_clock::now();
+    start.store(true, std::memory_order_release);
+    for (auto& t : threads)
+    {
+        t.join();
+    }
+    auto end = std::chrono::steady_clock::now();
+
+    return { std::chrono::duration<double>(end - begin).count(), queue.stats().snapshot() };
+}
+
+} // namespace ring::core
+
+int main(int argc, char** argv)
+{
+    size_t items = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 4000000;
+
+    constexpr size_t thread_counts[] = { 1, 2, 4, 8 };
+    constexpr size_t batch_sizes[] = { 1, 16, 128 };
+
+    std::printf("threads(pxc)  batch  Mops/s  push_cas/elem  push_lost/elem  pop_cas/elem  pop_lost/elem\n");
+    for (size_t threads : thread_counts)
+    {
+        for (size_t batch : batch_sizes)
+        {
+            auto result = ring::core::run(threads, threads, batch, items);
+            const auto& stats = result.stats;
+            std::printf("%5zux%-7zu %5zu  %6.2f  %13.4f  %14.4f  %12.4f  %13.4f\n",
+                threads, threads, batch,
+                items / result.seconds / 1e6,
+                static_cast<double>(stats.push_cas) / items,
+                static_cast<double>(stats.push_cas_failures) / items,
+                static_cast<double>(stats.pop_cas) / items,
+                static_cast<double>(stats.pop_cas_failures) / items);
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,126 @@
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "ring/core/object_pool.hpp"
+
+namespace ring::core
+{
+
+struct entity
+{
+    entity(uint64_t id) :
+        id(id) {}
+
+    uint64_t id;
+    uint64_t data[7]{};
+};
+
+// what object_pool_mt used to be: one mutex around the single-threaded pool
+class locked_pool final
+{
+public:
+    entity* acquire(uint64_t id)
+    {
+        std::lock_guard lock(mutex_);
+        return pool_.acquire(id);
+    }
+    void release(entity* obj)
+    {
+        std::lock_guard lock(mutex_);
+        pool_.release(obj);
+    }
+private:
+    std::mutex mutex_;
+    object_pool<entity> pool_;
+};
+
+// every thread keeps a window of live objects and passes every fourth one to
+// its neighbour, so a share of releases happens on a foreign thread
+template <typename Pool>
+double run(size_t threads, size_t operations)
+{
+    constexpr size_t window = 64;
+
+    Pool pool;
+    std::vector<std::atomic<entity*>> mailboxes(threads);
+    std::atomic<bool> start{ false };
+
+    std::vector<std::thread> workers;
+    for (size_t t = 0; t < threads; ++t)
+    {
+        workers.emplace_back([&, t]()
+            {
+                std::vector<entity*> live;
+                live.reserve(window);
+                while (!start.load(std::memory_order_acquire))
+                {
+                    std::this_thread::yield();
+                }
+                for (size_t i = 0; i < operations; ++i)
+                {
+                    live.push_back(pool.acquire(i));
+                    if (live.size() < window)
+                    {
+                        continue;
+                    }
+                    for (size_t j = 0; j < live.size(); ++j)
+                    {
+                        entity* obj = live[j];
+                        if (j % 4 == 0)
+                        {
+                            obj = mailboxes[(t + 1) % threads].exchange(obj, std::memory_order_acq_rel);
+                        }
+                        if (obj)
+                        {
+                            pool.release(obj);
+                        }
+                    }
+                    live.clear();
+                }
+                for (auto* obj : live)
+                {
+                    pool.release(obj);
+                }
+            });
+    }
+
+    auto begin = std::chrono::steady_clock::now();
+    start.store(true, std::memory_order_release);
+    for (auto& worker : workers)
+    {
+        worker.join();
+    }
+    auto end = std::chrono::steady_clock::now();
+    for (auto& mailbox : mailboxes)
+    {
+        if (auto* obj = mailbox.load())
+        {
+            pool.release(obj);
+        }
+    }
+    return threads * operations / std::chrono::duration<double>(end - begin).count() / 1e6;
+}
+
+} // namespace ring::core
+
+int main(int argc, char** argv)
+{
+    using namespace ring::core;
+
+    size_t operations = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1000000;
+    size_t max_threads = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 64;
+
+    std::printf("%8s %18s %18s\n", "threads", "mutex Mops/s", "magazine Mops/s");
+    for (size_t threads = 1; threads <= max_threads; threads *= 2)
+    {
+        double locked = run<locked_pool>(threads, operations);
+        double magazine = run<object_pool_mt<entity>>(threads, operations);
+        std::printf("%8zu %18.2f %18.2f\n", threads, locked, magazine);
+    }
+    return 0;
+}
@@ -0,0 +1,88 @@
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+#include <vector>
+
+#include "ring/core/lockfree_queue.hpp"
+
+namespace ring::core
+{
+
+struct event
+{
+    uint64_t id;
+    uint64_t payload;
+};
+
+// many producers hammering single-slot claims puts neighbouring producers on
+// adjacent slots, which is where the split layout false-shares sequence lines
+template <typename Layout>
+double run(size_t producers, size_t items)
+{
+    mpsc_queue<event, busy_spin_wait, Layout> queue(8192);
+    std::atomic<bool> start{ false };
+
+    std::vector<std::thread> threads;
+    for (size_t p = 0; p < producers; ++p)
+    {
+        size_t quota = items / producers + (p == 0 ? items % producers : 0);
+        threads.emplace_back([&, p, quota]()
+            {
+                while (!start.load(std::memory_order_acquire))
+                {
+                    std::this_thread::yield();
+                }
+                for (size_t i = 0; i < quota; ++i)
+                {
+                    event value{ p, i };
+                    while (!queue.try_push(std::move(value)))
+                    {
+                        std::this_thread::yield();
+                    }
+                }
+            });
+    }
+
+    auto begin = std::chrono::steady_clock::now();
+    start.store(true, std::memory_order_release);
+    std::vector<event> out(256);
+    for (size_t popped = 0; popped < items; )
+    {
+        size_t count = queue.try_pop_batch(out.begin(), out.size());
+        if (count == 0)
+        {
+            std::this_thread::yield();
+        }
+        popped += count;
+    }
+    auto end = std::chrono::steady_clock::now();
+    for (auto& t : threads)
+    {
+        t.join();
+    }
+    return items / std::chrono::duration<double>(end - begin).count() / 1e6;
+}
+
+} // namespace ring::core
+
+int main(int argc, char** argv)
+{
+    using namespace ring::core;
+
+    size_t items = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 4000000;
+
+    constexpr size_t producer_counts[] = { 2, 4, 8, 16, 32 };
+
+    std::printf("producers   split  interleaved  padded  swizzled  (Mops/s)\n");
+    for (size_t producers : producer_counts)
+    {
+        std::printf("%9zu  %6.2f  %11.2f  %6.2f  %8.2f\n", producers,
+            run<split_layout>(producers, items),
+            run<interleaved_layout>(producers, items),
+            run<padded_layout>(producers, items),
+            run<swizzled_layout>(producers, items));
+    }
+    return 0;
+}
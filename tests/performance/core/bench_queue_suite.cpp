@@ -0,0 +1,451 @@
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#ifdef RING_PLATFORM_LINUX
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+#include "ring/core/lockfree_queue.hpp"
+
+namespace ring::core
+{
+
+using bench_clock = std::chrono::steady_clock;
+
+template <size_t Size>
+struct payload
+{
+    static_assert(Size >= sizeof(uint64_t));
+
+    uint64_t sequence = 0;
+    std::array<std::byte, Size - sizeof(uint64_t)> data{};
+};
+
+// the baseline every lock-free variant has to beat
+template <typename T>
+class mutex_deque_queue final
+{
+public:
+    explicit mutex_deque_queue(size_t capacity) :
+        capacity_(capacity) {}
+public:
+    bool try_push(T&& value)
+    {
+        std::lock_guard lock(mutex_);
+        if (items_.size() >= capacity_)
+        {
+            return false;
+        }
+        items_.push_back(std::move(value));
+        return true;
+    }
+
+    bool try_pop(T& result)
+    {
+        std::lock_guard lock(mutex_);
+        if (items_.empty())
+        {
+            return false;
+        }
+        result = std::move(items_.front());
+        items_.pop_front();
+        return true;
+    }
+
+    template <typename InputIt>
+    size_t try_push_batch(InputIt first, InputIt last)
+    {
+        std::lock_guard lock(mutex_);
+        size_t count = 0;
+        for ( ; first != last && items_.size() < capacity_; ++first, ++count)
+        {
+            items_.push_back(std::move(*first));
+        }
+        return count;
+    }
+
+    template <typename OutputIt>
+    size_t try_pop_batch(OutputIt first, size_t max_count)
+    {
+        std::lock_guard lock(mutex_);
+        size_t count = std::min(max_count, items_.size());
+        for (size_t i = 0; i < count; ++i)
+        {
+            *first++ = std::move(items_.front());
+            items_.pop_front();
+        }
+        return count;
+    }
+private:
+    const size_t capacity_;
+    std::mutex mutex_;
+    std::deque<T> items_;
+};
+
+enum class pinning
+{
+    none,
+    compact,
+    spread
+};
+
+const char* to_string(pinning layout)
+{
+    switch (layout)
+    {
+    case pinning::compact:  return "compact";
+    case pinning::spread:   return "spread";
+    default:                return "none";
+    }
+}
+
+void pin_thread(pinning layout, size_t index, size_t threads)
+{
+#ifdef RING_PLATFORM_LINUX
+    if (layout == pinning::none)
+    {
+        return;
+    }
+    size_t cpus = std::max<size_t>(1, std::thread::hardware_concurrency());
+    size_t stride = layout == pinning::spread ? std::max<size_t>(1, cpus / threads) : 1;
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET((index * stride) % cpus, &set);
+    ::pthread_setaffinity_np(::pthread_self(), sizeof(set), &set);
+#else
+    (void)layout;
+    (void)index;
+    (void)threads;
+#endif
+}
+
+struct bench_config
+{
+    const char* queue;
+    size_t producers;
+    size_t consumers;
+    size_t batch;
+    size_t payload;
+    pinning layout;
+    size_t items;
+};
+
+struct percentiles
+{
+    double p50 = 0;
+    double p90 = 0;
+    double p99 = 0;
+    double p999 = 0;
+    double max = 0;
+};
+
+struct bench_result
+{
+    double mops = 0;
+    percentiles push_ns;
+    percentiles pop_ns;
+};
+
+constexpr size_t sample_interval = 32;
+
+percentiles summarize(std::vector<double>& samples)
+{
+    percentiles result;
+    if (samples.empty())
+    {
+        return result;
+    }
+    std::sort(samples.begin(), samples.end());
+    auto at = [&](double q) { return samples[std::min(samples.size() - 1, static_cast<size_t>(q * samples.size()))]; };
+    result.p50 = at(0.5);
+    result.p90 = at(0.9);
+    result.p99 = at(0.99);
+    result.p999 = at(0.999);
+    result.max = samples.back();
+    return result;
+}
+
+// every sample_interval-th call is timed from its first attempt to its success
+template <typename Queue, typename T>
+bench_result run(const bench_config& config)
+{
+    Queue queue(8192);
+    std::atomic<size_t> popped{ 0 };
+    std::atomic<size_t> ready{ 0 };
+    std::atomic<bool> start{ false };
+    std::mutex samples_mutex;
+    std::vector<double> push_samples;
+    std::vector<double> pop_samples;
+    size_t threads_total = config.producers + config.consumers;
+
+    auto wait_start = [&]()
+        {
+            ready.fetch_add(1, std::memory_order_acq_rel);
+            while (!start.load(std::memory_order_acquire))
+            {
+                std::this_thread::yield();
+            }
+        };
+
+    std::vector<std::thread> threads;
+    for (size_t p = 0; p < config.producers; ++p)
+    {
+        size_t quota = config.items / config.producers + (p == 0 ? config.items % config.producers : 0);
+        threads.emplace_back([&, p, quota]()
+            {
+                pin_thread(config.layout, p, threads_total);
+                std::vector<T> buffer(config.batch);
+                std::vector<double> samples;
+                wait_start();
+                for (size_t sent = 0, calls = 0; sent < quota; ++calls)
+                {
+                    size_t count = std::min(config.batch, quota - sent);
+                    for (size_t i = 0; i < count; ++i)
+                    {
+                        buffer[i].sequence = sent + i;
+                    }
+                    bool sampled = calls % sample_interval == 0;
+                    auto begin = sampled ? bench_clock::now() : bench_clock::time_point{};
+                    for (size_t offset = 0; offset < count; )
+                    {
+                        size_t pushed = queue.try_push_batch(buffer.begin() + offset, buffer.begin() + count);
+                        if (pushed == 0)
+                        {
+                            std::this_thread::yield();
+                        }
+                        offset += pushed;
+                    }
+                    if (sampled)
+                    {
+                        samples.push_back(std::chrono::duration<double, std::nano>(bench_clock::now() - begin).count());
+                    }
+                    sent += count;
+                }
+                std::lock_guard lock(samples_mutex);
+                push_samples.insert(push_samples.end(), samples.begin(), samples.end());
+            });
+    }
+    for (size_t c = 0; c < config.consumers; ++c)
+    {
+        threads.emplace_back([&, c]()
+            {
+                pin_thread(config.layout, config.producers + c, threads_total);
+                std::vector<T> buffer(config.batch);
+                std::vector<double> samples;
+                wait_start();
+                for (size_t calls = 0; popped.load(std::memory_order_relaxed) < config.items; ++calls)
+                {
+                    bool sampled = calls % sample_interval == 0;
+                    auto begin = sampled ? bench_clock::now() : bench_clock::time_point{};
+                    size_t count = 0;
+                    while ((count = queue.try_pop_batch(buffer.begin(), config.batch)) == 0)
+                    {
+                        if (popped.load(std::memory_order_relaxed) >= config.items)
+                        {
+                            break;
+                        }
+                        std::this_thread::yield();
+                    }
+                    if (count == 0)
+                    {
+                        break;
+                    }
+                    if (sampled)
+                    {
+                        samples.push_back(std::chrono::duration<double, std::nano>(bench_clock::now() - begin).count());
+                    }
+                    popped.fetch_add(count, std::memory_order_relaxed);
+                }
+                std::lock_guard lock(samples_mutex);
+                pop_samples.insert(pop_samples.end(), samples.begin(), samples.end());
+            });
+    }
+
+    while (ready.load(std::memory_order_acquire) < threads_total)
+    {
+        std::this_thread::yield();
+    }
+    auto begin = bench_clock::now();
+    start.store(true, std::memory_order_release);
+    for (auto& t : threads)
+    {
+        t.join();
+    }
+    auto end = bench_clock::now();
+
+    bench_result result;
+    result.mops = config.items / std::chrono::duration<double>(end - begin).count() / 1e6;
+    result.push_ns = summarize(push_samples);
+    result.pop_ns = summarize(pop_samples);
+    return result;
+}
+
+template <size_t Size>
+bench_result dispatch_queue(const bench_config& config)
+{
+    using T = payload<Size>;
+    std::string name = config.queue;
+    if (name == "spsc")
+    {
+        return run<spsc_queue<T>, T>(config);
+    }
+    if (name == "mpsc")
+    {
+        return run<mpsc_queue<T>, T>(config);
+    }
+    if (name == "mpmc")
+    {
+        return run<mpmc_queue<T>, T>(config);
+    }
+    return run<mutex_deque_queue<T>, T>(config);
+}
+
+bench_result dispatch(const bench_config& config)
+{
+    switch (config.payload)
+    {
+    case 8:     return dispatch_queue<8>(config);
+    case 64:    return dispatch_queue<64>(config);
+    default:    return dispatch_queue<256>(config);
+    }
+}
+
+void write_percentiles(std::FILE* out, const char* name, const percentiles& p)
+{
+    std::fprintf(out, "\"%s\": {\"p50\": %.1f, \"p90\": %.1f, \"p99\": %.1f, \"p999\": %.1f, \"max\": %.1f}",
+        name, p.p50, p.p90, p.p99, p.p999, p.max);
+}
+
+} // namespace ring::core
+
+int main(int argc, char** argv)
+{
+    using namespace ring::core;
+
+    size_t items = 1000000;
+    const char* json_path = nullptr;
+    std::string only;
+    bool quick = false;
+    for (int i = 1; i < argc; ++i)
+    {
+        if (std::strcmp(argv[i], "--items") == 0 && i + 1 < argc)
+        {
+            items = std::strtoull(argv[++i], nullptr, 10);
+        }
+        else if (std::strcmp(argv[i], "--json") == 0 && i + 1 < argc)
+        {
+            json_path = argv[++i];
+        }
+        else if (std::strcmp(argv[i], "--queue") == 0 && i + 1 < argc)
+        {
+            only = argv[++i];
+        }
+        else if (std::strcmp(argv[i], "--quick") == 0)
+        {
+            quick = true;
+        }
+        else
+        {
+            std::fprintf(stderr, "usage: %s [--items N] [--json FILE] [--queue spsc|mpsc|mpmc|mutex_deque] [--quick]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    std::vector<size_t> thread_counts = quick ? std::vector<size_t>{ 1, 2 } : std::vector<size_t>{ 1, 2, 4, 8 };
+    std::vector<size_t> batch_sizes = quick ? std::vector<size_t>{ 1, 32 } : std::vector<size_t>{ 1, 8, 64 };
+    std::vector<size_t> payload_sizes = quick ? std::vector<size_t>{ 8, 64 } : std::vector<size_t>{ 8, 64, 256 };
+    std::vector<pinning> layouts = quick ? std::vector<pinning>{ pinning::none } :
+        std::vector<pinning>{ pinning::none, pinning::compact, pinning::spread };
+
+    // each lock-free queue runs next to the baseline in its own topology; shared baselines run once
+    std::vector<bench_config> configs;
+    for (const char* queue : { "spsc", "mpsc", "mpmc" })
+    {
+        for (size_t producers : thread_counts)
+        {
+            for (size_t consumers : thread_counts)
+            {
+                bool single_producer = std::strcmp(queue, "spsc") == 0;
+                bool single_consumer = std::strcmp(queue, "mpmc") != 0;
+                if ((single_producer && producers != 1) || (single_consumer && consumers != 1))
+                {
+                    continue;
+                }
+                for (size_t batch : batch_sizes)
+                {
+                    for (size_t payload : payload_sizes)
+                    {
+                        for (pinning layout : layouts)
+                        {
+                            for (const char* name : { queue, "mutex_deque" })
+                            {
+                                bench_config config{ name, producers, consumers, batch, payload, layout, items };
+                                bool duplicate = std::any_of(configs.begin(), configs.end(), [&](const bench_config& other)
+                                    {
+                                        return std::strcmp(other.queue, name) == 0 && other.producers == producers &&
+                                            other.consumers == consumers && other.batch == batch &&
+                                            other.payload == payload && other.layout == layout;
+                                    });
+                                if (!duplicate && (only.empty() || only == name))
+                                {
+                                    configs.push_back(config);
+                                }
+                            }
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    std::FILE* json = json_path ? std::fopen(json_path, "w") : nullptr;
+    if (json_path && !json)
+    {
+        std::fprintf(stderr, "cannot open %s\n", json_path);
+        return 1;
+    }
+    if (json)
+    {
+        std::fprintf(json, "{\n  \"items\": %zu,\n  \"hardware_threads\": %u,\n  \"results\": [\n",
+            items, std::thread::hardware_concurrency());
+    }
+
+    std::printf("%-12s %4s %4s %5s %7s %-8s %8s %9s %9s %9s %9s\n",
+        "queue", "prod", "cons", "batch", "payload", "pinning", "Mops/s", "push p50", "push p99", "pop p50", "pop p99");
+    for (size_t i = 0; i < configs.size(); ++i)
+    {
+        const auto& config = configs[i];
+        auto result = dispatch(config);
+        std::printf("%-12s %4zu %4zu %5zu %7zu %-8s %8.2f %9.0f %9.0f %9.0f %9.0f\n",
+            config.queue, config.producers, config.consumers, config.batch, config.payload, to_string(config.layout),
+            result.mops, result.push_ns.p50, result.push_ns.p99, result.pop_ns.p50, result.pop_ns.p99);
+        if (json)
+        {
+            std::fprintf(json, "    {\"queue\": \"%s\", \"producers\": %zu, \"consumers\": %zu, \"batch\": %zu, "
+                "\"payload\": %zu, \"pinning\": \"%s\", \"mops\": %.3f, ",
+                config.queue, config.producers, config.consumers, config.batch, config.payload,
+                to_string(config.layout), result.mops);
+            write_percentiles(json, "push_ns", result.push_ns);
+            std::fprintf(json, ", ");
+            write_percentiles(json, "pop_ns", result.pop_ns);
+            std::fprintf(json, "}%s\n", i + 1 < configs.size() ? "," : "");
+        }
+    }
+    if (json)
+    {
+        std::fprintf(json, "  ]\n}\n");
+        std::fclose(json);
+    }
+    return 0;
+}
@@ -0,0 +1,82 @@
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "ring/core/shared_queue.hpp"
+
+namespace ring::core
+{
+
+struct message
+{
+    uint64_t id;
+    int64_t sent;
+};
+
+// child process echoes every message back on the reply queue
+void echo(const std::string& request_name, const std::string& reply_name, size_t count)
+{
+    shared_spsc_queue<message> requests(request_name, shm_mode::attach, shm_role::consumer);
+    shared_spsc_queue<message> replies(reply_name, shm_mode::attach, shm_role::producer);
+    message msg{};
+    for (size_t i = 0; i < count; ++i)
+    {
+        while (!requests.pop_for(msg, std::chrono::seconds(1)))
+        {
+            if (!requests.peer_alive(std::chrono::seconds(5)))
+            {
+                ::_exit(1);
+            }
+        }
+        while (!replies.try_push(msg))
+        {
+        }
+    }
+    ::_exit(0);
+}
+
+} // namespace ring::core
+
+int main(int argc, char** argv)
+{
+    using namespace ring::core;
+
+    size_t count = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1000000;
+
+    std::string request_name = "ring_bench_request_" + std::to_string(::getpid());
+    std::string reply_name = "ring_bench_reply_" + std::to_string(::getpid());
+    shared_spsc_queue<message> requests(request_name, shm_mode::create, shm_role::producer, 1024);
+    shared_spsc_queue<message> replies(reply_name, shm_mode::create, shm_role::consumer, 1024);
+
+    pid_t child = ::fork();
+    if (child == 0)
+    {
+        echo(request_name, reply_name, count);
+    }
+
+    message msg{};
+    int64_t total = 0;
+    int64_t worst = 0;
+    auto begin = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < count; ++i)
+    {
+        requests.push_for(message{ i, shared_memory_region::monotonic_now() }, std::chrono::seconds(5));
+        while (!replies.try_pop(msg))
+        {
+        }
+        int64_t rtt = shared_memory_region::monotonic_now() - msg.sent;
+        total += rtt;
+        worst = std::max(worst, rtt);
+    }
+    auto end = std::chrono::steady_clock::now();
+
+    int status = 0;
+    ::waitpid(child, &status, 0);
+    std::printf("round trips  %zu in %.1f ms\n", count, std::chrono::duration<double, std::milli>(end - begin).count());
+    std::printf("one-way hop  %.0f ns average, %.0f ns worst\n", total / 2.0 / count, worst / 2.0);
+    return WIFEXITED(status) && WEXITSTATUS(status) == 0 ? 0 : 1;
+}
@@ -0,0 +1,78 @@
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+#include "ring/core/timing_wheel.hpp"
+
+namespace ring::core
+{
+
+using bench_clock = std::chrono::steady_clock;
+
+double elapsed_ns(bench_clock::time_point begin, bench_clock::time_point end, size_t count)
+{
+    return std::chrono::duration<double, std::nano>(end - begin).count() / count;
+}
+
+} // namespace ring::core
+
+int main(int argc, char** argv)
+{
+    using namespace ring::core;
+
+    size_t timers = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1000000;
+
+    // session timeouts and buffs: spread over 1ms..10min at 1ms resolution
+    auto origin = bench_clock::now();
+    timing_wheel<void(*)()> wheel(std::chrono::milliseconds(1), 4096, origin);
+    std::mt19937_64 rng(42);
+    std::uniform_int_distribution<int64_t> delay(1, 600000);
+    std::vector<bench_clock::time_point> deadlines(timers);
+    for (auto& deadline : deadlines)
+    {
+        deadline = origin + std::chrono::milliseconds(delay(rng));
+    }
+    std::vector<timer_handle> handles(timers);
+
+    auto begin = bench_clock::now();
+    for (size_t i = 0; i < timers; ++i)
+    {
+        handles[i] = wheel.schedule(deadlines[i], []() {});
+    }
+    auto end = bench_clock::now();
+    std::printf("schedule    %8.1f ns/op  (%zu active)\n", elapsed_ns(begin, end, timers), wheel.size());
+
+    // a session that sees traffic pushes its timeout back
+    begin = bench_clock::now();
+    for (size_t i = 0; i < timers; i += 2)
+    {
+        wheel.reschedule(handles[i], deadlines[i] + std::chrono::seconds(30));
+    }
+    end = bench_clock::now();
+    std::printf("reschedule  %8.1f ns/op\n", elapsed_ns(begin, end, timers / 2));
+
+    begin = bench_clock::now();
+    size_t cancelled = 0;
+    for (size_t i = 1; i < timers; i += 4)
+    {
+        cancelled += wheel.cancel(handles[i]);
+    }
+    end = bench_clock::now();
+    std::printf("cancel      %8.1f ns/op\n", elapsed_ns(begin, end, cancelled));
+
+    // drive ten minutes and thirty seconds of 1ms ticks
+    size_t remaining = wheel.size();
+    begin = bench_clock::now();
+    size_t fired = 0;
+    for (int64_t tick = 1; tick <= 630000; ++tick)
+    {
+        fired += wheel.advance(origin + std::chrono::milliseconds(tick));
+    }
+    end = bench_clock::now();
+    std::printf("expire      %8.1f ns/timer  (%zu fired of %zu, %.1f ms total)\n",
+        elapsed_ns(begin, end, fired), fired, remaining,
+        std::chrono::duration<double, std::milli>(end - begin).count());
+    return fired == remaining ? 0 : 1;
+}
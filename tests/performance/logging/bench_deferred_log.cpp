@@ -0,0 +1,65 @@
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+
+#include "ring/logging/deferred_log.hpp"
+#include "ring/logging/logger.hpp"
+
+namespace ring::logging
+{
+
+using bench_clock = std::chrono::steady_clock;
+
+double elapsed_ns(bench_clock::time_point begin, bench_clock::time_point end, size_t count)
+{
+    return std::chrono::duration<double, std::nano>(end - begin).count() / count;
+}
+
+} // namespace ring::logging
+
+int main(int argc, char** argv)
+{
+    using namespace ring::logging;
+
+    size_t calls = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1000000;
+
+    auto& service = log_service::instance();
+    auto eager = service.create_logger({ .name = "bench_eager", .console = false, .file = "bench_eager_log" });
+    auto deferred = service.create_logger({ .name = "bench_deferred", .console = false,
+        .file = "bench_deferred_log", .async = false });
+    std::string player = "player_0042";
+
+    // caller-side cost only: eager formats on the calling thread, deferred copies raw arguments
+    auto begin = bench_clock::now();
+    for (size_t i = 0; i < calls; ++i)
+    {
+        eager->info("tick {} player {} pos {:.2f},{:.2f} hp {}", i, player, 1.5 * i, 2.5, 100);
+    }
+    auto end = bench_clock::now();
+    std::printf("eager     %8.1f ns/call\n", elapsed_ns(begin, end, calls));
+    service.flush_all();
+
+    // a tick's worth of calls fits the channel; the backend catches up between bursts
+    constexpr size_t burst = 4096;
+    bench_clock::duration producer{};
+    bench_clock::duration drain{};
+    for (size_t done = 0; done < calls; done += burst)
+    {
+        begin = bench_clock::now();
+        for (size_t i = done; i < done + burst; ++i)
+        {
+            RING_DEFERRED_INFO(*deferred, "tick {} player {} pos {:.2f},{:.2f} hp {}", i, player, 1.5 * i, 2.5, 100);
+        }
+        end = bench_clock::now();
+        producer += end - begin;
+        flush_deferred();
+        drain += bench_clock::now() - end;
+    }
+    size_t total = (calls + burst - 1) / burst * burst;
+    std::printf("deferred  %8.1f ns/call\n", elapsed_ns(bench_clock::time_point{}, bench_clock::time_point{} + producer, total));
+    std::printf("backend   %8.1f ns/record\n", elapsed_ns(bench_clock::time_point{}, bench_clock::time_point{} + drain, total));
+
+    service.shutdown();
+    return 0;
+}
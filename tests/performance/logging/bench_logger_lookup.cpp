@@ -0,0 +1,91 @@
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "ring/logging/logger.hpp"
+
+namespace ring::logging
+{
+
+using bench_clock = std::chrono::steady_clock;
+
+// what every log call used to pay: a mutex plus a shared_ptr copy
+class locked_lookup
+{
+public:
+    explicit locked_lookup(std::shared_ptr<logger> logger) :
+        logger_(std::move(logger)) {}
+public:
+    std::shared_ptr<logger> get()
+    {
+        std::lock_guard lock(mutex_);
+        return logger_;
+    }
+private:
+    std::mutex mutex_;
+    std::shared_ptr<logger> logger_;
+};
+
+// runs body(i) on every thread at once, returns ns per call across all threads
+template <typename Body>
+double run_threads(size_t threads, size_t iterations, Body body)
+{
+    std::atomic<bool> go{ false };
+    std::vector<std::thread> workers;
+    for (size_t t = 0; t < threads; ++t)
+    {
+        workers.emplace_back([&]()
+            {
+                while (!go.load(std::memory_order_acquire))
+                {
+                    std::this_thread::yield();
+                }
+                for (size_t i = 0; i < iterations; ++i)
+                {
+                    body(i);
+                }
+            });
+    }
+    auto begin = bench_clock::now();
+    go.store(true, std::memory_order_release);
+    for (auto& worker : workers)
+    {
+        worker.join();
+    }
+    auto end = bench_clock::now();
+    return std::chrono::duration<double, std::nano>(end - begin).count() / (threads * iterations);
+}
+
+} // namespace ring::logging
+
+int main(int argc, char** argv)
+{
+    using namespace ring::logging;
+
+    size_t threads = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 32;
+    size_t iterations = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 200000;
+
+    auto& service = log_service::instance();
+    // filtered at runtime so the numbers are lookup cost, not sink cost
+    service.get_default_logger()->set_level(log_level::off);
+    service.get_logger("bench_named")->set_level(log_level::off);
+    locked_lookup baseline(service.get_default_logger());
+
+    std::printf("%zu threads x %zu calls\n", threads, iterations);
+    double ns = run_threads(threads, iterations, [&](size_t i) { baseline.get()->info("tick {}", i); });
+    std::printf("mutex + shared_ptr copy   %8.1f ns/call\n", ns);
+    ns = run_threads(threads, iterations, [&](size_t i) { service.get_default_logger()->info("tick {}", i); });
+    std::printf("get_default_logger()      %8.1f ns/call\n", ns);
+    ns = run_threads(threads, iterations, [](size_t i) { ring::logging::info("tick {}", i); });
+    std::printf("ring::logging::info       %8.1f ns/call\n", ns);
+    ns = run_threads(threads, iterations, [&](size_t i) { service.get_logger("bench_named")->info("tick {}", i); });
+    std::printf("get_logger(name)          %8.1f ns/call\n", ns);
+
+    service.shutdown();
+    return 0;
+}
@@ -0,0 +1,52 @@
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+
+#include "ring/logging/logger.hpp"
+
+namespace ring::logging
+{
+
+using bench_clock = std::chrono::steady_clock;
+
+double elapsed_ns(bench_clock::time_point begin, bench_clock::time_point end, size_t count)
+{
+    return std::chrono::duration<double, std::nano>(end - begin).count() / count;
+}
+
+} // namespace ring::logging
+
+int main(int argc, char** argv)
+{
+    using namespace ring::logging;
+
+    size_t calls = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1000000;
+
+    auto& service = log_service::instance();
+    std::string player = "player_0042";
+
+    // synchronous loggers, so the sink's cost lands on the calling thread; "none"
+    // has no sink at all and shows what formatting alone costs
+    auto run = [&](const char* name, const char* file, file_sink_mode mode)
+        {
+            auto logger = service.create_logger({ .name = name, .pattern = "%v", .max_file_size = 16ul * 1024 * 1024,
+                .max_files = 4, .console = false, .file = file, .async = false, .file_mode = mode });
+            auto begin = bench_clock::now();
+            for (size_t i = 0; i < calls; ++i)
+            {
+                logger->info("tick {} player {} pos {:.2f},{:.2f} hp {}", i, player, 1.5 * i, 2.5, 100);
+            }
+            auto end = bench_clock::now();
+            logger->flush();
+            auto flushed = bench_clock::now();
+            std::printf("%-8s %8.1f ns/record, flush %8.1f us\n", name, elapsed_ns(begin, end, calls),
+                std::chrono::duration<double, std::micro>(flushed - end).count());
+        };
+    run("none", "", file_sink_mode::stream);
+    run("stream", "bench_stream_log", file_sink_mode::stream);
+    run("mapped", "bench_mapped_log", file_sink_mode::mapped);
+
+    service.shutdown();
+    return 0;
+}
@@ -1,13 +1,31 @@
 #include <gtest/gtest.h>
 
 #include <array>
+#include <list>
+#include <numeric>
+
+#ifdef RING_PLATFORM_LINUX
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
 
 #include "test_helpers.hpp"
 
+#include "ring/core/broadcast_ring.hpp"
 #include "ring/core/exception.hpp"
+#include "ring/core/frame_arena.hpp"
 #include "ring/core/initializer_registry.hpp"
+#include "ring/core/job_scheduler.hpp"
 #include "ring/core/lockfree_queue.hpp"
+#include "ring/core/memory_policy.hpp"
 #include "ring/core/object_pool.hpp"
+#include "ring/core/pool_allocator.hpp"
+#include "ring/core/shared_queue.hpp"
+#include "ring/core/slab_allocator.hpp"
+#include "ring/core/slot_map.hpp"
+#include "ring/core/timing_wheel.hpp"
+#include "ring/core/unbounded_queue.hpp"
+#include "ring/core/work_stealing_deque.hpp"
 
 namespace ring::core
 {
@@ -125,6 +143,654 @@ TEST_F(CoreTest, ObjectPool)
     }
 }
 
+TEST_F(CoreTest, ObjectPoolTrim)
+{
+    constexpr size_t chunk_capacity = 64;
+
+    ring::core::object_pool<std::string> pool(chunk_capacity);
+    std::vector<std::string*> spike;
+    for (size_t i = 0; i < chunk_capacity * 8; ++i)
+    {
+        spike.push_back(pool.acquire(std::to_string(i)));
+    }
+    EXPECT_EQ(pool.capacity(), chunk_capacity * 8);
+
+    // keep one object alive in the second chunk so it cannot be returned
+    std::string* survivor = spike[chunk_capacity + 1];
+    for (auto* obj : spike)
+    {
+        if (obj != survivor)
+        {
+            pool.release(obj);
+        }
+    }
+    EXPECT_EQ(pool.size(), 1u);
+    EXPECT_EQ(pool.trim(2), 5u);
+    EXPECT_EQ(pool.capacity(), chunk_capacity * 3);
+    EXPECT_EQ(pool.size(), 1u);
+    EXPECT_EQ(*survivor, std::to_string(chunk_capacity + 1));
+
+    // reuse only hands out slots from the chunks that were kept
+    std::vector<std::string*> reused;
+    for (size_t i = 0; i < chunk_capacity * 3 - 1; ++i)
+    {
+        reused.push_back(pool.acquire("reused"));
+    }
+    EXPECT_EQ(pool.capacity(), chunk_capacity * 3);
+    EXPECT_EQ(pool.size(), chunk_capacity * 3);
+    for (auto* obj : reused)
+    {
+        pool.release(obj);
+    }
+    EXPECT_EQ(pool.shrink_to_fit(), 2u);
+    EXPECT_EQ(pool.capacity(), chunk_capacity);
+
+    pool.release(survivor);
+    EXPECT_EQ(pool.shrink_to_fit(), 1u);
+    EXPECT_EQ(pool.capacity(), 0u);
+    EXPECT_TRUE(pool.empty());
+    auto* fresh = pool.acquire("fresh");
+    EXPECT_EQ(*fresh, "fresh");
+    EXPECT_EQ(pool.capacity(), chunk_capacity);
+    pool.release(fresh);
+}
+
+TEST_F(CoreTest, ObjectPoolMagazine)
+{
+    constexpr size_t thread_count = 8;
+    constexpr size_t rounds = 200;
+    constexpr size_t per_round = 300;
+
+    ring::core::object_pool_mt<std::pair<size_t, size_t>> pool(256);
+    ring::core::mpmc_queue<std::pair<size_t, size_t>*> handoff(thread_count * per_round);
+    std::atomic<bool> error_flag{ false };
+
+    std::vector<std::thread> threads;
+    for (size_t t = 0; t < thread_count; ++t)
+    {
+        threads.emplace_back([&, t]()
+            {
+                std::vector<std::pair<size_t, size_t>*> owned;
+                for (size_t round = 0; round < rounds; ++round)
+                {
+                    for (size_t i = 0; i < per_round; ++i)
+                    {
+                        owned.push_back(pool.acquire(t, i));
+                    }
+                    for (size_t i = 0; i < per_round; ++i)
+                    {
+                        if (owned[i]->first != t || owned[i]->second != i)
+                        {
+                            error_flag = true;
+                        }
+                    }
+                    // half go back through this thread, half are released by whoever pops them
+                    for (size_t i = 0; i < per_round; ++i)
+                    {
+                        if (i % 2 == 0 || !handoff.try_push(owned[i]))
+                        {
+                            pool.release(owned[i]);
+                        }
+                    }
+                    owned.clear();
+                    std::pair<size_t, size_t>* foreign = nullptr;
+                    while (handoff.try_pop(foreign))
+                    {
+                        pool.release(foreign);
+                    }
+                }
+            });
+    }
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+    std::pair<size_t, size_t>* foreign = nullptr;
+    while (handoff.try_pop(foreign))
+    {
+        pool.release(foreign);
+    }
+
+    EXPECT_FALSE(error_flag);
+    EXPECT_TRUE(pool.empty());
+    EXPECT_GE(pool.capacity(), per_round);
+    EXPECT_LE(pool.capacity(), thread_count * per_round * 4);
+
+    std::vector<std::pair<size_t, size_t>*> live;
+    for (size_t i = 0; i < 1000; ++i)
+    {
+        live.push_back(pool.acquire(i, i));
+    }
+    EXPECT_EQ(pool.size(), 1000u);
+    std::sort(live.begin(), live.end());
+    EXPECT_EQ(std::adjacent_find(live.begin(), live.end()), live.end());
+    for (auto* obj : live)
+    {
+        pool.release(obj);
+    }
+    EXPECT_TRUE(pool.empty());
+}
+
+TEST_F(CoreTest, ObjectPoolThreadExit)
+{
+    constexpr size_t chunk = 128;
+    ring::core::object_pool_mt<size_t> pool(chunk);
+    // the worker's magazines end up holding every slot of the only chunk
+    std::thread([&]()
+        {
+            std::vector<size_t*> owned;
+            for (size_t i = 0; i < chunk; ++i)
+            {
+                owned.push_back(pool.acquire(i));
+            }
+            for (auto* obj : owned)
+            {
+                pool.release(obj);
+            }
+        }).join();
+    EXPECT_EQ(pool.capacity(), chunk);
+
+    // they went back to the depot on exit, so no fresh chunk is carved here
+    std::vector<size_t*> live;
+    for (size_t i = 0; i < chunk; ++i)
+    {
+        live.push_back(pool.acquire(i));
+    }
+    EXPECT_EQ(pool.capacity(), chunk);
+    for (auto* obj : live)
+    {
+        pool.release(obj);
+    }
+
+    // a thread outliving the pool skips its exit hook
+    auto doomed = std::make_unique<ring::core::object_pool_mt<size_t>>(chunk);
+    std::atomic<bool> used{ false };
+    std::atomic<bool> destroyed{ false };
+    std::thread late([&]()
+        {
+            doomed->release(doomed->acquire(1));
+            used = true;
+            while (!destroyed)
+            {
+                std::this_thread::yield();
+            }
+        });
+    while (!used)
+    {
+        std::this_thread::yield();
+    }
+    doomed.reset();
+    destroyed = true;
+    late.join();
+}
+
+TEST_F(CoreTest, ObjectPoolReserve)
+{
+    struct alignas(128) wide
+    {
+        uint64_t value = 0;
+    };
+    ring::core::object_pool<wide> pool(64);
+    pool.reserve(200);
+    EXPECT_EQ(pool.capacity(), 256u);
+    EXPECT_TRUE(pool.empty());
+    std::vector<wide*> live;
+    for (uint64_t i = 0; i < 256; ++i)
+    {
+        live.push_back(pool.acquire(wide{ i }));
+        EXPECT_EQ(reinterpret_cast<uintptr_t>(live.back()) % alignof(wide), 0u);
+    }
+    EXPECT_EQ(pool.capacity(), 256u);
+    EXPECT_EQ(pool.size(), 256u);
+    for (auto* obj : live)
+    {
+        pool.release(obj);
+    }
+    EXPECT_EQ(pool.shrink_to_fit(), 4u);
+
+    ring::core::object_pool_mt<wide> shared(64);
+    auto* first = shared.acquire();
+    shared.reserve(300);
+    EXPECT_EQ(shared.capacity(), 320u);
+    live.clear();
+    for (uint64_t i = 0; i < 319; ++i)
+    {
+        live.push_back(shared.acquire(wide{ i }));
+        EXPECT_EQ(reinterpret_cast<uintptr_t>(live.back()) % alignof(wide), 0u);
+    }
+    EXPECT_EQ(shared.capacity(), 320u);
+    live.push_back(first);
+    std::sort(live.begin(), live.end());
+    EXPECT_EQ(std::adjacent_find(live.begin(), live.end()), live.end());
+    for (auto* obj : live)
+    {
+        shared.release(obj);
+    }
+    EXPECT_TRUE(shared.empty());
+}
+
+TEST_F(CoreTest, MemoryPolicy)
+{
+    constexpr size_t size = 3 * 1024 * 1024;
+
+    ring::core::memory_policy policy;
+    EXPECT_FALSE(policy.applies(size));
+    policy.pages = ring::core::page_mode::transparent_huge;
+    policy.numa_node = ring::core::memory_policy::local_node;
+    policy.prefault = true;
+    EXPECT_TRUE(policy.applies(size));
+    EXPECT_FALSE(policy.applies(policy.min_size - 1));
+    EXPECT_GE(ring::core::current_numa_node(), 0);
+
+    for (auto pages : { ring::core::page_mode::standard, ring::core::page_mode::transparent_huge,
+        ring::core::page_mode::explicit_huge })
+    {
+        policy.pages = pages;
+        auto buffer = ring::core::make_unique_buffer_aligned(size, policy);
+        ASSERT_NE(buffer.get(), nullptr);
+        EXPECT_EQ(reinterpret_cast<uintptr_t>(buffer.get()) % ring::core::detail::cache_line_size, 0u);
+        std::fill(buffer.get(), buffer.get() + size, 'x');
+        EXPECT_EQ(buffer[size - 1], 'x');
+    }
+
+#ifdef RING_PLATFORM_LINUX
+    // whatever the host supports, the fallback chain ends in a usable mapping
+    auto pages = ring::core::detail::allocate_pages(size, policy, ring::core::detail::cache_line_size);
+    EXPECT_GE(pages.mapped, size);
+    if (pages.pages != ring::core::page_mode::standard)
+    {
+        EXPECT_EQ(reinterpret_cast<uintptr_t>(pages.data) % (2 * 1024 * 1024), 0u);
+    }
+    ring::core::detail::release_pages(pages.data, pages.mapped);
+#endif
+
+    // pools and queues pick up the process default
+    auto previous = ring::core::default_memory_policy();
+    policy.pages = ring::core::page_mode::transparent_huge;
+    policy.min_size = 64 * 1024;
+    ring::core::set_default_memory_policy(policy);
+    {
+        ring::core::object_pool<std::array<uint64_t, 16>> pool(4096);
+        auto* obj = pool.acquire();
+        (*obj)[15] = 42;
+        EXPECT_EQ((*obj)[15], 42u);
+        pool.release(obj);
+
+        ring::core::mpmc_queue<uint64_t> queue(65536);
+        EXPECT_TRUE(queue.try_push(7));
+        uint64_t value = 0;
+        EXPECT_TRUE(queue.try_pop(value));
+        EXPECT_EQ(value, 7u);
+    }
+    ring::core::set_default_memory_policy(previous);
+}
+
+TEST_F(CoreTest, FrameArena)
+{
+    ring::core::frame_arena arena(4096);
+    auto* first = arena.create<std::pair<int, double>>(1, 2.0);
+    EXPECT_EQ(first->first, 1);
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(first) % alignof(std::pair<int, double>), 0u);
+    auto* aligned = arena.allocate(10, 64);
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(aligned) % 64, 0u);
+
+    auto before = arena.mark();
+    size_t used = arena.used();
+    {
+        ring::core::frame_arena::scope scope(arena);
+        auto values = arena.allocate_array<uint32_t>(3000);
+        EXPECT_EQ(values.size(), 3000u);
+        EXPECT_TRUE(std::all_of(values.begin(), values.end(), [](uint32_t v) { return v == 0; }));
+        EXPECT_GT(arena.used(), used + 3000 * sizeof(uint32_t));
+    }
+    EXPECT_EQ(arena.used(), used);
+    EXPECT_EQ(arena.mark().chunk, before.chunk);
+
+    // an oversized request gets its own chunk without wasting the regular ones
+    auto* big = static_cast<std::byte*>(arena.allocate(20000));
+    std::fill(big, big + 20000, std::byte{ 1 });
+    size_t tick_peak = arena.peak();
+    EXPECT_GE(tick_peak, 20000u);
+
+    arena.reset();
+    EXPECT_EQ(arena.used(), 0u);
+    EXPECT_EQ(arena.last_tick_peak(), tick_peak);
+    EXPECT_EQ(arena.high_water(), tick_peak);
+
+    // once a tick has run, replaying it does not grow the arena
+    size_t capacity = 0;
+    for (int tick = 0; tick < 10; ++tick)
+    {
+        arena.create<std::pair<int, double>>(1, 2.0);
+        arena.allocate(10, 64);
+        arena.allocate_array<uint32_t>(3000);
+        arena.allocate(20000);
+        arena.reset();
+        if (tick == 0)
+        {
+            capacity = arena.capacity();
+        }
+        EXPECT_EQ(arena.capacity(), capacity);
+    }
+
+    ring::core::frame_memory_resource resource(arena);
+    {
+        std::pmr::vector<int> values(&resource);
+        for (int i = 0; i < 1000; ++i)
+        {
+            values.push_back(i);
+        }
+        EXPECT_EQ(values[999], 999);
+    }
+    EXPECT_GT(arena.used(), 1000 * sizeof(int));
+    arena.reset();
+
+    auto* local = &ring::core::frame_arena::local();
+    ring::core::frame_arena* other = nullptr;
+    std::thread([&]() { other = &ring::core::frame_arena::local(); }).join();
+    EXPECT_NE(local, other);
+    EXPECT_EQ(local, &ring::core::frame_arena::local());
+}
+
+TEST_F(CoreTest, SlabAllocator)
+{
+    EXPECT_EQ(ring::core::slab_allocator::block_size(1), 16u);
+    EXPECT_EQ(ring::core::slab_allocator::block_size(17), 32u);
+    EXPECT_EQ(ring::core::slab_allocator::block_size(1500), 2048u);
+    EXPECT_EQ(ring::core::slab_allocator::block_size(65536), 65536u);
+    EXPECT_EQ(ring::core::slab_allocator::class_index(65536), ring::core::slab_allocator::class_count - 1);
+
+    ring::core::slab_allocator slab;
+    std::vector<std::span<std::byte>> buffers;
+    for (size_t size : { 1, 16, 100, 1500, 9000, 65536, 100000 })
+    {
+        auto buffer = slab.allocate(size);
+        ASSERT_EQ(buffer.size(), size);
+        std::fill(buffer.begin(), buffer.end(), static_cast<std::byte>(size));
+        buffers.push_back(buffer);
+    }
+    for (auto buffer : buffers)
+    {
+        EXPECT_TRUE(std::all_of(buffer.begin(), buffer.end(),
+            [&](std::byte b) { return b == static_cast<std::byte>(buffer.size()); }));
+    }
+
+    auto stats = slab.stats();
+    ASSERT_EQ(stats.classes.size(), ring::core::slab_allocator::class_count);
+    auto& mtu = stats.classes[ring::core::slab_allocator::class_index(1500)];
+    EXPECT_EQ(mtu.block_size, 2048u);
+    EXPECT_EQ(mtu.live, 1u);
+    EXPECT_EQ(mtu.requested_bytes, 1500u);
+    EXPECT_GT(mtu.fragmentation, 0.0);
+    EXPECT_EQ(stats.large_live, 1u);
+    EXPECT_EQ(stats.large_bytes, 100000u);
+
+    for (auto buffer : buffers)
+    {
+        slab.deallocate(buffer);
+    }
+    stats = slab.stats();
+    for (auto& entry : stats.classes)
+    {
+        EXPECT_EQ(entry.live, 0u);
+    }
+    EXPECT_EQ(stats.classes[ring::core::slab_allocator::class_index(1500)].peak, 1u);
+    EXPECT_EQ(stats.large_live, 0u);
+
+    // buffers released on another thread are reused
+    std::vector<std::thread> threads;
+    ring::core::mpmc_queue<std::span<std::byte>> handoff(1024);
+    std::atomic<bool> error_flag{ false };
+    for (size_t t = 0; t < 4; ++t)
+    {
+        threads.emplace_back([&, t]()
+            {
+                for (size_t i = 0; i < 20000; ++i)
+                {
+                    auto buffer = slab.allocate(16 + (i * 37 + t) % 4000);
+                    buffer[0] = static_cast<std::byte>(t);
+                    buffer[buffer.size() - 1] = static_cast<std::byte>(t);
+                    if (buffer[0] != static_cast<std::byte>(t))
+                    {
+                        error_flag = true;
+                    }
+                    if (!handoff.try_push(buffer))
+                    {
+                        slab.deallocate(buffer);
+                    }
+                    std::span<std::byte> foreign;
+                    if (handoff.try_pop(foreign))
+                    {
+                        slab.deallocate(foreign);
+                    }
+                }
+            });
+    }
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+    std::span<std::byte> foreign;
+    while (handoff.try_pop(foreign))
+    {
+        slab.deallocate(foreign);
+    }
+    EXPECT_FALSE(error_flag);
+    for (auto& entry : slab.stats().classes)
+    {
+        EXPECT_EQ(entry.live, 0u);
+    }
+
+    ring::core::slab_memory_resource resource(slab);
+    {
+        std::pmr::vector<uint64_t> values(&resource);
+        for (uint64_t i = 0; i < 10000; ++i)
+        {
+            values.push_back(i);
+        }
+        EXPECT_EQ(std::accumulate(values.begin(), values.end(), uint64_t{ 0 }), 9999u * 10000u / 2);
+        std::pmr::string text("a string long enough to leave the small buffer", &resource);
+        EXPECT_GT(slab.stats().classes[ring::core::slab_allocator::class_index(64)].live, 0u);
+    }
+    for (auto& entry : slab.stats().classes)
+    {
+        EXPECT_EQ(entry.live, 0u);
+    }
+    EXPECT_EQ(slab.stats().large_live, 0u);
+}
+
+TEST_F(CoreTest, PoolAllocator)
+{
+    struct Session
+    {
+        Session(size_t id, std::atomic<size_t>& destroyed) :
+            id(id), destroyed(destroyed) {}
+        ~Session()
+        {
+            destroyed.fetch_add(1);
+        }
+        size_t id;
+        std::atomic<size_t>& destroyed;
+    };
+    std::atomic<size_t> destroyed{ 0 };
+
+    {
+        ring::core::object_pool_mt<Session> pool;
+        {
+            auto session = ring::core::make_pool_unique(pool, 7, destroyed);
+            EXPECT_EQ(session->id, 7u);
+            EXPECT_EQ(pool.size(), 1u);
+            ring::core::pool_unique_ptr<Session> moved = std::move(session);
+            EXPECT_EQ(moved.get_deleter().pool(), &pool);
+        }
+        EXPECT_EQ(destroyed, 1u);
+        EXPECT_TRUE(pool.empty());
+
+        ring::core::object_pool<Session> local;
+        auto session = ring::core::make_pool_unique(local, 8, destroyed);
+        session.reset();
+        EXPECT_EQ(destroyed, 2u);
+        EXPECT_TRUE(local.empty());
+    }
+
+    // control block and object come out of one pooled slot and outlive the allocator
+    std::vector<std::shared_ptr<Session>> sessions;
+    {
+        ring::core::pool_allocator<Session> allocator(64);
+        for (size_t i = 0; i < 200; ++i)
+        {
+            sessions.push_back(ring::core::make_pool_shared(allocator, i, destroyed));
+        }
+        auto copy = allocator;
+        EXPECT_TRUE(copy == allocator);
+        EXPECT_FALSE(ring::core::pool_allocator<Session>() == allocator);
+    }
+    std::vector<std::thread> threads;
+    for (size_t t = 0; t < 4; ++t)
+    {
+        threads.emplace_back([&, t]()
+            {
+                for (size_t i = t; i < sessions.size(); i += 4)
+                {
+                    EXPECT_EQ(sessions[i]->id, i);
+                    sessions[i].reset();
+                }
+            });
+    }
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+    EXPECT_EQ(destroyed, 202u);
+
+    ring::core::pool_memory_resource<64> resource(256);
+    {
+        std::pmr::list<uint64_t> values(&resource);
+        for (uint64_t i = 0; i < 1000; ++i)
+        {
+            values.push_back(i);
+        }
+        EXPECT_EQ(resource.size(), 1000u);
+        std::pmr::vector<uint64_t> large(1000, 1, &resource);
+        EXPECT_EQ(resource.size(), 1000u);
+        EXPECT_EQ(std::accumulate(values.begin(), values.end(), uint64_t{ 0 }), 999u * 1000u / 2);
+    }
+    EXPECT_EQ(resource.size(), 0u);
+    EXPECT_GE(resource.capacity(), 1000u);
+}
+
+TEST_F(CoreTest, SlotMap)
+{
+    ring::core::slot_map<std::string> map;
+    std::vector<ring::core::slot_handle> handles;
+    for (size_t i = 0; i < 100; ++i)
+    {
+        handles.push_back(map.emplace(std::to_string(i)));
+    }
+    EXPECT_EQ(map.size(), 100u);
+    EXPECT_FALSE(map.contains(ring::core::slot_handle()));
+
+    // erase every third value; the rest keep resolving after swap-remove
+    for (size_t i = 0; i < handles.size(); i += 3)
+    {
+        EXPECT_TRUE(map.erase(handles[i]));
+        EXPECT_FALSE(map.erase(handles[i]));
+    }
+    for (size_t i = 0; i < handles.size(); ++i)
+    {
+        auto* value = map.get(handles[i]);
+        if (i % 3 == 0)
+        {
+            EXPECT_EQ(value, nullptr);
+        }
+        else
+        {
+            ASSERT_NE(value, nullptr);
+            EXPECT_EQ(*value, std::to_string(i));
+        }
+    }
+    EXPECT_EQ(map.size(), 66u);
+    EXPECT_EQ(static_cast<size_t>(std::distance(map.begin(), map.end())), map.size());
+    for (size_t position = 0; position < map.size(); ++position)
+    {
+        EXPECT_EQ(map.get(map.handle_at(position)), map.data() + position);
+    }
+
+    // reused slots get a new generation, so stale handles stay dead
+    auto reused = map.emplace("reused");
+    EXPECT_EQ(reused.index(), handles[99].index());
+    EXPECT_NE(reused.generation(), handles[99].generation());
+    EXPECT_EQ(map.get(handles[99]), nullptr);
+    EXPECT_EQ(*map.get(reused), "reused");
+
+    map.clear();
+    EXPECT_TRUE(map.empty());
+    EXPECT_FALSE(map.contains(reused));
+
+    // a 32-bit slot is retired once its 12-bit generation runs out, so a
+    // stale handle never comes back to life
+    ring::core::slot_map<int, ring::core::slot_handle32> small;
+    auto first = small.emplace(0);
+    auto stale = small.emplace(-1);
+    small.erase(stale);
+    for (int i = 0; i < 5000; ++i)
+    {
+        auto handle = small.emplace(i);
+        EXPECT_NE(handle.generation(), 0u);
+        EXPECT_EQ(handle.index(), i < 4094 ? stale.index() : stale.index() + 1);
+        EXPECT_FALSE(small.contains(stale));
+        small.erase(handle);
+    }
+    EXPECT_EQ(small.retired(), 1u);
+    EXPECT_FALSE(small.contains(ring::core::slot_handle32(stale.index(), 0)));
+    EXPECT_EQ(*small.get(first), 0);
+    EXPECT_EQ(ring::core::slot_handle32::from_value(first.value()), first);
+
+    ring::core::concurrent_slot_map<size_t> shared;
+    std::vector<ring::core::slot_handle> live;
+    for (size_t i = 0; i < 1000; ++i)
+    {
+        live.push_back(shared.emplace(i));
+    }
+    std::atomic<bool> done{ false };
+    std::atomic<bool> error_flag{ false };
+    std::vector<std::thread> readers;
+    for (size_t t = 0; t < 4; ++t)
+    {
+        readers.emplace_back([&]()
+            {
+                while (!done)
+                {
+                    for (size_t i = 0; i < live.size(); ++i)
+                    {
+                        shared.read(live[i], [&](size_t value)
+                            {
+                                if (value != i)
+                                {
+                                    error_flag = true;
+                                }
+                            });
+                    }
+                }
+            });
+    }
+    for (size_t i = 0; i < live.size(); i += 2)
+    {
+        EXPECT_TRUE(shared.erase(live[i]));
+        shared.emplace(live.size() + i);
+    }
+    done = true;
+    for (auto& reader : readers)
+    {
+        reader.join();
+    }
+    EXPECT_FALSE(error_flag);
+    EXPECT_EQ(shared.size(), 1000u);
+    EXPECT_TRUE(shared.write(live[1], [](size_t& value) { value = 42; }));
+    EXPECT_TRUE(shared.read(live[1], [](size_t value) { EXPECT_EQ(value, 42u); }));
+    EXPECT_FALSE(shared.read(live[0], [](size_t) {}));
+}
+
 template <bool WithString>
 struct TestItemImpl
 {
@@ -343,6 +1009,769 @@ TEST_F(CoreTest, MPMCQueue)
     std::cout << "Stress Test Passed: No data loss, no crash." << std::endl;
 }
 
+TEST_F(CoreTest, QueueWaitStrategy)
+{
+    using namespace std::chrono_literals;
+
+    {
+        spsc_queue<size_t, busy_spin_wait> queue(2);
+        size_t value = 0;
+        EXPECT_FALSE(queue.pop_for(value, 1ms));
+        EXPECT_TRUE(queue.push_for(1, 1ms));
+        EXPECT_TRUE(queue.push_for(2, 1ms));
+        EXPECT_FALSE(queue.push_for(3, 1ms));
+        EXPECT_TRUE(queue.pop_for(value, 1ms));
+        EXPECT_EQ(value, 1u);
+    }
+    {
+        mpmc_queue<size_t, spin_park_wait> queue(16);
+        constexpr size_t items = 100000;
+        std::atomic<size_t> sum{ 0 };
+        std::vector<std::thread> consumers;
+        for (size_t i = 0; i < 2; ++i)
+        {
+            consumers.emplace_back([&]()
+                {
+                    for (size_t j = 0; j < items / 2; ++j)
+                    {
+                        size_t value = 0;
+                        queue.pop(value);
+                        sum.fetch_add(value, std::memory_order_relaxed);
+                    }
+                });
+        }
+        std::this_thread::sleep_for(10ms);
+        for (size_t i = 1; i <= items; ++i)
+        {
+            queue.push(i);
+        }
+        for (auto& t : consumers)
+        {
+            t.join();
+        }
+        EXPECT_EQ(sum.load(), items * (items + 1) / 2);
+        EXPECT_TRUE(queue.empty());
+        size_t value = 0;
+        EXPECT_FALSE(queue.pop_until(value, std::chrono::steady_clock::now() + 5ms));
+    }
+}
+
+TEST_F(CoreTest, StaticQueue)
+{
+    struct Event
+    {
+        uint32_t type;
+        uint32_t session;
+        uint64_t payload;
+    };
+
+    {
+        static_spsc_queue<Event, 8> queue;
+        EXPECT_EQ(queue.capacity(), 8u);
+
+        std::array<Event, 6> in{};
+        std::array<Event, 6> out{};
+        for (size_t round = 0; round < 4; ++round)
+        {
+            for (size_t i = 0; i < in.size(); ++i)
+            {
+                in[i] = { static_cast<uint32_t>(round), static_cast<uint32_t>(i), round * 100 + i };
+            }
+            EXPECT_EQ(queue.try_push_batch(in.begin(), in.end()), in.size());
+            EXPECT_EQ(queue.try_pop_batch(out.begin(), out.size()), out.size());
+            for (size_t i = 0; i < out.size(); ++i)
+            {
+                EXPECT_EQ(out[i].payload, round * 100 + i);
+            }
+        }
+    }
+    {
+        auto queue = std::make_unique<static_mpmc_queue<TestItem, 1024>>();
+        constexpr size_t items = 100000;
+        std::atomic<size_t> popped{ 0 };
+        std::vector<std::thread> threads;
+        for (size_t k = 0; k < 2; ++k)
+        {
+            threads.emplace_back([&, k]()
+                {
+                    for (size_t i = 0; i < items / 2; ++i)
+                    {
+                        queue->push(TestItem(k, i));
+                    }
+                });
+            threads.emplace_back([&]()
+                {
+                    std::array<TestItem, 64> out;
+                    while (popped.load(std::memory_order_relaxed) < items)
+                    {
+                        popped.fetch_add(queue->try_pop_batch(out.begin(), out.size()), std::memory_order_relaxed);
+                    }
+                });
+        }
+        for (auto& t : threads)
+        {
+            t.join();
+        }
+        EXPECT_EQ(popped.load(), items);
+        EXPECT_TRUE(queue->empty());
+    }
+}
+
+TEST_F(CoreTest, QueueReserveCommit)
+{
+    {
+        spsc_queue<std::string> queue(4);
+        for (size_t round = 0; round < 3; ++round)
+        {
+            auto range = queue.reserve(3);
+            ASSERT_EQ(range.size(), 3u);
+            for (size_t i = 0; i < range.size(); ++i)
+            {
+                std::construct_at(&range[i], std::format("message_{}_{}", round, i));
+            }
+            queue.commit(range.first(2));
+            std::destroy_at(&range[2]);
+
+            auto view = queue.peek();
+            ASSERT_EQ(view.size(), 2u);
+            EXPECT_EQ(view[0], std::format("message_{}_0", round));
+            EXPECT_EQ(view[1], std::format("message_{}_1", round));
+            queue.consume(view.size());
+            EXPECT_TRUE(queue.empty());
+        }
+#ifndef NDEBUG
+        EXPECT_DEATH(queue.consume(1), "consume past the peeked range");
+#endif
+        EXPECT_EQ(queue.reserve(8).size(), 4u);
+    }
+    {
+        // a reserve only comes back empty when the queue is full
+        mpsc_queue<size_t> queue(8);
+        for (size_t i = 0; i < queue.capacity(); ++i)
+        {
+            auto range = queue.reserve(1);
+            ASSERT_EQ(range.size(), 1u);
+            range[0] = i;
+            queue.commit(range);
+        }
+        EXPECT_TRUE(queue.reserve(1).empty());
+        queue.consume(queue.peek(2).size());
+#ifndef NDEBUG
+        EXPECT_DEATH(queue.consume(queue.capacity()), "consume past the peeked range");
+#endif
+    }
+    {
+        mpsc_queue<TestItem> queue(1024);
+        constexpr size_t items = 100000;
+        std::vector<std::thread> producers;
+        for (size_t k = 0; k < producer_count; ++k)
+        {
+            producers.emplace_back([&, k]()
+                {
+                    for (size_t i = 0; i < items / producer_count; )
+                    {
+                        auto range = queue.reserve(std::min<size_t>(16, items / producer_count - i));
+                        for (size_t j = 0; j < range.size(); ++j)
+                        {
+                            std::construct_at(&range[j], k, i + j);
+                        }
+                        queue.commit(range);
+                        i += range.size();
+                    }
+                });
+        }
+        std::vector<size_t> next(producer_count, 0);
+        for (size_t popped = 0; popped < items; )
+        {
+            auto view = queue.peek();
+            for (size_t i = 0; i < view.size(); ++i)
+            {
+                EXPECT_EQ(view[i].sequence, next[view[i].producer_id]++);
+            }
+            queue.consume(view.size());
+            popped += view.size();
+        }
+        for (auto& t : producers)
+        {
+            t.join();
+        }
+        EXPECT_TRUE(queue.empty());
+    }
+}
+
+template <typename Layout>
+void run_layout_queue()
+{
+    mpmc_queue<TestItem, spin_yield_wait, Layout> queue(1000);
+    constexpr size_t items = 100000;
+    std::atomic<size_t> popped{ 0 };
+    std::vector<std::thread> threads;
+    for (size_t k = 0; k < 2; ++k)
+    {
+        threads.emplace_back([&, k]()
+            {
+                for (size_t i = 0; i < items / 2; ++i)
+                {
+                    queue.push(TestItem(k, i));
+                }
+            });
+        threads.emplace_back([&]()
+            {
+                std::array<TestItem, 32> out;
+                while (popped.load(std::memory_order_relaxed) < items)
+                {
+                    popped.fetch_add(queue.try_pop_batch(out.begin(), out.size()), std::memory_order_relaxed);
+                }
+            });
+    }
+    for (auto& t : threads)
+    {
+        t.join();
+    }
+    EXPECT_EQ(popped.load(), items);
+    EXPECT_TRUE(queue.empty());
+    EXPECT_GE(queue.capacity(), 1000u);
+}
+
+TEST_F(CoreTest, QueueSlotLayout)
+{
+    run_layout_queue<split_layout>();
+    run_layout_queue<interleaved_layout>();
+    run_layout_queue<padded_layout>();
+    run_layout_queue<swizzled_layout>();
+
+    // only swizzling rounds the capacity, up to whole cache lines of cells
+    EXPECT_EQ((mpmc_queue<size_t, spin_yield_wait, padded_layout>(1000).capacity()), 1000u);
+    mpmc_queue<size_t, spin_yield_wait, swizzled_layout> rounded(1001);
+    EXPECT_GT(rounded.capacity(), 1001u);
+    EXPECT_EQ(rounded.capacity() % (detail::cache_line_size / (2 * sizeof(size_t))), 0u);
+
+    mpmc_queue<size_t, spin_yield_wait, swizzled_layout> queue(64);
+    for (size_t round = 0; round < 3; ++round)
+    {
+        for (size_t i = 0; i < queue.capacity(); ++i)
+        {
+            queue.push(round * 100 + i);
+        }
+        EXPECT_FALSE(queue.try_push(0));
+        for (size_t i = 0; i < queue.capacity(); ++i)
+        {
+            size_t value = 0;
+            queue.pop(value);
+            EXPECT_EQ(value, round * 100 + i);
+        }
+    }
+}
+
+TEST_F(CoreTest, UnboundedQueue)
+{
+    {
+        unbounded_mpsc_queue<std::string> queue(4, 10);
+        for (size_t i = 0; i < 100; ++i)
+        {
+            EXPECT_TRUE(queue.try_push(std::to_string(i)));
+        }
+        EXPECT_EQ(queue.size(), 100u);
+        EXPECT_TRUE(queue.backpressure());
+        std::string value;
+        for (size_t i = 0; i < 100; ++i)
+        {
+            ASSERT_TRUE(queue.try_pop(value));
+            EXPECT_EQ(value, std::to_string(i));
+        }
+        EXPECT_FALSE(queue.try_pop(value));
+        EXPECT_FALSE(queue.backpressure());
+    }
+    {
+        unbounded_mpmc_queue<TestItem> queue(64);
+        constexpr size_t items = 100000;
+        std::atomic<size_t> popped{ 0 };
+        std::vector<std::thread> threads;
+        for (size_t k = 0; k < producer_count; ++k)
+        {
+            threads.emplace_back([&, k]()
+                {
+                    for (size_t i = 0; i < items / producer_count; ++i)
+                    {
+                        queue.push(TestItem(k, i));
+                    }
+                });
+        }
+        for (size_t k = 0; k < consumer_count; ++k)
+        {
+            threads.emplace_back([&]()
+                {
+                    std::array<TestItem, 16> out;
+                    while (popped.load(std::memory_order_relaxed) < items)
+                    {
+                        popped.fetch_add(queue.try_pop_batch(out.begin(), out.size()), std::memory_order_relaxed);
+                    }
+                });
+        }
+        for (auto& t : threads)
+        {
+            t.join();
+        }
+        EXPECT_EQ(popped.load(), items);
+        EXPECT_TRUE(queue.empty());
+    }
+}
+
+TEST_F(CoreTest, WorkStealingDeque)
+{
+    work_stealing_deque<size_t> deque(4);
+    for (size_t i = 0; i < 100; ++i)
+    {
+        deque.push(i);
+    }
+    EXPECT_EQ(deque.size(), 100u);
+    size_t value = 0;
+    EXPECT_TRUE(deque.steal(value));
+    EXPECT_EQ(value, 0u);
+    EXPECT_TRUE(deque.pop(value));
+    EXPECT_EQ(value, 99u);
+
+    constexpr size_t items = 100000;
+    std::atomic<size_t> sum{ 0 };
+    std::atomic<size_t> taken{ 2 };
+    std::atomic<bool> done{ false };
+    std::vector<std::thread> thieves;
+    for (size_t k = 0; k < consumer_count; ++k)
+    {
+        thieves.emplace_back([&]()
+            {
+                size_t item = 0;
+                while (!done.load(std::memory_order_acquire) || !deque.empty())
+                {
+                    if (deque.steal(item))
+                    {
+                        sum.fetch_add(item, std::memory_order_relaxed);
+                        taken.fetch_add(1, std::memory_order_relaxed);
+                    }
+                }
+            });
+    }
+    for (size_t i = 100; i < items; ++i)
+    {
+        deque.push(i);
+        if (i % 3 == 0 && deque.pop(value))
+        {
+            sum.fetch_add(value, std::memory_order_relaxed);
+            taken.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+    while (deque.pop(value))
+    {
+        sum.fetch_add(value, std::memory_order_relaxed);
+        taken.fetch_add(1, std::memory_order_relaxed);
+    }
+    done.store(true, std::memory_order_release);
+    for (auto& t : thieves)
+    {
+        t.join();
+    }
+    EXPECT_EQ(taken.load(), items);
+    EXPECT_EQ(sum.load(), items * (items - 1) / 2 - 99);
+}
+
+TEST_F(CoreTest, JobScheduler)
+{
+    auto& scheduler = job_scheduler::instance();
+    scheduler.initialize({ .workers = 4 });
+    EXPECT_EQ(scheduler.worker_count(), 4u);
+    EXPECT_THROW(scheduler.initialize(), ring::core::exception);
+
+    std::atomic<size_t> executed{ 0 };
+    job_counter counter;
+    for (size_t i = 0; i < 1000; ++i)
+    {
+        scheduler.spawn(counter, [&]()
+            {
+                executed.fetch_add(1, std::memory_order_relaxed);
+            });
+    }
+    scheduler.wait(counter);
+    EXPECT_TRUE(counter.done());
+    EXPECT_EQ(executed.load(), 1000u);
+
+    std::vector<size_t> values(100000, 1);
+    scheduler.parallel_for(0, values.size(), [&](size_t i) { values[i] += i; });
+    for (size_t i = 0; i < values.size(); ++i)
+    {
+        ASSERT_EQ(values[i], i + 1);
+    }
+    std::atomic<size_t> total{ 0 };
+    scheduler.parallel_for(0, values.size(), [&](size_t first, size_t last)
+        {
+            size_t local = 0;
+            for (size_t i = first; i < last; ++i)
+            {
+                local += values[i];
+            }
+            total.fetch_add(local, std::memory_order_relaxed);
+        }, 1024);
+    EXPECT_EQ(total.load(), values.size() * (values.size() + 1) / 2);
+
+    std::array<std::byte, 512> payload{};
+    job_counter large;
+    scheduler.spawn(large, [payload, &executed]() { executed.fetch_add(payload.size(), std::memory_order_relaxed); });
+    scheduler.wait(large);
+    EXPECT_EQ(executed.load(), 1000u + payload.size());
+
+    scheduler.shutdown();
+    EXPECT_EQ(scheduler.worker_count(), 0u);
+    EXPECT_THROW(scheduler.spawn([]() {}), ring::core::exception);
+}
+
+TEST_F(CoreTest, BroadcastRing)
+{
+    {
+        spmc_broadcast_ring<size_t> ring(8);
+        auto& first = ring.add_consumer();
+        auto& second = ring.add_consumer();
+        auto& after = ring.add_consumer({ &first, &second });
+        std::vector<size_t> values(12);
+        std::iota(values.begin(), values.end(), 0);
+        EXPECT_EQ(ring.try_publish_batch(values.begin(), values.end()), 8u);
+        EXPECT_FALSE(ring.try_publish(8));
+        EXPECT_EQ(after.available(), 0u);
+
+        auto range = first.peek();
+        ASSERT_EQ(range.size(), 8u);
+        for (size_t i = 0; i < range.size(); ++i)
+        {
+            EXPECT_EQ(range[i], i);
+        }
+        first.consume(range.size());
+        EXPECT_EQ(after.available(), 0u);
+        size_t value = 0;
+        ASSERT_TRUE(second.try_read(value));
+        EXPECT_EQ(value, 0u);
+        EXPECT_EQ(after.available(), 1u);
+        EXPECT_FALSE(ring.try_publish(8));
+        EXPECT_EQ(after.try_process([](size_t v, size_t seq) { EXPECT_EQ(v, seq); }), 1u);
+        EXPECT_TRUE(ring.try_publish(8));
+        EXPECT_FALSE(ring.try_publish(9));
+    }
+    {
+        mpmc_broadcast_ring<size_t> ring(256);
+        constexpr size_t items = 100000;
+        auto& persistence = ring.add_consumer();
+        auto& replication = ring.add_consumer();
+        auto& analytics = ring.add_consumer({ &persistence, &replication });
+        std::vector<std::thread> threads;
+        std::array<size_t, 3> sums{};
+        std::array<decltype(&persistence), 3> consumers{ &persistence, &replication, &analytics };
+        for (size_t k = 0; k < consumers.size(); ++k)
+        {
+            threads.emplace_back([&, k]()
+                {
+                    size_t seen = 0;
+                    while (seen < items)
+                    {
+                        seen += consumers[k]->process([&](size_t v, size_t) { sums[k] += v; });
+                    }
+                });
+        }
+        for (size_t k = 0; k < producer_count; ++k)
+        {
+            threads.emplace_back([&, k]()
+                {
+                    for (size_t i = k; i < items; i += producer_count)
+                    {
+                        ring.publish(i);
+                    }
+                });
+        }
+        for (auto& t : threads)
+        {
+            t.join();
+        }
+        for (size_t sum : sums)
+        {
+            EXPECT_EQ(sum, items * (items - 1) / 2);
+        }
+    }
+}
+
+TEST_F(CoreTest, TimingWheel)
+{
+    using namespace std::chrono_literals;
+    auto origin = timing_wheel<>::clock::now();
+    timing_wheel<> wheel(1ms, 16, origin);
+    std::vector<int> fired;
+
+    auto first = wheel.schedule(origin + 5ms, [&]() { fired.push_back(5); });
+    auto cancelled = wheel.schedule(origin + 7ms, [&]() { fired.push_back(7); });
+    auto moved = wheel.schedule(origin + 9ms, [&]() { fired.push_back(9); });
+    wheel.schedule(origin + 100ms, [&]() { fired.push_back(100); });
+    wheel.schedule(origin + 5000ms, [&]() { fired.push_back(5000); });
+    wheel.schedule(origin + 300000ms, [&]() { fired.push_back(300000); });
+    EXPECT_EQ(wheel.size(), 6u);
+    EXPECT_TRUE(wheel.cancel(cancelled));
+    EXPECT_FALSE(cancelled.active());
+    EXPECT_FALSE(wheel.cancel(cancelled));
+    EXPECT_TRUE(wheel.reschedule(moved, origin + 64ms));
+
+    EXPECT_EQ(wheel.advance(origin + 4ms), 0u);
+    EXPECT_EQ(wheel.advance(origin + 5ms), 1u);
+    EXPECT_FALSE(first.active());
+    EXPECT_EQ(wheel.advance(origin + 63ms), 0u);
+    EXPECT_TRUE(moved.active());
+    EXPECT_EQ(wheel.advance(origin + 64ms), 1u);
+    EXPECT_TRUE(wheel.post(origin + 150ms, [&]() { fired.push_back(150); }));
+    EXPECT_EQ(wheel.advance(origin + 99ms), 0u);
+    EXPECT_EQ(wheel.advance(origin + 4999ms), 2u);
+    EXPECT_EQ(wheel.advance(origin + 5000ms), 1u);
+    EXPECT_EQ(wheel.advance(origin + 400000ms), 1u);
+    EXPECT_TRUE(wheel.empty());
+    EXPECT_EQ(fired, (std::vector<int>{ 5, 9, 100, 150, 5000, 300000 }));
+
+    // every timer fires exactly on its own tick, including across cascades
+    std::vector<size_t> expected;
+    std::vector<size_t> actual;
+    for (size_t i = 1; i < 20000; i += 7)
+    {
+        expected.push_back(400000 + i);
+        wheel.schedule(origin + std::chrono::milliseconds(400000 + i), [&, i]() { actual.push_back(400000 + i); });
+    }
+    for (size_t tick = 400001; tick < 420000; ++tick)
+    {
+        size_t before = actual.size();
+        wheel.advance(origin + std::chrono::milliseconds(tick));
+        for (size_t k = before; k < actual.size(); ++k)
+        {
+            ASSERT_EQ(actual[k], tick);
+        }
+    }
+    EXPECT_EQ(actual, expected);
+
+    // dropping a handle leaves the timer scheduled
+    size_t posted = 0;
+    {
+        auto dropped = wheel.schedule(origin + 420005ms, [&]() { ++posted; });
+    }
+    std::thread poster([&]()
+        {
+            for (size_t i = 0; i < 10; ++i)
+            {
+                while (!wheel.post(origin + 420010ms, [&]() { ++posted; }))
+                {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    poster.join();
+    EXPECT_EQ(wheel.advance(origin + 420010ms), 11u);
+    EXPECT_EQ(posted, 11u);
+}
+
+TEST_F(CoreTest, QueueStats)
+{
+    static_assert(sizeof(mpmc_queue<int, busy_spin_wait, split_layout, no_queue_stats>) ==
+        sizeof(detail::mpmc_queue<int>), "disabled stats must not grow the queue");
+
+    mpmc_queue<size_t, spin_yield_wait, split_layout, queue_stats> queue(8);
+    for (size_t i = 0; i < 8; ++i)
+    {
+        EXPECT_TRUE(queue.try_push(i));
+    }
+    EXPECT_FALSE(queue.try_push(8));
+    size_t value = 0;
+    std::array<size_t, 8> out;
+    EXPECT_EQ(queue.try_pop_batch(out.begin(), 5), 5u);
+    EXPECT_TRUE(queue.try_pop(value));
+    EXPECT_EQ(queue.try_pop_batch(out.begin(), 8), 2u);
+    EXPECT_FALSE(queue.try_pop(value));
+
+    auto stats = queue.stats().snapshot();
+    EXPECT_EQ(stats.pushes, 8u);
+    EXPECT_EQ(stats.pops, 8u);
+    EXPECT_EQ(stats.full_rejections, 1u);
+    EXPECT_EQ(stats.empty_rejections, 1u);
+    EXPECT_EQ(stats.high_water, 8u);
+    EXPECT_EQ(to_string(stats).rfind("pushes=8 pops=8 full=1 empty=1", 0), 0u);
+    // one winning compare-exchange per push, and per pop call; weak ones may also fail spuriously
+    EXPECT_EQ(stats.push_cas - stats.push_cas_failures, 8u);
+    EXPECT_EQ(stats.pop_cas - stats.pop_cas_failures, 3u);
+
+    std::thread consumer([&]()
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+            for (size_t i = 0; i < 1000; ++i)
+            {
+                queue.pop(value);
+            }
+        });
+    for (size_t i = 0; i < 1000; ++i)
+    {
+        queue.push(i);
+    }
+    consumer.join();
+    stats = queue.stats().snapshot();
+    EXPECT_EQ(stats.pushes, 1008u);
+    EXPECT_EQ(stats.pops, 1008u);
+    EXPECT_GT(stats.push_waits + stats.pop_waits, 0u);
+    uint64_t samples = 0;
+    for (uint64_t bucket : stats.occupancy)
+    {
+        samples += bucket;
+    }
+    EXPECT_EQ(samples, 1008u / queue_stats::sample_interval);
+
+    queue.stats().reset();
+    EXPECT_EQ(queue.stats().snapshot().pushes, 0u);
+    EXPECT_EQ(queue.stats().snapshot().high_water, 0u);
+    EXPECT_EQ(queue.stats().snapshot().push_cas, 0u);
+
+    // mpsc producers retry a lost claim inside the backend; the CAS count still sees it
+    mpsc_queue<size_t, spin_yield_wait, split_layout, queue_stats> shared(64);
+    std::vector<std::thread> producers;
+    for (size_t t = 0; t < 4; ++t)
+    {
+        producers.emplace_back([&]()
+            {
+                for (size_t i = 0; i < 10000; ++i)
+                {
+                    shared.push(i);
+                }
+            });
+    }
+    for (size_t i = 0; i < 40000; ++i)
+    {
+        shared.pop(value);
+    }
+    for (auto& producer : producers)
+    {
+        producer.join();
+    }
+    stats = shared.stats().snapshot();
+    EXPECT_EQ(stats.pushes, 40000u);
+    EXPECT_EQ(stats.push_cas - stats.push_cas_failures, 40000u);
+    EXPECT_EQ(stats.pop_cas, 0u);
+}
+
+TEST_F(CoreTest, SharedQueue)
+{
+    using PlainItem = TestItemImpl<false>;
+    using namespace std::chrono_literals;
+    const std::string name = "ring_test_shared_queue_" + std::to_string(shared_memory_region::process_id());
+    shared_memory_region::remove(name);
+
+    shared_spsc_queue<PlainItem> consumer(name, shm_mode::create, shm_role::consumer, 64, 7);
+    EXPECT_FALSE(consumer.peer_alive(1s));
+    EXPECT_THROW(shared_spsc_queue<PlainItem>(name, shm_mode::create, shm_role::producer, 64, 7), ring::core::exception);
+    EXPECT_THROW(shared_spsc_queue<PlainItem>(name, shm_mode::attach, shm_role::producer, 0, 8), ring::core::exception);
+    EXPECT_THROW(shared_mpsc_queue<PlainItem>(name, shm_mode::attach, shm_role::producer, 0, 7), ring::core::exception);
+    EXPECT_THROW(shared_spsc_queue<uint64_t>(name, shm_mode::attach, shm_role::producer, 0, 7), ring::core::exception);
+    EXPECT_THROW(shared_spsc_queue<PlainItem>("ring_test_missing", shm_mode::attach, shm_role::producer, 0, 7, 10ms),
+        ring::core::exception);
+
+    constexpr size_t items = 10000;
+    std::thread producer_thread([&]()
+        {
+            shared_spsc_queue<PlainItem> producer(name, shm_mode::attach, shm_role::producer, 64, 7);
+            EXPECT_TRUE(producer.peer_alive(1s));
+            for (size_t i = 0; i < items; ++i)
+            {
+                ASSERT_TRUE(producer.push_for(PlainItem(1, i), 5s));
+            }
+        });
+    PlainItem item;
+    for (size_t i = 0; i < items; ++i)
+    {
+        ASSERT_TRUE(consumer.pop_for(item, 5s));
+        EXPECT_EQ(item.sequence, i);
+    }
+    producer_thread.join();
+    // a producer that detached is no longer a live peer
+    EXPECT_FALSE(consumer.peer_alive(1s));
+    EXPECT_FALSE(consumer.pop_for(item, 1ms));
+
+    // one consumer at a time; once it detaches the entry is free again
+    const std::string single_name = name + "_single";
+    shared_memory_region::remove(single_name);
+    {
+        shared_spsc_queue<PlainItem> source(single_name, shm_mode::create, shm_role::producer, 64);
+        auto sink = std::make_unique<shared_spsc_queue<PlainItem>>(single_name, shm_mode::attach, shm_role::consumer);
+        EXPECT_THROW(shared_spsc_queue<PlainItem>(single_name, shm_mode::attach, shm_role::consumer),
+            ring::core::exception);
+        EXPECT_TRUE(source.peer_alive(1s));
+        sink.reset();
+        EXPECT_FALSE(source.peer_alive(1s));
+        EXPECT_NO_THROW(shared_spsc_queue<PlainItem>(single_name, shm_mode::attach, shm_role::consumer));
+    }
+
+#ifdef RING_PLATFORM_LINUX
+    const std::string mpsc_name = name + "_mpsc";
+    shared_memory_region::remove(mpsc_name);
+    shared_mpsc_queue<uint64_t> sink(mpsc_name, shm_mode::create, shm_role::consumer, 128);
+    std::vector<pid_t> children;
+    for (uint64_t k = 0; k < 2; ++k)
+    {
+        pid_t pid = ::fork();
+        if (pid == 0)
+        {
+            shared_mpsc_queue<uint64_t> source(mpsc_name, shm_mode::attach, shm_role::producer);
+            for (uint64_t i = 0; i < items; ++i)
+            {
+                if (!source.push_for(k * items + i, 5s))
+                {
+                    ::_exit(1);
+                }
+            }
+            ::_exit(0);
+        }
+        children.push_back(pid);
+    }
+    uint64_t sum = 0;
+    uint64_t value = 0;
+    for (size_t i = 0; i < 2 * items; ++i)
+    {
+        ASSERT_TRUE(sink.pop_for(value, 5s));
+        sum += value;
+    }
+    EXPECT_EQ(sum, 2 * items * (2 * items - 1) / 2);
+    for (pid_t pid : children)
+    {
+        int status = 0;
+        ::waitpid(pid, &status, 0);
+        EXPECT_TRUE(WIFEXITED(status) && WEXITSTATUS(status) == 0);
+    }
+    EXPECT_FALSE(sink.peer_alive(1s));
+
+    // a producer that dies holding a claim stalls the consumer until it is skipped
+    pid_t crashed = ::fork();
+    if (crashed == 0)
+    {
+        shared_mpsc_queue<uint64_t> source(mpsc_name, shm_mode::attach, shm_role::producer);
+        source.reserve(2);
+        ::_exit(0);
+    }
+    ::waitpid(crashed, nullptr, 0);
+    {
+        shared_mpsc_queue<uint64_t> source(mpsc_name, shm_mode::attach, shm_role::producer);
+        EXPECT_TRUE(sink.peer_alive(1s));
+        EXPECT_TRUE(source.push_for(42, 1s));
+    }
+    EXPECT_FALSE(sink.pop_for(value, 1ms));
+    EXPECT_EQ(sink.recover_abandoned(1s), 2u);
+    ASSERT_TRUE(sink.pop_for(value, 1s));
+    EXPECT_EQ(value, 42u);
+    EXPECT_EQ(sink.recover_abandoned(1s), 0u);
+
+    // every producer gets its own entry
+    std::vector<std::unique_ptr<shared_mpsc_queue<uint64_t>>> sources;
+    for (size_t i = 0; i < detail::shared_queue_header::max_producers; ++i)
+    {
+        sources.push_back(std::make_unique<shared_mpsc_queue<uint64_t>>(mpsc_name, shm_mode::attach, shm_role::producer));
+    }
+    EXPECT_THROW(shared_mpsc_queue<uint64_t>(mpsc_name, shm_mode::attach, shm_role::producer), ring::core::exception);
+    sources.pop_back();
+    EXPECT_NO_THROW(shared_mpsc_queue<uint64_t>(mpsc_name, shm_mode::attach, shm_role::producer));
+#endif
+}
+
 } // namespace ring::core
 
 int main(int argc, char** argv)
@@ -1,7 +1,26 @@
 #include <gtest/gtest.h>
 
+#include <algorithm>
+#include <atomic>
+#include <csignal>
+#include <cstdio>
+#include <fstream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#ifndef RING_PLATFORM_WINDOWS
+#include <sys/stat.h>
+#include <sys/time.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
 #include "test_helpers.hpp"
 
+#include "ring/logging/deferred_log.hpp"
 #include "ring/logging/logger.hpp"
 
 namespace ring::logging
@@ -70,6 +89,478 @@ TEST_F(LoggerTest, DefaultMacroLog)
     }
 }
 
+TEST_F(LoggerTest, DeferredLog)
+{
+    std::remove("deferred_log");
+    auto logger = log_service::instance().create_logger({ .name = "deferred", .level = log_level::debug,
+        .pattern = "%l %v", .console = false, .file = "deferred_log", .async = false });
+    ASSERT_NE(logger, nullptr);
+
+    std::string owned = "owned";
+    std::string_view view = "view";
+    RING_DEFERRED_TRACE(*logger, "filtered {}", 1);
+    RING_DEFERRED_INFO(*logger, "plain");
+    RING_DEFERRED_WARN(*logger, "mixed {} {} {} {:.2f} {}", 42, "literal", owned, 2.5, view);
+    owned = "changed";
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; t++)
+    {
+        threads.emplace_back([&logger, t]()
+            {
+                for (uint32_t i = 0; i < count; i++)
+                {
+                    RING_DEFERRED_DEBUG(*logger, "thread {} item {}", t, i);
+                }
+            });
+    }
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+    log_service::instance().flush_all();
+
+    std::ifstream file("deferred_log");
+    std::stringstream content;
+    content << file.rdbuf();
+    std::string text = content.str();
+    EXPECT_EQ(text.find("filtered"), std::string::npos);
+    EXPECT_NE(text.find("info plain\n"), std::string::npos);
+    EXPECT_NE(text.find("warning mixed 42 literal owned 2.50 view\n"), std::string::npos);
+    EXPECT_NE(text.find("debug thread 3 item 9999\n"), std::string::npos);
+    EXPECT_EQ(std::count(text.begin(), text.end(), '\n'), 2 + 4 * count);
+}
+
+TEST_F(LoggerTest, DeferredThreadId)
+{
+    std::remove("deferred_tid_log");
+    auto logger = log_service::instance().create_logger({ .name = "deferred_tid", .pattern = "%t %v",
+        .console = false, .file = "deferred_tid_log", .async = false });
+
+    // %t names the thread that logged, not the backend thread that formatted
+    size_t worker = 0;
+    std::thread([&]()
+        {
+            worker = detail::log_thread_id();
+            RING_DEFERRED_INFO(*logger, "from worker");
+        }).join();
+    RING_DEFERRED_INFO(*logger, "from main");
+    log_service::instance().flush_all();
+
+    std::ifstream file("deferred_tid_log");
+    std::stringstream content;
+    content << file.rdbuf();
+    std::string text = content.str();
+    EXPECT_NE(text.find(std::to_string(worker) + " from worker\n"), std::string::npos);
+    EXPECT_NE(text.find(std::to_string(detail::log_thread_id()) + " from main\n"), std::string::npos);
+}
+
+TEST_F(LoggerTest, DeferredOversizedOrder)
+{
+    std::remove("deferred_order_log");
+    auto logger = log_service::instance().create_logger({ .name = "deferred_order", .pattern = "%v",
+        .console = false, .file = "deferred_order_log", .async = false });
+
+    // a record too large for the channel is written in place, but not ahead
+    // of what the thread queued before it
+    std::string large(detail::log_channel::default_capacity, 'x');
+    std::thread([&]()
+        {
+            for (uint32_t i = 0; i < 1000; i++)
+            {
+                RING_DEFERRED_INFO(*logger, "small {}", i);
+            }
+            RING_DEFERRED_INFO(*logger, "large {}", large);
+        }).join();
+    log_service::instance().flush_all();
+
+    std::ifstream file("deferred_order_log");
+    std::vector<std::string> lines;
+    for (std::string line; std::getline(file, line);)
+    {
+        lines.push_back(line);
+    }
+    ASSERT_EQ(lines.size(), 1001u);
+    EXPECT_EQ(lines[999], "small 999");
+    EXPECT_TRUE(lines.back().starts_with("large x"));
+}
+
+TEST_F(LoggerTest, AsyncThreadId)
+{
+    std::remove("async_tid_log");
+    auto logger = log_service::instance().create_logger({ .name = "async_tid", .pattern = "%t %v",
+        .console = false, .file = "async_tid_log" });
+
+    // %t names the thread that logged, not the writer thread
+    size_t worker = 0;
+    std::thread([&]()
+        {
+            worker = detail::log_thread_id();
+            logger->info("from worker");
+        }).join();
+    logger->info("from main");
+    logger->flush();
+
+    std::ifstream file("async_tid_log");
+    std::stringstream content;
+    content << file.rdbuf();
+    std::string text = content.str();
+    EXPECT_NE(text.find(std::to_string(worker) + " from worker\n"), std::string::npos);
+    EXPECT_NE(text.find(std::to_string(detail::log_thread_id()) + " from main\n"), std::string::npos);
+}
+
+TEST_F(LoggerTest, LogSiteToggle)
+{
+    std::remove("site_log");
+    auto logger = log_service::instance().create_logger({ .name = "site", .pattern = "%v",
+        .console = false, .file = "site_log", .async = false });
+    ASSERT_NE(logger, nullptr);
+
+    auto emit = [&logger](int value)
+        {
+            RING_DEFERRED_INFO(*logger, "first {}", value);
+            RING_DEFERRED_INFO(*logger, "second {}", value);
+        };
+    emit(1);
+
+    std::vector<log_site*> sites;
+    for (auto* site : log_sites())
+    {
+        if (site->format().starts_with("first") || site->format().starts_with("second"))
+        {
+            sites.push_back(site);
+        }
+    }
+    ASSERT_EQ(sites.size(), 2u);
+    EXPECT_EQ(sites[0]->level(), log_level::info);
+    EXPECT_TRUE(std::string_view(sites[0]->location().file_name()).ends_with("test_logger.cpp"));
+    EXPECT_EQ(sites[1]->location().line(), sites[0]->location().line() + 1);
+
+    auto* first = sites[0]->format().starts_with("first") ? sites[0] : sites[1];
+    first->set_enabled(false);
+    EXPECT_FALSE(first->enabled());
+    emit(2);
+    first->set_enabled(true);
+
+    // file rules reach registered sites and ones registered later
+    EXPECT_GE(set_log_sites_enabled("test_logger.cpp", 0, false), 2u);
+    emit(3);
+    RING_DEFERRED_INFO(*logger, "late {}", 3);
+    auto registered = log_sites();
+    auto local = std::count_if(registered.begin(), registered.end(),
+        [](log_site* site) { return std::string_view(site->location().file_name()).ends_with("test_logger.cpp"); });
+    EXPECT_EQ(set_log_sites_enabled("test_logger.cpp", 0, true), static_cast<size_t>(local));
+    emit(4);
+    log_service::instance().flush_all();
+
+    std::ifstream file("site_log");
+    std::stringstream content;
+    content << file.rdbuf();
+    EXPECT_EQ(content.str(), "first 1\nsecond 1\nsecond 2\nfirst 4\nsecond 4\n");
+}
+
+TEST_F(LoggerTest, LoggerLookup)
+{
+    auto& service = log_service::instance();
+    EXPECT_EQ(&service.default_logger(), service.get_default_logger().get());
+
+    // a view that is not null terminated must not leak its tail into the name
+    std::string buffer = "lookup_tail";
+    auto logger = service.get_logger(std::string_view(buffer).substr(0, 6));
+    ASSERT_NE(logger, nullptr);
+    EXPECT_EQ(logger->name(), "lookup");
+    EXPECT_EQ(service.get_logger("lookup"), logger);
+
+    // concurrent first lookups of one name agree on a single logger
+    std::vector<std::shared_ptr<class logger>> found(8);
+    std::vector<std::thread> threads;
+    for (size_t t = 0; t < found.size(); t++)
+    {
+        threads.emplace_back([&found, t]()
+            {
+                for (uint32_t i = 0; i < count / 10; i++)
+                {
+                    found[t] = log_service::instance().get_logger("lookup_shared");
+                }
+            });
+    }
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+    for (auto& entry : found)
+    {
+        EXPECT_EQ(entry, found.front());
+    }
+
+    // a logger created on another thread is visible here after the fact
+    std::thread([]() { log_service::instance().create_logger({ .name = "lookup_remote", .console = false }); }).join();
+    EXPECT_EQ(service.get_logger("lookup_remote")->name(), "lookup_remote");
+}
+
+TEST_F(LoggerTest, AsyncOverflow)
+{
+    auto& service = log_service::instance();
+    service.initialize({ .queue_size = 4, .drop_report_interval = std::chrono::milliseconds(0) });
+
+    auto read_lines = [](const char* path)
+        {
+            std::ifstream file(path);
+            std::vector<std::string> lines;
+            for (std::string line; std::getline(file, line);)
+            {
+                lines.push_back(line);
+            }
+            return lines;
+        };
+    auto run = [&](const char* name, overflow_policy overflow)
+        {
+            std::remove(name);
+            auto logger = service.create_logger({ .name = name, .pattern = "%v", .console = false,
+                .file = name, .overflow = overflow });
+            // a fresh thread gets a channel with the small queue_size
+            std::thread([&logger]()
+                {
+                    for (uint32_t i = 0; i < count * 2; i++)
+                    {
+                        logger->info("item {}", i);
+                    }
+                }).join();
+            logger->flush();
+            return std::make_pair(logger->drop_stats(), read_lines(name));
+        };
+
+    auto [blocked, blocked_lines] = run("overflow_block", overflow_policy::block);
+    EXPECT_EQ(blocked.dropped + blocked.overwritten, 0u);
+    ASSERT_EQ(blocked_lines.size(), count * 2);
+    EXPECT_EQ(blocked_lines.back(), "item 19999");
+
+    auto [dropped, dropped_lines] = run("overflow_drop", overflow_policy::drop_newest);
+    EXPECT_GT(dropped.dropped, 0u);
+    EXPECT_EQ(dropped.overwritten, 0u);
+    EXPECT_EQ(dropped_lines.size() + dropped.dropped, count * 2);
+    EXPECT_EQ(dropped_lines.front(), "item 0");
+
+    auto [overwritten, overwritten_lines] = run("overflow_overwrite", overflow_policy::overwrite_oldest);
+    EXPECT_GT(overwritten.overwritten, 0u);
+    EXPECT_EQ(overwritten.dropped, 0u);
+    EXPECT_EQ(overwritten_lines.size() + overwritten.overwritten, count * 2);
+    EXPECT_EQ(overwritten_lines.back(), "item 19999");
+
+    // a thread logging to both never lets the overwriting logger evict the blocking one's records
+    std::remove("overflow_mixed_block");
+    std::remove("overflow_mixed_overwrite");
+    auto mixed_block = service.create_logger({ .name = "overflow_mixed_block", .pattern = "%v",
+        .console = false, .file = "overflow_mixed_block" });
+    auto mixed_overwrite = service.create_logger({ .name = "overflow_mixed_overwrite", .pattern = "%v",
+        .console = false, .file = "overflow_mixed_overwrite", .overflow = overflow_policy::overwrite_oldest });
+    std::thread([&]()
+        {
+            for (uint32_t i = 0; i < count; i++)
+            {
+                mixed_block->info("item {}", i);
+                for (uint32_t j = 0; j < 8; j++)
+                {
+                    mixed_overwrite->info("item {}", i);
+                }
+            }
+        }).join();
+    mixed_block->flush();
+    EXPECT_EQ(mixed_block->drop_stats().overwritten, 0u);
+    EXPECT_EQ(read_lines("overflow_mixed_block").size(), count);
+
+    // losses are reported through the logger that lost them
+    service.initialize({ .drop_report_interval = std::chrono::milliseconds(1) });
+    auto reporter = service.get_logger("overflow_drop");
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    reporter->flush();
+    auto reported = read_lines("overflow_drop");
+    ASSERT_GT(reported.size(), dropped_lines.size());
+    EXPECT_TRUE(reported.back().starts_with("async log overflow: dropped " + std::to_string(dropped.dropped)));
+
+    service.initialize(log_service_config{});
+}
+
+TEST_F(LoggerTest, FlightRecorder)
+{
+    auto& service = log_service::instance();
+    auto& recorder = flight_recorder::instance();
+    recorder.enable({ .records_per_thread = 16, .level = log_level::debug, .dump_records = 24 });
+
+    // records below the logger's level still reach the recorder; those below its own don't
+    auto logger = service.create_logger({ .name = "flight", .level = log_level::warn, .console = false });
+    for (uint32_t i = 0; i < 8; i++)
+    {
+        logger->trace("skipped {}", i);
+        logger->info("main {:.1f} {{{}}}", i + 0.25, static_cast<void*>(nullptr) == nullptr);
+    }
+    // the worker can't take over main's ring while main still holds it, and wraps its own
+    std::thread([&logger]()
+        {
+            for (uint32_t i = 0; i < 32; i++)
+            {
+                logger->debug("worker {} of {:>4} {}", i, "jxk", i % 2 == 0);
+            }
+        }).join();
+
+    const char* path = "flight_dump";
+    ASSERT_EQ(service.dump_flight_recorder(path), 24u);
+    auto lines = flight_recorder::decode(path);
+    ASSERT_EQ(lines.size(), 24u);
+    // oldest first: the 8 main records, then the newest 16 of the worker's
+    EXPECT_TRUE(lines.front().ends_with("main 0.2 {true}"));
+    EXPECT_NE(lines.front().find("[info]"), std::string::npos);
+    EXPECT_TRUE(lines[7].ends_with("main 7.2 {true}"));
+    EXPECT_TRUE(lines[8].ends_with("worker 16 of  jxk true"));
+    EXPECT_NE(lines[8].find("[debug]"), std::string::npos);
+    EXPECT_TRUE(lines.back().ends_with("worker 31 of  jxk false"));
+    EXPECT_TRUE(std::none_of(lines.begin(), lines.end(), [](const std::string& line)
+        {
+            return line.find("skipped") != std::string::npos;
+        }));
+
+    // strings longer than a slot are cut and flagged
+    logger->warn("long {}", std::string(200, 'x'));
+    recorder.enable({ .records_per_thread = 16, .level = log_level::debug, .dump_records = 1 });
+    ASSERT_EQ(recorder.dump(path), 1u);
+    lines = flight_recorder::decode(path);
+    ASSERT_EQ(lines.size(), 1u);
+    EXPECT_TRUE(lines.front().ends_with(" [truncated]"));
+
+#ifndef RING_PLATFORM_WINDOWS
+    // a crashing process leaves its last records behind
+    // even when it hits during an on-demand dump, here one stuck opening a fifo
+    const char* crash_path = "flight_crash";
+    const char* busy_path = "flight_busy";
+    std::remove(crash_path);
+    std::remove(busy_path);
+    ASSERT_EQ(mkfifo(busy_path, 0600), 0);
+    pid_t child = fork();
+    if (child == 0)
+    {
+        recorder.install_crash_handler(crash_path);
+        recorder.capture(log_level::error, "about to crash at {}", 42);
+        std::signal(SIGALRM, [](int) { std::abort(); });
+        itimerval timer{ .it_interval = {}, .it_value = { .tv_sec = 0, .tv_usec = 50000 } };
+        setitimer(ITIMER_REAL, &timer, nullptr);
+        recorder.dump(busy_path);
+        ::_exit(0);
+    }
+    ASSERT_GT(child, 0);
+    int status = 0;
+    waitpid(child, &status, 0);
+    EXPECT_TRUE(WIFSIGNALED(status));
+    lines = flight_recorder::decode(crash_path);
+    ASSERT_FALSE(lines.empty());
+    EXPECT_NE(lines.back().find("[error]"), std::string::npos);
+    EXPECT_TRUE(lines.back().ends_with("] about to crash at 42"));
+    std::remove(busy_path);
+#endif
+
+    recorder.disable();
+}
+
+TEST_F(LoggerTest, MappedFileSink)
+{
+    const std::string path = "mapped_log";
+    for (const auto& name : { path, path + ".1", path + ".2", path + ".3", path + ".4" })
+    {
+        std::remove(name.c_str());
+    }
+    auto read_file = [](const std::string& name)
+        {
+            std::ifstream file(name, std::ios::binary);
+            return std::string(std::istreambuf_iterator<char>(file), {});
+        };
+
+    // preallocated segments a crashed run left behind are reclaimed on open
+    const std::string stale = path + ".pending.1000";
+    std::ofstream(stale) << "stale";
+
+    auto logger = log_service::instance().create_logger({ .name = "mapped", .pattern = "%v",
+        .max_file_size = 4096, .max_files = 3, .console = false, .file = path,
+        .file_mode = file_sink_mode::mapped, .sync_interval = std::chrono::milliseconds(0) });
+    EXPECT_FALSE(std::ifstream(stale).is_open());
+    // syncs run alongside the appends and rotations
+    std::atomic<bool> done{ false };
+    std::thread syncer([&]()
+        {
+            while (!done.load(std::memory_order_relaxed))
+            {
+                logger->flush();
+            }
+        });
+    for (uint32_t i = 0; i < 2000; i++)
+    {
+        logger->info("line {}", i);
+    }
+    done.store(true, std::memory_order_relaxed);
+    syncer.join();
+    logger->flush();
+
+    // rotated segments are trimmed to what was written; the live one keeps its preallocation
+    std::string live = read_file(path);
+    EXPECT_EQ(live.size(), 4096u);
+    live.erase(live.find_last_not_of('\0') + 1);
+    std::string content;
+    for (size_t i = 3; i > 0; i--)
+    {
+        std::string rotated = read_file(path + "." + std::to_string(i));
+        ASSERT_FALSE(rotated.empty());
+        EXPECT_LE(rotated.size(), 4096u);
+        EXPECT_EQ(rotated.find('\0'), std::string::npos);
+        // records never straddle segments
+        EXPECT_TRUE(rotated.starts_with("line ") && rotated.ends_with("\n"));
+        content += rotated;
+    }
+    EXPECT_FALSE(std::ifstream(path + ".4").is_open());
+    content += live;
+
+    // the kept files hold an unbroken tail of the records, the oldest rotated away
+    std::istringstream lines(content);
+    std::string line;
+    std::getline(lines, line);
+    uint32_t first = std::stoul(line.substr(5));
+    EXPECT_GT(first, 0u);
+    uint32_t expected = first;
+    while (std::getline(lines, line))
+    {
+        EXPECT_EQ(line, "line " + std::to_string(++expected));
+    }
+    EXPECT_EQ(expected, 1999u);
+}
+
+TEST_F(LoggerTest, ShutdownReleasesCaches)
+{
+    auto& service = log_service::instance();
+    std::weak_ptr<logger> watched = service.create_logger({ .name = "cached", .console = false });
+
+    // the worker caches a snapshot holding the logger, then sits idle
+    std::atomic<bool> cached{ false };
+    std::atomic<bool> done{ false };
+    std::thread idle([&]()
+        {
+            service.get_logger("cached");
+            cached = true;
+            while (!done)
+            {
+                std::this_thread::yield();
+            }
+        });
+    while (!cached)
+    {
+        std::this_thread::yield();
+    }
+    service.get_logger("cached");
+    service.shutdown();
+    EXPECT_TRUE(watched.expired());
+    done = true;
+    idle.join();
+
+    service.initialize();
+    EXPECT_EQ(&service.default_logger(), service.get_default_logger().get());
+}
+
 } // namespace ring::logging
 
 int main(int argc, char** argv)
@@ -0,0 +1,65 @@
+// Built with RING_ACTIVE_LOG_LEVEL raised to WARN by its target; under -Werror
+// this TU also checks that stripped statements leave no unused variables or
+// parameters behind.
+#include <gtest/gtest.h>
+
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <string>
+
+#include "ring/logging/deferred_log.hpp"
+#include "ring/logging/logger.hpp"
+
+static_assert(RING_ACTIVE_LOG_LEVEL == RING_LOG_LEVEL_WARN, "test_stripped_log expects its own active level");
+
+namespace ring::logging
+{
+
+namespace
+{
+
+int evaluations = 0;
+
+int touch()
+{
+    return ++evaluations;
+}
+
+void log_below_threshold(logger& target, int only_logged)
+{
+    int local = only_logged * 2;
+    std::string label = "label";
+    RING_TRACE("trace {} {}", local, touch());
+    RING_DEBUG("debug {}", label);
+    RING_INFO("info {} {}", only_logged, touch());
+    RING_DEFERRED_DEBUG(target, "deferred {} {}", local, touch());
+    RING_DEFERRED_INFO(target, "deferred {}", label);
+}
+
+} // namespace
+
+TEST(StrippedLogTest, RaisedActiveLevel)
+{
+    std::remove("stripped_log");
+    auto target = log_service::instance().create_logger({ .name = "stripped", .level = log_level::trace,
+        .pattern = "%l %v", .console = false, .file = "stripped_log", .async = false });
+
+    log_below_threshold(*target, 21);
+    RING_DEFERRED_WARN(*target, "kept {}", 1);
+    log_service::instance().flush_all();
+    EXPECT_EQ(evaluations, 0);
+
+    std::ifstream file("stripped_log");
+    std::stringstream content;
+    content << file.rdbuf();
+    EXPECT_EQ(content.str(), "warning kept 1\n");
+}
+
+} // namespace ring::logging
+
+int main(int argc, char** argv)
+{
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}